@@ -22,310 +22,328 @@
 
 #include "../utils/geometries.h"
 
+extern settings setting;
+
 /**
- * @brief function generates geometries recursivly so that the two input points are connected with a feasible geometry
+ * @brief summary of one closure
  * 
- * @param geo   vector which contains all output geometries
+ */
+struct closeRoadReport
+{
+    int geometries = 0;             // number of primitives of the closure
+    int steps = 0;                  // number of solver steps
+    bool biarc = false;             // the closure ends with a biarc
+    bool budgetExceeded = false;    // the helping geometries exceeded the budget and were replaced by a biarc
+};
+
+/**
+ * @brief function classifies a line parameter with a tolerance
+ * 
+ * @param t     line parameter
+ * @param tol   tolerance
+ * @return int  p if t is positive, n if t is negative, o if t is zero
+ */
+int closeRoadSign(double t, double tol)
+{
+    if (t > tol)
+        return p;
+    if (t < -tol)
+        return n;
+    return o;
+}
+
+/**
+ * @brief function computes the intersection point of the lines through two points in vector form, iP = P1 + t1 * dir1 = P2 + t2 * dir2
+ * 
+ * @param x1        x position of first point
+ * @param y1        y position of first point
+ * @param phi1      angle of first point
+ * @param x2        x position of second point
+ * @param y2        y position of second point
+ * @param phi2      angle of second point
+ * @param tol       tolerance for parallel lines and zero line parameters
+ * @param type1     type of first point (p,n,0)
+ * @param type2     type of second point (p,n,0)
+ * @param iPx       x position of intersection point
+ * @param iPy       y position of intersection point
+ * @return int      1 if the lines are parallel, 0 otherwise
+ */
+int closeRoadIP(double x1, double y1, double phi1, double x2, double y2, double phi2, double tol, int &type1, int &type2, double &iPx, double &iPy)
+{
+    double c1 = cos(phi1), s1 = sin(phi1);
+    double c2 = cos(phi2), s2 = sin(phi2);
+
+    double cross = c1 * s2 - s1 * c2;
+    if (abs(cross) < tol)
+        return 1;
+
+    double vx = x2 - x1;
+    double vy = y2 - y1;
+    double t1 = (vx * s2 - vy * c2) / cross;
+    double t2 = (vx * s1 - vy * c1) / cross;
+
+    type1 = closeRoadSign(t1, tol);
+    type2 = closeRoadSign(t2, tol);
+
+    iPx = x1 + t1 * c1;
+    iPy = y1 + t1 * s1;
+
+    return 0;
+}
+
+/**
+ * @brief function adds an arc, or a line if the angle does not change
+ * 
+ * @param geo   vector of all geometries
  * @param x1    x component of start point
  * @param y1    y component of start point
  * @param phi1  angle of start point
  * @param x2    x component of end point
  * @param y2    y component of end point
  * @param phi2  angle of end point
+ * @param tol   angle tolerance
  * @return int  error code
  */
-int closeRoadConnection(vector<geometry> &geo, double x1, double y1, double phi1, double x2, double y2, double phi2)
+int addArcOrLine(referenceLine &geo, double x1, double y1, double phi1, double x2, double y2, double phi2, double tol)
 {
-    // goal: compute new road from point 1 to point 2, preserving angles
+    double a = phi2 - phi1;
+    fixAngle(a);
 
-    // compute m and b of points for line equations
-    double m1 = tan(phi1);
-    double b1 = y1 - m1 * x1;
+    if (abs(a) < tol)
+        return addLine(geo, x1, y1, phi1, x2, y2, phi2);
+    return addArc(geo, x1, y1, phi1, x2, y2, phi2);
+}
 
-    double m2 = tan(phi2);
-    double b2 = y2 - m2 * x2;
-
-    // type is general type (p = parallel, i=identical, 0=no intersection)
-    // type1 / type2 defines how point1 / point2 lie to the intersetion point
-    int type1, type2, type = 0;
-
-    double d1, d2, d; //d1 distance p1 - ip, d2 distance p2 - ip, d distance p1 - p2
-    double iPx, iPy; //intersection point
+/**
+ * @brief function connects two points by two arcs with tangents of equal length (biarc)
+ *      if the end point lies behind the start point with the same angle, a quarter circle is added first
+ * 
+ * @param geo   vector which contains all output geometries
+ * @param x1    x component of start point
+ * @param y1    y component of start point
+ * @param phi1  angle of start point
+ * @param x2    x component of end point
+ * @param y2    y component of end point
+ * @param phi2  angle of end point
+ * @param tol   tolerance
+ * @return int  error code
+ */
+int closeRoadBiarc(referenceLine &geo, double x1, double y1, double phi1, double x2, double y2, double phi2, double tol)
+{
+    double c1 = cos(phi1), s1 = sin(phi1);
+    double c2 = cos(phi2), s2 = sin(phi2);
 
-    // determine type and compute intersection point if it exists
-    if (m1 == m2)
-    {
-        if (b1 != b2)
-            type = p;
-        if (b1 == b2)
-            type = i;
-    }
-    else
+    double vx = x2 - x1;
+    double vy = y2 - y1;
+    double vv = vx * vx + vy * vy;
+    if (vv < tol * tol)
     {
-        // compute intersection point and determine type
-        computeIP(x1, y1, phi1, x2, y2, phi2, type, type1, type2, iPx, iPy);
-
-        d1 = sqrt(pow(x1 - iPx, 2) + pow(y1 - iPy, 2));
-        d2 = sqrt(pow(x2 - iPx, 2) + pow(y2 - iPy, 2));
-        d = sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
+        cerr << "ERR: start and end point of the closure are identical." << endl;
+        return 1;
     }
 
-    // --- case i -------------------------------------------------------------
-    if (type == i)
+    // tangent length h solves |v - h * (dir1 + dir2)| = 2h
+    double vt = vx * (c1 + c2) + vy * (s1 + s2);
+    double a = 2 * (c1 * c2 + s1 * s2 - 1);
+    double h;
+    if (abs(a) < tol)
     {
-        double beta = phi1 - phi2;
-        fixAngle(beta);
-
-        // case: -> <-    or  <-  ->
-        if (beta == M_PI)
+        if (vt <= 0)
         {
-            // create helping point at Tmp position
-            double xTmp = x1 + cos(phi1 + M_PI / 4) * d / 4;
-            double yTmp = y1 + sin(phi1 + M_PI / 4) * d / 4;
-            double phiTmp = phi1 + M_PI / 2;
+            // parallel tangents and the end point lies behind: turn towards it by 90 degree first
+            double side = (c1 * vy - s1 * vx >= 0) ? 1 : -1;
+            double r = sqrt(vv) / 4;
+            double xTmp = x1 + r * c1 - side * r * s1;
+            double yTmp = y1 + r * s1 + side * r * c1;
+            double phiTmp = phi1 + side * M_PI / 2;
             if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phiTmp))
             {
                 cerr << "ERR: error in addArc function." << endl;
                 return 1;
             }
-            if (closeRoadConnection(geo, xTmp, yTmp, phiTmp, x2, y2, phi2))
-            {
-                cerr << "ERR: error in closeRoadConnection function." << endl;
-                return 1;
-            }
+            return closeRoadBiarc(geo, xTmp, yTmp, phiTmp, x2, y2, phi2, tol);
         }
+        h = vv / (2 * vt);
+    }
+    else
+        h = (vt - sqrt(vt * vt - a * vv)) / a;
 
-        // case: ->  ->
-        if (beta == 0)
-        {
-            // rotate start point around 90 degree and test IP again
-            int t, t1, t2;
-            computeIP(x1, y1, phi1 + M_PI / 2, x2, y2, phi2, t, t1, t2, iPx, iPy);
+    // joint point in the middle of both tangent points
+    double q1x = x1 + h * c1, q1y = y1 + h * s1;
+    double q2x = x2 - h * c2, q2y = y2 - h * s2;
+    double xJ = (q1x + q2x) / 2;
+    double yJ = (q1y + q2y) / 2;
+    double phiJ = atan2(q2y - q1y, q2x - q1x);
 
-            // if end points to start
-            if (t2 == p)
-            {
-                // create helping point at Tmp position
-                double xTmp = x1 + cos(phi1 + M_PI / 4) * d / 4;
-                double yTmp = y1 + sin(phi1 + M_PI / 4) * d / 4;
-                double phiTmp = phi1 + M_PI / 2;
-                if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phiTmp))
-                {
-                    cerr << "ERR: error in addArc function." << std::endl;
-                    return 1;
-                }
-                if (closeRoadConnection(geo, xTmp, yTmp, phiTmp, x2, y2, phi2))
-                {
-                    cerr << "ERR: error in closeRoadConnection function." << endl;
-                    return 1;
-                }
-            }
-            // if start points to end
-            if (t2 == n)
-            {
-                addLine(geo, x1, y1, phi1, x2, y2, phi2);
-            }
-        }
+    if (addArcOrLine(geo, x1, y1, phi1, xJ, yJ, phiJ, tol) || addArcOrLine(geo, xJ, yJ, phiJ, x2, y2, phi2, tol))
+    {
+        cerr << "ERR: error in addArc function." << endl;
+        return 1;
     }
+    return 0;
+}
+
+/**
+ * @brief function performs one step of the closure. Either the end point is reached, or a helping geometry is added
+ *      and the start point is moved to its end.
+ * 
+ * @param geo   vector which contains all output geometries
+ * @param x1    x component of start point, updated to the helping point
+ * @param y1    y component of start point, updated to the helping point
+ * @param phi1  angle of start point, updated to the helping point
+ * @param x2    x component of end point
+ * @param y2    y component of end point
+ * @param phi2  angle of end point
+ * @param tol   tolerance for the case selection
+ * @return int  0: end point reached, 1: error, 2: next step necessary, 3: the remaining gap has to be closed by a biarc
+ */
+int closeRoadStep(referenceLine &geo, double &x1, double &y1, double &phi1, double x2, double y2, double phi2, double tol)
+{
+    // type1 / type2 defines how point1 / point2 lie to the intersetion point
+    int type1 = o, type2 = o;
+    double iPx, iPy; //intersection point
+
+    double d = sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2)); // distance p1 - p2
 
-    // --- case p -------------------------------------------------------------
-    if (type == p)
+    // helping point at Tmp position
+    double xTmp, yTmp, phiTmp;
+
+    // --- case parallel -------------------------------------------------------
+    // parallel lines are only connected directly if the end point lies ahead on the same line,
+    // all other parallel cases are closed by a biarc
+    if (closeRoadIP(x1, y1, phi1, x2, y2, phi2, tol, type1, type2, iPx, iPy))
     {
         double beta = phi1 - phi2;
         fixAngle(beta);
+        double dLine = cos(phi1) * (y2 - y1) - sin(phi1) * (x2 - x1);
+        double dAhead = cos(phi1) * (x2 - x1) + sin(phi1) * (y2 - y1);
 
-        // case: -> <-    or  <-  ->
-        if (beta == M_PI)
-        {
-            // rotate start point around 90 degree and test IP again
-            int t, t1, t2;
-            computeIP(x1, y1, phi1 + M_PI / 2, x2, y2, phi2, t, t1, t2, iPx, iPy);
-
-            if ((t1 == p && t2 == o) ||
-                (t1 == p && t2 == n) ||
-                (t1 == n && t2 == p) ||
-                (t1 == n && t2 == o))
-            {
-                double h = sqrt(pow(x1 - iPx, 2) + pow(y1 - iPy, 2));
-                double xTmp = x1 + cos(phi1 + M_PI / 4) * h / 4;
-                double yTmp = y1 + sin(phi1 + M_PI / 4) * h / 4;
-                double phiTmp = phi1 + M_PI / 2;
-                if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phiTmp))
-                {
-                    cerr << "ERR: error in addArc function." << endl;
-                    return 1;
-                }
-                if (closeRoadConnection(geo, xTmp, yTmp, phiTmp, x2, y2, phi2))
-                {
-                    cerr << "ERR: error in closeRoadConnection function." << endl;
-                    return 1;
-                }
-            }
-            if ((t1 == p && t2 == p) || (t1 == n && t2 == n))
-            {
-                int t, t1, t2;
-                computeIP(x1, y1, phi1, x2, y2, phi2 + M_PI / 2, t, t1, t2, iPx, iPy);
-
-                addLine(geo, x1, y1, phi1, iPx, iPy, phi1);
-                if (closeRoadConnection(geo, iPx, iPy, phi1, x2, y2, phi2))
-                {
-                    cerr << "ERR: error in closeRoadConnection function." << endl;
-                    return 1;
-                }
-            }
-        }
-
-        // case: ->  ->
-        if (beta == 0)
-        {
-            // rotate start point around 90 degree and test IP again
-            int t, t1, t2;
-            computeIP(x1, y1, phi1 + M_PI / 2, x2, y2, phi2, t, t1, t2, iPx, iPy);
-
-            if (t1 == p)
-            {
-                double h = sqrt(pow(x1 - iPx, 2) + pow(y1 - iPy, 2));
-                double xTmp = x1 + cos(phi1 + M_PI / 4) * h / 4;
-                double yTmp = y1 + sin(phi1 + M_PI / 4) * h / 4;
-                double phiTmp = phi1 + M_PI / 2;
-                if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phiTmp))
-                {
-                    cerr << "ERR: error in addArc function." << endl;
-                    return 1;
-                }
-                if (closeRoadConnection(geo, xTmp, yTmp, phiTmp, x2, y2, phi2))
-                {
-                    cerr << "ERR: error in closeRoadConnection function." << endl;
-                    return 1;
-                }
-            }
-            if (t1 == n)
-            {
-                double h = sqrt(pow(x1 - iPx, 2) + pow(y1 - iPy, 2));
-                double xTmp = x1 + cos(phi1 - M_PI / 4) * h / 4;
-                double yTmp = y1 + sin(phi1 - M_PI / 4) * h / 4;
-                double phiTmp = phi1 - M_PI / 2;
-                if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phiTmp))
-                {
-                    cerr << "ERR: error in addArc function." << endl;
-                    return 1;
-                }
-                if (closeRoadConnection(geo, xTmp, yTmp, phiTmp, x2, y2, phi2))
-                {
-                    cerr << "ERR: error in closeRoadConnection function." << endl;
-                    return 1;
-                }
-            }
-        }
+        if (abs(dLine) < tol && cos(beta) > 0 && dAhead > tol)
+            return addLine(geo, x1, y1, phi1, x2, y2, phi2);
+        return 3;
     }
+
     // --- case pn -------------------------------------------------------------
     if (type1 == p && type2 == n)
     {
         // in this case the two point can be connected instantly
+        double d1 = sqrt(pow(x1 - iPx, 2) + pow(y1 - iPy, 2));
+        double d2 = sqrt(pow(x2 - iPx, 2) + pow(y2 - iPy, 2));
+
+        if (abs(d1 - d2) < tol)
+            return addArc(geo, x1, y1, phi1, x2, y2, phi2);
+
         if (d1 > d2)
         {
-            double xTmp = x1 + cos(phi1) * (d1 - d2);
-            double yTmp = y1 + sin(phi1) * (d1 - d2);
+            xTmp = x1 + cos(phi1) * (d1 - d2);
+            yTmp = y1 + sin(phi1) * (d1 - d2);
             addLine(geo, x1, y1, phi1, xTmp, yTmp, phi1);
-            if (addArc(geo, xTmp, yTmp, phi1, x2, y2, phi2))
-            {
-                cerr << "ERR: error in addArc function." << endl;
-                return 1;
-            }
-        }
-
-        if (d1 < d2)
-        {
-            double xTmp = x2 - cos(phi2) * (d2 - d1);
-            double yTmp = y2 - sin(phi2) * (d2 - d1);
-            if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phi2))
-            {
-                cerr << "ERR: error in addArc function." << endl;
-                return 1;
-            }
-            if (addLine(geo, xTmp, yTmp, phi2, x2, y2, phi2))
-            {
-                cerr << "ERR: error in addLine function." << endl;
-                return 1;
-            }
+            return addArc(geo, xTmp, yTmp, phi1, x2, y2, phi2);
         }
 
-        if (d1 == d2)
-        {
-            if (addArc(geo, x1, y1, phi1, x2, y2, phi2))
-            {
-                cerr << "ERR: error in addArc function." << endl;
-                return 1;
-            }
-        }
+        xTmp = x2 - cos(phi2) * (d2 - d1);
+        yTmp = y2 - sin(phi2) * (d2 - d1);
+        addArc(geo, x1, y1, phi1, xTmp, yTmp, phi2);
+        return addLine(geo, xTmp, yTmp, phi2, x2, y2, phi2);
     }
+
     // --- case oo -------------------------------------------------------------
-    if (type1 == o && type2 == o)
+    else if (type1 == o && type2 == o)
     {
         // almost nothing to be done
-        if (addLine(geo, x1, y1, phi1, x2, y2, phi2))
-        {
-            cerr << "ERR: error in addLine function." << endl;
-            return 1;
-        }
+        return addLine(geo, x1, y1, phi1, x2, y2, phi2);
+    }
+
+    // --- p0 && n0 ------------------------------------------------------------
+    else if (type2 == o)
+    {
+        double beta = phi1 - phi2;
+        fixAngle(beta);
+        double alpha = (beta > 0) ? -M_PI / 4 : M_PI / 4;
+        xTmp = x1 + cos(phi1 + alpha) * d / 4;
+        yTmp = y1 + sin(phi1 + alpha) * d / 4;
+        phiTmp = phi1 + 2 * alpha;
     }
 
     // --- case np pp nn 0p 0n -------------------------------------------------
-    if ((type1 == n && type2 == p) ||
-        (type1 == p && type2 == p) ||
-        (type1 == n && type2 == n) ||
-        (type1 == 0 && type2 == n) ||
-        (type1 == 0 && type2 == p))
+    else
     {
         double alpha = atan2(y2 - y1, x2 - x1) - phi1;
         fixAngle(alpha);
-        if (alpha > 0)
-            alpha = M_PI / 4;
-        if (alpha < 0)
-            alpha = -M_PI / 4;
-
-        // create helping point at Tmp position
-        double xTmp = x1 + cos(phi1 + alpha) * d / 4;
-        double yTmp = y1 + sin(phi1 + alpha) * d / 4;
-        double phiTmp = phi1 + 2 * alpha;
-        if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phiTmp))
-        {
-            cerr << "ERR: error in addArc function." << endl;
-            return 1;
-        }
-        if (closeRoadConnection(geo, xTmp, yTmp, phiTmp, x2, y2, phi2))
-        {
-            cerr << "ERR: error in closeRoadConnection function." << endl;
-            return 1;
-        }
+        alpha = (alpha < 0) ? -M_PI / 4 : M_PI / 4;
+
+        xTmp = x1 + cos(phi1 + alpha) * d / 4;
+        yTmp = y1 + sin(phi1 + alpha) * d / 4;
+        phiTmp = phi1 + 2 * alpha;
     }
 
-    // --- p0 && n0 ------------------------------------------------------------
-    if ((type1 == p && type2 == o) ||
-        (type1 == n && type2 == o))
+    if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phiTmp))
     {
-        double beta = phi1 - phi2;
-        fixAngle(beta);
-        if (beta > 0)
-            beta = -M_PI / 4;
-        if (beta < 0)
-            beta = M_PI / 4;
-
-        // create helping point at Tmp position
-        double xTmp = x1 + cos(phi1 + beta) * d / 4;
-        double yTmp = y1 + sin(phi1 + beta) * d / 4;
-        double phiTmp = phi1 + 2 * beta;
-        if (addArc(geo, x1, y1, phi1, xTmp, yTmp, phiTmp))
+        cerr << "ERR: error in addArc function." << endl;
+        return 1;
+    }
+    x1 = xTmp;
+    y1 = yTmp;
+    phi1 = phiTmp;
+    return 2;
+}
+
+/**
+ * @brief function generates geometries iteratively so that the two input points are connected with a feasible geometry.
+ *      Each step either reaches the end point or adds a helping geometry. Parallel cases are closed by a biarc.
+ *      If the geometry budget is exceeded, the helping geometries are discarded and both points are connected by a biarc.
+ * 
+ * @param geo       vector which contains all output geometries
+ * @param x1        x component of start point
+ * @param y1        y component of start point
+ * @param phi1      angle of start point
+ * @param x2        x component of end point
+ * @param y2        y component of end point
+ * @param phi2      angle of end point
+ * @param report    number of generated primitives and solver steps
+ * @return int      error code
+ */
+int closeRoadConnection(referenceLine &geo, double x1, double y1, double phi1, double x2, double y2, double phi2, closeRoadReport &report)
+{
+    // goal: compute new road from point 1 to point 2, preserving angles
+    report = closeRoadReport();
+    int first = geo.size();
+    double tol = setting.closeRoadTolerance;
+
+    double x = x1, y = y1, phi = phi1;
+    int res = 2;
+    while (res == 2)
+    {
+        if ((int)geo.size() - first >= setting.closeRoadMaxGeometries)
         {
-            cerr << "ERR: error in addArc function." << endl;
-            return 1;
+            geo.truncate(first);
+            x = x1;
+            y = y1;
+            phi = phi1;
+            report.budgetExceeded = true;
+            res = 3;
+            break;
         }
-        if (closeRoadConnection(geo, xTmp, yTmp, phiTmp, x2, y2, phi2))
+        res = closeRoadStep(geo, x, y, phi, x2, y2, phi2, tol);
+        report.steps++;
+    }
+
+    if (res == 1)
+    {
+        cerr << "ERR: error in closeRoadStep function." << endl;
+        return 1;
+    }
+
+    if (res == 3)
+    {
+        report.biarc = true;
+        if (closeRoadBiarc(geo, x, y, phi, x2, y2, phi2, tol))
         {
-            cerr << "ERR: error in closeRoadConnection function." << endl;
+            cerr << "ERR: error in closeRoadBiarc function." << endl;
             return 1;
         }
     }
 
+    report.geometries = geo.size() - first;
     return 0;
-}
\ No newline at end of file
+}
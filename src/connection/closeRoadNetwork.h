@@ -19,6 +19,294 @@
 
 extern settings setting;
 
+/**
+ * @brief closing road of one segmentLink. The end points are resolved first, then all geometries are solved
+ *      independently and finally the roads are linked in input order.
+ * 
+ */
+struct closeRoadTask
+{
+	int id = -1; // id of the closing road
+
+	// adjacent roads in data.roads; every matching road is linked, the last one defines the position
+	vector<int> fromRoads;
+	vector<int> toRoads;
+	string fromPos;
+	string toPos;
+
+	double fromX, fromY, fromHdg;
+	double toX, toY, toHdg;
+
+	referenceLine geometries;
+	closeRoadReport report;
+	int error = 0;
+};
+
+/**
+ * @brief function resolves the roads at one end of a closing road with the (segment, input id) index.
+ *      Like the former scan over all roads, the id which has to match is replaced by the output id of each matching road.
+ * 
+ * @param index 		road indices for each pair of segment and input id in ascending order
+ * @param roads 		all roads
+ * @param segment 		segment of the road
+ * @param roadId 		input id of the road
+ * @param checkPos 		if true, the roads have to match the position (segment is a junction)
+ * @param junctionEnd 	if true, the position is set to "end" after the first match
+ * @param pos 			position of the end point at the road
+ * @param matches 		indices of all matching roads
+ * @return int 			error code, 1 if the position is neither "start" nor "end"
+ */
+int resolveCloseRoadEnd(const map<pair<int, int>, vector<int>> &index, const arenaVector<road> &roads, int segment, int roadId,
+						bool checkPos, bool junctionEnd, string &pos, vector<int> &matches)
+{
+	int last = -1;
+	while (true)
+	{
+		map<pair<int, int>, vector<int>>::const_iterator it = index.find(make_pair(segment, roadId));
+		if (it == index.end())
+			break;
+
+		int next = -1;
+		for (int k : it->second)
+		{
+			if (k <= last || (checkPos && roads[k].inputPos != pos))
+				continue;
+			next = k;
+			break;
+		}
+		if (next == -1)
+			break;
+
+		matches.push_back(next);
+		last = next;
+		roadId = roads[next].id;
+
+		// if junction, the contact point is always at "end" of a road
+		if (junctionEnd)
+			pos = "end";
+
+		if (pos != "start" && pos != "end")
+			return 1;
+	}
+	return 0;
+}
+
+/**
+ * @brief function computes the pose at the start or end of a road
+ * 
+ * @param r 	road
+ * @param pos 	"start" or "end"
+ * @param x 	x position
+ * @param y 	y position
+ * @param hdg 	angle
+ * @return int 	error code
+ */
+int closeRoadPose(const road &r, const string &pos, double &x, double &y, double &hdg)
+{
+	if (pos == "start")
+	{
+		x = r.geometries.front().x;
+		y = r.geometries.front().y;
+		hdg = r.geometries.front().hdg;
+	}
+	else
+	{
+		geometry g = r.geometries.back();
+		x = g.x;
+		y = g.y;
+		hdg = g.hdg;
+		curve(g.length, g, x, y, hdg, 1);
+	}
+	return 0;
+}
+
+/**
+ * @brief function adds the closing road to the road network and links it with the adjacent roads
+ * 
+ * @param t 	solved closing road
+ * @param data 	roadNetwork structure generated by this tool
+ * @param ids 	index of the first road with each id
+ * @return int 	error code
+ */
+int commitCloseRoad(closeRoadTask &t, roadNetwork &data, const map<int, int> &ids)
+{
+	road rConnection;
+	rConnection.id = t.id;
+
+	string fromPos = t.fromPos;
+	string toPos = t.toPos;
+	int fromRoadId = -1;
+	int toRoadId = -1;
+	laneSection lS1, lS2;
+
+	for (int k : t.fromRoads)
+	{
+		road &r = data.roads[k];
+		fromRoadId = r.id;
+		if (fromPos == "start")
+		{
+			r.predecessor.id = rConnection.id;
+			r.predecessor.contactPoint = startType;
+			rConnection.predecessor.id = fromRoadId;
+			rConnection.predecessor.contactPoint = startType;
+			lS1 = r.laneSections.front();
+		}
+		else
+		{
+			r.successor.id = rConnection.id;
+			r.successor.contactPoint = startType;
+			rConnection.predecessor.id = fromRoadId;
+			rConnection.predecessor.contactPoint = endType;
+			lS1 = r.laneSections.back();
+		}
+	}
+
+	for (int k : t.toRoads)
+	{
+		road &r = data.roads[k];
+		toRoadId = r.id;
+		if (toPos == "start")
+		{
+			r.predecessor.id = rConnection.id;
+			r.predecessor.contactPoint = endType;
+			rConnection.successor.id = r.id;
+			rConnection.successor.contactPoint = startType;
+			lS2 = r.laneSections.front();
+		}
+		else
+		{
+			r.successor.id = rConnection.id;
+			r.successor.contactPoint = endType;
+			rConnection.successor.id = r.id;
+			rConnection.successor.contactPoint = endType;
+			lS2 = r.laneSections.back();
+		}
+	}
+
+	if(!setting.suppressOutput)
+		cout << "\tClosed road " << rConnection.id << " with " << t.report.geometries << " geometries in " << t.report.steps << " steps" << endl;
+	if (t.report.budgetExceeded)
+		throwWarning("closure of road " + to_string(rConnection.id) + " did not converge within " + to_string(setting.closeRoadMaxGeometries) + " geometries.\n\t -> connected by two arcs", true);
+
+	rConnection.geometries = std::move(t.geometries);
+
+	// --- compute length --------------------------------------------------
+	for (int j = 0; j < (int)rConnection.geometries.size(); j++)
+	{
+		rConnection.length += rConnection.geometries[j].length;
+	}
+
+	// --- add lanes -------------------------------------------------------
+	arenaVector<laneSection> secs;
+
+	// flip lanes if in false direction
+	if (fromPos == "start")
+		lS1.lanes.flipIds();
+
+	if (toPos == "end")
+		lS2.lanes.flipIds();
+
+	lS1.s = 0;
+	secs.push_back(lS1);
+
+	double dPos = abs(findMaxLaneId(lS2)) - abs(findMaxLaneId(lS1));
+	double dNeg = abs(findMinLaneId(lS2)) - abs(findMinLaneId(lS1));
+
+	double ds = setting.laneChange.ds;
+	double s = 0;
+	// add widenings if necessary
+	while (dPos > 0)
+	{
+		addLaneWidening(secs, findMaxLaneId(lS1), s, ds, false);
+		s += ds;
+		dPos--;
+	}
+	while (dNeg > 0)
+	{
+		addLaneWidening(secs, findMinLaneId(lS1), s, ds, false);
+		s += ds;
+		dNeg--;
+	}
+	while (dPos < 0)
+	{
+		addLaneDrop(secs, findMaxLaneId(lS1), s, ds);
+		s += ds;
+		dPos++;
+	}
+	while (dNeg < 0)
+	{
+		addLaneDrop(secs, findMinLaneId(lS1), s, ds);
+		s += ds;
+		dNeg++;
+	}
+
+	// --- adjust lanewidth of last section to be equal to lS2 -------------
+	for (int j = 0; j < secs.back().lanes.size(); j++)
+	{
+		lane curLane = secs.back().lanes[j];
+		int id = curLane.id;
+
+		lane refLane;
+		findLane(lS2, refLane, id);
+
+		double w1 = curLane.w.a;
+		double w2 = refLane.w.a;
+		if (w1 == w2)
+			continue;
+
+		double length = rConnection.length - s;
+
+		curLane.w.d = -2 * (w2 - w1) / pow(length, 3);
+		curLane.w.c = 3 * (w2 - w1) / pow(length, 2);
+		curLane.w.b = 0;
+		curLane.w.a = w1;
+
+		secs.back().lanes[j] = curLane;
+	}
+
+	int fr = ids.at(fromRoadId);
+	int tr = ids.at(toRoadId);
+
+	// --- add lane links --------------------------------------------------
+	// lanes of the adjacent roads are found by their (unflipped) id in the section at the contact point
+	laneSection &adjacentFrom = (fromPos == "start") ? data.roads[fr].laneSections.front() : data.roads[fr].laneSections.back();
+	for (int j = 0; j < secs.front().lanes.size(); j++)
+	{
+		int id = secs.front().lanes[j].id;
+		int adjacentId = (fromPos == "start") ? -id : id;
+		secs.front().lanes[j].preId = adjacentId;
+
+		lane *adjacent = adjacentFrom.lanes.get(adjacentId);
+		if (adjacent == NULL)
+			continue;
+		if (fromPos == "start")
+			adjacent->preId = id;
+		else
+			adjacent->sucId = id;
+	}
+
+	laneSection &adjacentTo = (toPos == "start") ? data.roads[tr].laneSections.front() : data.roads[tr].laneSections.back();
+	for (int j = 0; j < secs.back().lanes.size(); j++)
+	{
+		int id = secs.back().lanes[j].id;
+		int adjacentId = (toPos == "end") ? -id : id;
+		secs.back().lanes[j].sucId = adjacentId;
+
+		lane *adjacent = adjacentTo.lanes.get(adjacentId);
+		if (adjacent == NULL)
+			continue;
+		if (toPos == "start")
+			adjacent->preId = id;
+		else
+			adjacent->sucId = id;
+	}
+
+	rConnection.laneSections = secs;
+
+	data.roads.push_back(rConnection);
+	return 0;
+}
+
 /**
  * @brief function closes roads by adding new road structures
  * 
@@ -42,279 +330,101 @@ int closeRoadNetwork(const DOMElement* rootNode, roadNetwork &data)
 
 	// assumption is that all segments are already linked
 
+	// --- index the roads and junctions ---------------------------------------
+	map<pair<int, int>, vector<int>> index;
+	map<int, int> ids;
+	for (int k = 0; k < (int)data.roads.size(); k++)
+	{
+		const road &r = data.roads[k];
+		index[make_pair(r.junction, r.inputId)].push_back(k);
+		ids.insert(make_pair(r.id, k));
+	}
+
+	unordered_set<int> junctionIds;
+	for (auto &&j : data.junctions)
+		junctionIds.insert(j.id);
+
+	// --- resolve end points --------------------------------------------------
+	vector<closeRoadTask> tasks;
 	for (DOMElement *segmentLink = closeRoad->getFirstElementChild();segmentLink != NULL; segmentLink = segmentLink->getNextElementSibling())
 	{
 		if(readNameFromNode(segmentLink) != "segmentLink") continue;
 
-		road rConnection;
+		closeRoadTask t;
 		data.nSegment++;
-		rConnection.id = data.nSegment * 100 + 1;
-
+		t.id = data.ids.allocate(-1, data.nSegment * 100 + 1);
 
 		int fromSegment = readIntAttrFromNode(segmentLink, "fromSegment");
 		int toSegment = readIntAttrFromNode(segmentLink, "toSegment");
 		int fromRoadId = readIntAttrFromNode(segmentLink, "fromRoad");
 		int toRoadId = readIntAttrFromNode(segmentLink, "toRoad");
-		string fromPos = readStrAttrFromNode(segmentLink, "fromPos");
-		string toPos = readStrAttrFromNode(segmentLink, "toPos");
-		road fromRoad;
-		road toRoad;
-
+		t.fromPos = readStrAttrFromNode(segmentLink, "fromPos");
+		t.toPos = readStrAttrFromNode(segmentLink, "toPos");
 
-
-		double fromX, fromY, fromHdg;
-		double toX, toY, toHdg;
-		laneSection lS1, lS2;
-		bool found;
-
-		// check if fromSegment is junction
-		bool fromIsJunction = false;
-		for (auto &&j : data.junctions)
-			if (j.id == fromSegment)
-				fromIsJunction = true;
-
-		// check if toSegment is junction
-		bool toIsJunction = false;
-		for (auto &&j : data.junctions)
-			if (j.id == toSegment)
-				toIsJunction = true;
+		bool fromIsJunction = junctionIds.count(fromSegment) > 0;
+		bool toIsJunction = junctionIds.count(toSegment) > 0;
 
 		// save from position
-		found = false;
-		for (auto &&r : data.roads)
+		if (resolveCloseRoadEnd(index, data.roads, fromSegment, fromRoadId, fromIsJunction, fromIsJunction, t.fromPos, t.fromRoads))
 		{
-			if (r.junction != fromSegment || r.inputId != fromRoadId)
-				continue;
-			if (fromIsJunction && r.inputPos != fromPos)
-				continue;
-
-			fromRoad = r;
-			fromRoadId = r.id;
-			found = true;
-
-			// if junction, the contact point is always at "end" of a road
-			if (fromIsJunction)
-				fromPos = "end";
-
-			if (fromPos == "start")
-			{
-				fromX = r.geometries.front().x;
-				fromY = r.geometries.front().y;
-				fromHdg = r.geometries.front().hdg;
-				r.predecessor.id = rConnection.id;
-				r.predecessor.contactPoint = startType;
-				rConnection.predecessor.id = fromRoadId;
-				rConnection.predecessor.contactPoint = startType;
-				lS1 = r.laneSections.front();
-			}
-			else if (fromPos == "end")
-			{
-				geometry g = r.geometries.back();
-				curve(g.length, g, g.x, g.y, g.hdg, 1);
-				fromX = g.x;
-				fromY = g.y;
-				fromHdg = g.hdg;
-				r.successor.id = rConnection.id;
-				r.successor.contactPoint = startType;
-				rConnection.predecessor.id = fromRoadId;
-				rConnection.predecessor.contactPoint = endType;
-				lS1 = r.laneSections.back();
-			}
-			else
-			{
-				cerr << "ERR: wrong position for fromPos is specified." << endl;
-				cerr << "\t -> use 'start' or 'end'" << endl;
-				return 1;
-			}
+			cerr << "ERR: wrong position for fromPos is specified." << endl;
+			cerr << "\t -> use 'start' or 'end'" << endl;
+			return 1;
 		}
-		if (!found)
+		if (t.fromRoads.empty())
 		{
 			cerr << "ERR: from road not found." << endl;
 			return 1;
 		}
 
 		// save to position
-		found = false;
-		for (auto &&r : data.roads)
-		{
-			if (r.junction != toSegment || r.inputId != toRoadId)
-				continue;
-			if (toIsJunction && r.inputPos != toPos)
-				continue;
-
-			toRoad = r;
-			toRoadId = r.id;
-			found = true;
-
-			// if junction, the contact point is always at "end" of a road
-			if (fromIsJunction)
-				toPos = "end";
-
-			if (toPos == "start")
-			{
-				toX = r.geometries.front().x;
-				toY = r.geometries.front().y;
-				toHdg = r.geometries.front().hdg;
-				r.predecessor.id = rConnection.id;
-				r.predecessor.contactPoint = endType;
-				rConnection.successor.id = r.id;
-				rConnection.successor.contactPoint = startType;
-				lS2 = r.laneSections.front();
-			}
-			else if (toPos == "end")
-			{
-				geometry g = r.geometries.back();
-				toX = g.x;
-				toY = g.y;
-				toHdg = g.hdg;
-				curve(g.length, g, toX, toY, toHdg, 1);
-				r.successor.id = rConnection.id;
-				r.successor.contactPoint = endType;
-				rConnection.successor.id = r.id;
-				rConnection.successor.contactPoint = endType;
-				lS2 = r.laneSections.back();
-			}
-			else
-			{
-				cerr << "ERR: wrong position for toPos is specified." << endl;
-				cerr << "\t -> use 'start' or 'end'" << endl;
-				return 1;
-			}
-		}
-		if (!found)
+		if (resolveCloseRoadEnd(index, data.roads, toSegment, toRoadId, toIsJunction, fromIsJunction, t.toPos, t.toRoads))
 		{
-			cerr << "ERR: to road not found." << endl;
+			cerr << "ERR: wrong position for toPos is specified." << endl;
+			cerr << "\t -> use 'start' or 'end'" << endl;
 			return 1;
 		}
-
-		// adjust toHdg
-		if(toHdg != 0) //testing
-			toHdg += M_PI;
-		fixAngle(toHdg);
-
-		// --- build new geometry ----------------------------------------------
-		if (closeRoadConnection(rConnection.geometries, fromX, fromY, fromHdg, toX, toY, toHdg)) //the tohdg angle is wrong some of the time
+		if (t.toRoads.empty())
 		{
-			cerr << "ERR: error in closeRoadConnection function." << endl;
+			cerr << "ERR: to road not found." << endl;
 			return 1;
 		}
 
+		closeRoadPose(data.roads[t.fromRoads.back()], t.fromPos, t.fromX, t.fromY, t.fromHdg);
+		closeRoadPose(data.roads[t.toRoads.back()], t.toPos, t.toX, t.toY, t.toHdg);
 
-		
-		// --- compute length --------------------------------------------------
-		for (int j = 0; j < rConnection.geometries.size(); j++)
-		{
-			rConnection.length += rConnection.geometries[j].length;
-		}
-
-		// --- add lanes -------------------------------------------------------
-		vector<laneSection> secs;
-
-		// flip lanes if in false direction
-		if (fromPos == "start")
-			for (int j = 0; j < lS1.lanes.size(); j++)
-				lS1.lanes[j].id *= -1;
-
-		if (toPos == "end")
-			for (int j = 0; j < lS2.lanes.size(); j++)
-				lS2.lanes[j].id *= -1;
-
-		lS1.s = 0;
-		secs.push_back(lS1);
-
-		double dPos = abs(findMaxLaneId(lS2)) - abs(findMaxLaneId(lS1));
-		double dNeg = abs(findMinLaneId(lS2)) - abs(findMinLaneId(lS1));
-
-		double ds = setting.laneChange.ds;
-		double s = 0;
-		// add widenings if necessary
-		while (dPos > 0)
-		{
-			addLaneWidening(secs, findMaxLaneId(lS1), s, ds, false);
-			s += ds;
-			dPos--;
-		}
-		while (dNeg > 0)
-		{
-			addLaneWidening(secs, findMinLaneId(lS1), s, ds, false);
-			s += ds;
-			dNeg--;
-		}
-		while (dPos < 0)
-		{
-			addLaneDrop(secs, findMaxLaneId(lS1), s, ds);
-			s += ds;
-			dPos++;
-		}
-		while (dNeg < 0)
-		{
-			addLaneDrop(secs, findMinLaneId(lS1), s, ds);
-			s += ds;
-			dNeg++;
-		}
-
-		
-
-
-		// --- adjust lanewidth of last section to be equal to lS2 -------------
-		for (int j = 0; j < secs.back().lanes.size(); j++)
-		{
-			lane curLane = secs.back().lanes[j];
-			int id = curLane.id;
-
-			lane refLane;
-			findLane(lS2, refLane, id);
-
-			double w1 = curLane.w.a;
-			double w2 = refLane.w.a;
-			if (w1 == w2)
-				continue;
+		// adjust toHdg
+		if(t.toHdg != 0) //testing
+			t.toHdg += M_PI;
+		fixAngle(t.toHdg);
 
-			double length = rConnection.length - s;
+		tasks.push_back(std::move(t));
+	}
 
-			curLane.w.d = -2 * (w2 - w1) / pow(length, 3);
-			curLane.w.c = 3 * (w2 - w1) / pow(length, 2);
-			curLane.w.b = 0;
-			curLane.w.a = w1;
+	// --- build new geometries ------------------------------------------------
+	parallelFor(tasks.size(), [&](int k) {
+		closeRoadTask &t = tasks[k];
 
-			secs.back().lanes[j] = curLane;
-		}
+		// the geometries are created in the worker, so that they do not use the arena of the run
+		referenceLine geo;
+		t.error = closeRoadConnection(geo, t.fromX, t.fromY, t.fromHdg, t.toX, t.toY, t.toHdg, t.report); //the tohdg angle is wrong some of the time
+		t.geometries = std::move(geo);
+	});
 
-		road *tmpRoad;
-		int fr = findRoad(data.roads, tmpRoad, fromRoadId);
-		int tr = findRoad(data.roads, tmpRoad, toRoadId);
-
-		// --- add lane links --------------------------------------------------
-		for (int j = 0; j < secs.front().lanes.size(); j++)
+	// --- add roads and links in input order ----------------------------------
+	for (closeRoadTask &t : tasks)
+	{
+		if (t.error)
 		{
-			secs.front().lanes[j].preId = secs.front().lanes[j].id;
-			data.roads[fr].laneSections.front().lanes[j].sucId = secs.front().lanes[j].id;
-
-			if (fromPos == "start")
-			{
-				secs.front().lanes[j].preId *= -1;
-				data.roads[fr].laneSections.front().lanes[j].preId *= -1;
-			}
+			cerr << "ERR: error in closeRoadConnection function." << endl;
+			return 1;
 		}
-
-		for (int j = 0; j < secs.back().lanes.size(); j++)
+		if (commitCloseRoad(t, data, ids))
 		{
-			secs.back().lanes[j].sucId = secs.back().lanes[j].id;
-			data.roads[tr].laneSections.back().lanes[j].sucId = secs.back().lanes[j].id;
-
-			if (toPos == "end")
-			{
-				secs.back().lanes[j].sucId *= -1;
-				data.roads[tr].laneSections.back().lanes[j].sucId *= -1;
-			}
+			cerr << "ERR: error in commitCloseRoad function." << endl;
+			return 1;
 		}
-		
-
-		rConnection.laneSections = secs;
-
-		data.roads.push_back(rConnection);
 	}
 
-	
 	return 0;
-}
\ No newline at end of file
+}
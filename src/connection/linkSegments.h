@@ -17,34 +17,77 @@
 
 #include<map>
 #include<queue>
+#include<unordered_map>
+#include<unordered_set>
+
+/**
+ * @brief lookup tables for the lane link conflict resolution
+ * 
+ */
+struct linkIndex
+{
+	unordered_map<int, int> roads;	// road id -> index in data.roads; the last road with the id is used
+	unordered_set<int> junctions;	// junction ids
+
+	linkIndex(const roadNetwork &data)
+	{
+		roads.reserve(data.roads.size());
+		for (int i = 0; i < (int)data.roads.size(); i++)
+			roads[data.roads[i].id] = i;
+
+		for (const junction &j : data.junctions)
+			junctions.insert(j.id);
+	}
+
+	bool isJunction(int id) const { return junctions.count(id) != 0; }
+
+	road *find(roadNetwork &data, int id) const
+	{
+		unordered_map<int, int>::const_iterator it = roads.find(id);
+		return (it == roads.end()) ? NULL : &data.roads[it->second];
+	}
+};
+
+/**
+ * @brief mirrors the lane links of a lane section: the lane at position i is linked to the lane at the mirrored position
+ * 
+ * @param sec 		lane section
+ * @param successor	true: successor links are set, false: predecessor links are set
+ */
+void mirrorLaneLinks(laneSection &sec, bool successor)
+{
+	int n = sec.lanes.size();
+	for (int i = 0; i < n; i++)
+	{
+		int id = sec.lanes[n - 1 - i].id;
+		if (successor)
+			sec.lanes[i].sucId = id;
+		else
+			sec.lanes[i].preId = id;
+	}
+}
 
 /**
  * @brief Resolves conflicts that occur when segments are linked end to end or start to start
  * 
  * @param data road network data
+ * @param index lookup tables of the road network
  * @return int error code
  */
-int resolveAlignmentConflicts(roadNetwork &data)
+int resolveAlignmentConflicts(roadNetwork &data, const linkIndex &index)
 {
 	//assumption that all user provided segments are linked by now.
 	for(road &r: data.roads)
 	{
+		if(index.isJunction(r.id))
+			continue;
 
 		if(r.successor.id != -1)
 		{
-			road *suc;
-			for(road &rr: data.roads)
-			{
-				if(rr.id == r.successor.id)
-				{
-					suc = &rr;
-				}
-			}
-
-			if(isJunction(data, r.id) || isJunction(data, suc->id))
-			{
+			// a road whose successor is a junction or unknown is skipped completely, also for its predecessor
+			road *suc = (r.successor.elementType != junctionType) ? index.find(data, r.successor.id) : NULL;
+			if(suc == NULL || index.isJunction(suc->id))
 				continue;
-			}
 
 			int sucOrPre = suc->getAdjacentRoadWithId(r.id);
 			if( (sucOrPre == -1 && r.successor.contactPoint == suc->predecessor.contactPoint) 
@@ -53,60 +96,30 @@ int resolveAlignmentConflicts(roadNetwork &data)
 				int borderingLaneSection = 0; 
 				if(r.successor.contactPoint == endType)
 					borderingLaneSection = r.laneSections.size() - 1;
-				vector<int> laneIds;
-				for(lane &l: r.laneSections.at(borderingLaneSection).lanes)
-				{
-					laneIds.insert(laneIds.begin(), l.id);
-				}
 
 				//switch all lane links
-				for(int i = 0; i < r.laneSections.at(borderingLaneSection).lanes.size(); i ++)
-				{
-					r.laneSections.at(borderingLaneSection).lanes[i].sucId = laneIds[i];
-				}
+				mirrorLaneLinks(r.laneSections.at(borderingLaneSection), true);
 		
 				cerr << "switched road " << r.id << " and succ " <<suc->id << endl;
-
 			}
 		}
+
 		//repeat for predecessors
-		if(r.predecessor.id != -1)
+		road *pre = (r.predecessor.id != -1 && r.predecessor.elementType != junctionType) ? index.find(data, r.predecessor.id) : NULL;
+		if(pre != NULL && !index.isJunction(pre->id))
 		{
-			road *pre;
-			for(road &rr: data.roads)
-			{
-				if(rr.id == r.predecessor.id)
-				{
-					pre = &rr;
-				}
-			}
-
-			if(isJunction(data, r.id) || r.predecessor.elementType == junctionType || isJunction(data, pre->id))
-			{
-				continue;
-			}
 			int sucOrPre = pre->getAdjacentRoadWithId(r.id);
 			if( (sucOrPre == -1  && r.predecessor.contactPoint == pre->predecessor.contactPoint) 
 			|| 	 sucOrPre ==  1  && r.predecessor.contactPoint == pre->successor.contactPoint)
 			{
-
 				int borderingLaneSection = 0; 
 				if(r.predecessor.contactPoint == endType)
 					borderingLaneSection = r.laneSections.size() - 1;
-				vector<int> laneIds;
-				for(lane &l: r.laneSections.at(borderingLaneSection).lanes)
-				{
-					laneIds.insert(laneIds.begin(), l.id);
-				}
 
 				//switch all lane links
-				for(int i = 0; i < r.laneSections.at(borderingLaneSection).lanes.size(); i ++)
-				{
-					r.laneSections.at(borderingLaneSection).lanes[i].preId = laneIds[i];
-				}
+				mirrorLaneLinks(r.laneSections.at(borderingLaneSection), false);
 		
 				cerr << "switched road " << r.id << " and pre " <<pre->id << endl;
-
 			}
 		}
 	}
@@ -116,17 +129,18 @@ int resolveAlignmentConflicts(roadNetwork &data)
 /**
  * @brief Removes lane links to junctions or empty roads
  * 
- * @param data 
+ * @param data road network data
+ * @param index lookup tables of the road network
  * @return int error code
  */
-int resolveIllegalLinkConflcits(roadNetwork &data)
+int resolveIllegalLinkConflcits(roadNetwork &data, const linkIndex &index)
 {
 	for(road &r: data.roads)
 	{
-		if(isJunction(data, r.id))
+		if(index.isJunction(r.id))
 			continue;
 		
-		if(isJunction(data, r.successor.id) || r.successor.id == -1)
+		if(index.isJunction(r.successor.id) || r.successor.id == -1)
 		{
 			int lsId = 0;
 			if(r.successor.contactPoint == endType)
@@ -137,7 +151,7 @@ int resolveIllegalLinkConflcits(roadNetwork &data)
 			}
 		}
 
-		if(isJunction(data, r.predecessor.id) || r.predecessor.id == -1)
+		if(index.isJunction(r.predecessor.id) || r.predecessor.id == -1)
 		{
 			int lsId = 0;
 			if(r.predecessor.contactPoint == endType)
@@ -147,9 +161,6 @@ int resolveIllegalLinkConflcits(roadNetwork &data)
 				l.preId = UNASSIGNED;
 			}
 		}
-
-		
-
 	}
 	return 0;
 }
@@ -160,12 +171,15 @@ int resolveIllegalLinkConflcits(roadNetwork &data)
  */
 int resolveLaneLinkConflicts(roadNetwork &data)
 {	
-	if(resolveAlignmentConflicts(data))
+	// roads and junctions are looked up by id in constant time, so both passes are linear in the number of roads
+	linkIndex index(data);
+
+	if(resolveAlignmentConflicts(data, index))
 	{
 		throwError("Could not resolve Alignment conflicts");
 		return 1;
 	}
-	if (resolveIllegalLinkConflcits(data))
+	if (resolveIllegalLinkConflcits(data, index))
 	{
 		throwError("Could not remove lane links to junctions");
 		return 1;
@@ -175,14 +189,16 @@ int resolveLaneLinkConflicts(roadNetwork &data)
 }
 
 /**
- * @brief Transforms toSegments position according to the from segment and the semgment link data to the coordinate system of the reference segment
+ * @brief Transforms toSegments position according to the from segment and the semgment link data to the coordinate system of the reference segment.
+ * 	The transformation is not applied to the geometries directly but composed onto the pending transformation of the toSegment
  * 
  * @param segmentLink segment to link
  * @param data road network data
+ * @param pending pending transformations of all segments, stored by segment id
  * @param swap if true the from and toSegment and road are swapped
  * @return int error code
  */
-int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
+int transformRoad(DOMElement *segmentLink, roadNetwork &data, std::map<int, rigidTransform> &pending, bool swap = false)
 {
 
 	// get properties
@@ -202,8 +218,8 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 		fromPos = readStrAttrFromNode(segmentLink, "toPos");
 		toPos = readStrAttrFromNode(segmentLink, "fromPos");
 	}
-	road *fromRoad;
-	road *toRoad;
+	road *fromRoad = NULL;
+	road *toRoad = NULL;
 
 
 	// assumption is that "fromSegement" is already linked to reference frame
@@ -268,15 +284,20 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 
 		}
 
+		// positions are computed with the pending transformation of the segment
+		const rigidTransform &t = pending[segmentOfRoad(r)];
+
 		if (fromPos == "start")
 		{
 			fromX = r.geometries.front().x;
 			fromY = r.geometries.front().y;
 			fromHdg = r.geometries.front().hdg;
+			t.apply(fromX, fromY, fromHdg);
 		}
 		else if (fromPos == "end")
 		{
 			geometry g = r.geometries.back();
+			t.apply(g.x, g.y, g.hdg);
 			curve(g.length, g, g.x, g.y, g.hdg, 1);
 			fromX = g.x;
 			fromY = g.y;
@@ -307,15 +328,20 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 			toPos = "end";
 	
 		}
+
+		const rigidTransform &t = pending[segmentOfRoad(r)];
+
 		if (toPos == "start")
 		{
 			toX = r.geometries.front().x;
 			toY = r.geometries.front().y;
 			toHdg = r.geometries.front().hdg;
+			t.apply(toX, toY, toHdg);
 		}
 		else if (toPos == "end")
 		{
 			geometry g = r.geometries.back();
+			t.apply(g.x, g.y, g.hdg);
 			toX = g.x;
 			toY = g.y;
 			toHdg = g.hdg;
@@ -323,6 +349,13 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 		}
 	}
 
+	if (fromRoad == NULL || toRoad == NULL)
+	{
+		std::cerr << "ERR: 'Road linking is wrong!'" << std::endl;
+		std::cerr << "    couldn't find fromSegment " << fromSegment << " or toSegment " << toSegment << std::endl;
+		return -1;
+	}
+
 	// --- rotate and shift current road according to from position --------
 	double dx, dy;
 
@@ -334,15 +367,13 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 		dPhi += M_PI;
 	fixAngle(dPhi);
 
+	rigidTransform &toTransform = pending[segmentOfRoad(*toRoad)];
+
 	// if toPos is end, the actual toPos has to be computed
 	if (toPos == "end")
 	{
-		if(toRoad->id == -1){
-			std::cerr << "ERR: 'Road linking is wrong!'" << std::endl;
-			std::cerr << "    couldn't find toSegment " << toSegment << " or toRoadID " << toRoadId << std::endl;
-			return -1;
-		}
 		geometry g = toRoad->geometries.back();
+		toTransform.apply(g.x, g.y, g.hdg);
 		toX = g.x * cos(dPhi) - g.y * sin(dPhi);
 		toY = g.x * sin(dPhi) + g.y * cos(dPhi);
 		toHdg = g.hdg + dPhi;
@@ -353,24 +384,8 @@ int transformRoad(DOMElement *segmentLink, roadNetwork &data, bool swap = false)
 	dx = fromX - toX;
 	dy = fromY - toY;
 
-	// shift all geometries which belong to the toSegment according two the offsets determined above
-	for (auto &&r : data.roads)
-	{
-		if (r.junction != toSegment && r.roundAboutInputSegment != toSegment)
-			continue;
-		
-
-		for (auto &&g : r.geometries)
-		{
-			double x = g.x * cos(dPhi) - g.y * sin(dPhi);
-			double y = g.x * sin(dPhi) + g.y * cos(dPhi);
-
-			g.x = x + dx;
-			g.y = y + dy;
-			g.hdg = g.hdg + dPhi;
-			fixAngle(g.hdg);
-		}
-	}
+	// store the transformation for all geometries which belong to the toSegment; it is applied once after all links are processed
+	toTransform.compose(dPhi, dx, dy, true);
 
 	// if(!swap) //this case distinction led to wrong linkings for all successors of ref segment
 	// {
@@ -454,7 +469,7 @@ int linkSegments(const DOMElement* rootNode, roadNetwork &data)
 	DOMElement *links = getChildWithName(rootNode, "links");
 	if (links == NULL)
 	{
-		if(!setting.silentMode)
+		if(!setting.suppressOutput)
 		{
 			cout << "\tLinks are not specified -> skip segment linking" << endl;
 		}
@@ -473,23 +488,11 @@ int linkSegments(const DOMElement* rootNode, roadNetwork &data)
 	double yOffset = readDoubleAttrFromNode(links, "yOffset");
 
 
-	for (auto &&r : data.roads)
-	{
-		if (r.junction != data.refRoad)
-			continue;
+	// transformations are accumulated per segment and applied at once after all links are processed
+	std::map<int, rigidTransform> pending;
 
-		for (auto &&g : r.geometries)
-		{
-
-			// transform geometries of reference segement into reference system
-			double x = g.x * cos(hdgOffset) - g.y * sin(hdgOffset);
-			double y = g.x * sin(hdgOffset) + g.y * cos(hdgOffset);
-
-			g.x = x + xOffset;
-			g.y = y + yOffset;
-			g.hdg = g.hdg + hdgOffset;
-		}
-	}
+	// transform geometries of reference segement into reference system
+	pending[data.refRoad].compose(hdgOffset, xOffset, yOffset, false);
 
 	//generate a map to store all outgoing links of each segment
 	std::map<int, vector<int>> outgoing_connections;
@@ -498,12 +501,14 @@ int linkSegments(const DOMElement* rootNode, roadNetwork &data)
 
 	int linkcount = links->getChildElementCount();
 
-	if(linkcount <= 0 && !setting.silentMode)
+	if(linkcount <= 0)
 	{
-		cout << "\tNo links are defined" << endl;
+		if(!setting.suppressOutput)
+			cout << "\tNo links are defined" << endl;
+		applySegmentTransforms(data, pending);
 		return 0;
 	}
-	else if(!setting.silentMode)
+	else if(!setting.suppressOutput)
 	{
 		cout << "\t"<< linkcount  << " links are defined" << endl;
 	}
@@ -542,7 +547,7 @@ int linkSegments(const DOMElement* rootNode, roadNetwork &data)
 				//process the element------------------
 				//cout << "Transforming roads" << endl;
 
-				transformRoad(segmentLink, data);
+				transformRoad(segmentLink, data, pending);
 				
 				//end processessing the element--------
 				break; //prevents multiple processing steps if they are defined in the xml (they shouldn't be)
@@ -561,7 +566,7 @@ int linkSegments(const DOMElement* rootNode, roadNetwork &data)
 			{
 				if(curId != readIntAttrFromNode(segmentLink, "toSegment") || incoming_id != readIntAttrFromNode(segmentLink, "fromSegment")) continue;
 				//process the element------------------
-				transformRoad(segmentLink, data, true);
+				transformRoad(segmentLink, data, pending, true);
 				break; //prevents multiple processing steps if they are defined in the xml (they shouldn't be)
 
 			}
@@ -569,6 +574,13 @@ int linkSegments(const DOMElement* rootNode, roadNetwork &data)
 		}
 	}
 
+	// apply all accumulated transformations to the geometries
+	if (applySegmentTransforms(data, pending))
+	{
+		throwError("Could not apply segment transformations");
+		return 1;
+	}
+
 	//check if all roads are connected to the network
 	vector<road*> v;
 	for(road &r: data.roads)
@@ -584,7 +596,7 @@ int linkSegments(const DOMElement* rootNode, roadNetwork &data)
 		for(road* p: v)
 		{
 
-			if(!setting.silentMode)
+			if(!setting.suppressOutput)
 				cout << "\tRoad " << p->inputId << " in segment " << p->inputSegmentId << " is not linked"<< endl;
 
 		}
@@ -27,7 +27,15 @@ const char *HELP_MESSAGE =
   "    -s                               Disable console output.\n"
   "    -d <fileDir>                     Specify output file directory.\n"
   "    -o <fileName>                    Specify output file name.\n"
-  "    -k                               Keep logfile. Log will be overwritten if this is not set.\n\n";
+  "    -k                               Keep logfile. Log will be overwritten if this is not set.\n"
+  "    -e                               Solve all elevation offsets at once (least squares), spreads the height steps of closed loops over all links.\n"
+  "    -c                               Check the elevation for max grade and continuity at all links before the output is written.\n"
+  "    -p <step>                        Sample step of the elevation check in m (default 1).\n"
+  "    -r                               Refine the elevation samples of curved polynoms, the step of -p is then the max step.\n"
+  "    -a                               Check the junctions for overlapping arms and crossing connecting roads.\n"
+  "    -g                               Export the lane graph as binary <fileName>.lanegraph.\n"
+  "    -t <n>                           Number of worker threads, 0 uses all hardware threads.\n"
+  "    -j <cacheDir>                    Reuse connecting roads of identical junctions from the cache directory.\n\n";
 
 
 /**
@@ -85,6 +93,50 @@ int parseArgs(int argc, char **argv, settingsExec &settings) {
                     settings.overwriteLog = false;
                 break;
 
+                case 'e':
+                    settings.leastSquaresElevation = true;
+                break;
+
+                case 'c':
+                    settings.checkElevation = true;
+                break;
+
+                case 'p':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.elevationSampleStep = atof(argv[++i]);
+                break;
+
+                case 'r':
+                    settings.adaptiveElevationSampling = true;
+                break;
+
+                case 'a':
+                    settings.checkJunctions = true;
+                break;
+
+                case 'g':
+                    settings.exportLaneGraph = true;
+                break;
+
+                case 't':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.threads = atoi(argv[++i]);
+                break;
+
+                case 'j':
+                    if(argc <= i +1){
+                        std::cout <<"ERR: invalid arguments!" << std::endl;
+                        return -1;
+                    }
+                    settings.junctionCacheDir = argv[++i];
+                break;
+
                 default:
                     std::cout << "ERR: invalid arguments!" << std::endl;
                     return -1;
@@ -22,6 +22,7 @@
 #include <string.h>
 #include <vector>
 #include <stdio.h>
+#include <stdlib.h>
 #include "settingsExec.h"
 
 /**
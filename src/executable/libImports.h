@@ -26,6 +26,14 @@ extern "C" void setOutputName(char* file);
 extern "C" void setSilentMode(bool sMode);
 extern "C" void setXMLSchemaLocation(char* file);
 extern "C" void setOverwriteLog(bool b);
+extern "C" void setLeastSquaresElevation(bool b);
+extern "C" void setElevationCheck(bool b);
+extern "C" void setElevationSampling(double step, bool adaptive);
+extern "C" void setJunctionCheck(bool b);
+extern "C" void setLaneGraphExport(bool b);
+extern "C" void setThreads(int threads);
+extern "C" void setJunctionCache(bool b);
+extern "C" void setJunctionCacheDir(char* dir);
 
 
 #endif
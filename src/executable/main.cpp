@@ -27,7 +27,7 @@ using namespace std;
  * 
  * @param argc 
  * @param argv 
- * @return int: error code. 0 means that no errors occured. 
+ * @return int: error code. 0 means that no errors occured, 1 that the pipeline failed. 
  */
 int main(int argc, char** argv){
 
@@ -44,7 +44,19 @@ int main(int argc, char** argv){
     setOverwriteLog(settings.overwriteLog);
     setOutputName(settings.outputName);
     setSilentMode(settings.silentMode);
-    execPipeline();
+    setLeastSquaresElevation(settings.leastSquaresElevation);
+    setElevationCheck(settings.checkElevation);
+    setElevationSampling(settings.elevationSampleStep, settings.adaptiveElevationSampling);
+    setJunctionCheck(settings.checkJunctions);
+    setLaneGraphExport(settings.exportLaneGraph);
+    setThreads(settings.threads);
+    if (settings.junctionCacheDir != NULL){
+        setJunctionCache(true);
+        setJunctionCacheDir(settings.junctionCacheDir);
+    }
+    if (execPipeline()){
+        return 1;
+    }
 
     return 0;
 }
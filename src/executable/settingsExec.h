@@ -25,6 +25,14 @@ struct settingsExec{
     char* outputName;
     bool silentMode = false;
     bool overwriteLog = true;
+    bool leastSquaresElevation = false;
+    bool checkElevation = false;
+    double elevationSampleStep = 1;
+    bool adaptiveElevationSampling = false;
+    bool checkJunctions = false;
+    bool exportLaneGraph = false;
+    int threads = 0;
+    char* junctionCacheDir = NULL;
 
 };
 
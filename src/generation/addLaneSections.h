@@ -16,7 +16,8 @@
  */
 
 /**
- * @brief function adds a laneSection with laneWideing to a given lanesection set
+ * @brief function appends the laneSections of a laneWidening to a given lanesection set.
+ *  The widening starts in the last lane section, so s has to be behind its start
  * 
  * @param secs          vector of all lanesections of a road
  * @param addLaneId          determines the road's side of the widening
@@ -25,33 +26,11 @@
  * @param addouterLane  specifies if additional lane is on the outer side or not
  * @return int          error code
  */
-int addLaneWidening(vector<laneSection> &secs, int addLaneId, double s, double ds, bool addOuterLane)
+int addLaneWidening(arenaVector<laneSection> &secs, int addLaneId, double s, double ds, bool addOuterLane)
 {
-    std::vector<laneSection>::iterator it;
-    int i = 0;
-
-
-    // search corresponding lane Section
-    bool found = false;
-    int n = secs.size();
-    for (i = n - 1; i >= 0; i--)
-    {
-        if (secs[i].s <= s)
-        {
-            found = true;
-            it = secs.begin() + i;
-            break;
-        }
-    }
-    if (!found)
-    {
-        it = secs.begin() + secs.size() - 1;
-        i = secs.size() - 1;
-    }
-
-    laneSection adLaneSec = *it;
+    laneSection adLaneSec = secs.back();
     //Adjust the succ lane connection of predecessor
-    for(lane &l: it->lanes)
+    for(lane &l: secs.back().lanes)
     {
         if(sgn(l.id) == sgn(addLaneId) && abs(l.id) >= abs(addLaneId))
         {
@@ -69,7 +48,7 @@ int addLaneWidening(vector<laneSection> &secs, int addLaneId, double s, double d
         return 1;
     }
 
-    adLaneSec.id = it->id + 1;
+    adLaneSec.id = secs.back().id + 1;
     adLaneSec.s = s;
 
     // find current lane in adLaneSec
@@ -99,13 +78,10 @@ int addLaneWidening(vector<laneSection> &secs, int addLaneId, double s, double d
     id = findLane(adLaneSec, tmp, 0);
     adLaneSec.lanes[id].rm.type = "solid";
 
-    it++;
-    i++;
-
-    it = secs.insert(it, adLaneSec);
+    secs.push_back(adLaneSec);
 
     //adjust all predecessor links for outer lanes in the lane section with the actual widthchange
-    for(lane &l: it->lanes)
+    for(lane &l: secs.back().lanes)
     {
         if(sgn(l.id) == sgn(addLaneId) && abs(l.id) > abs(addLaneId))
         {
@@ -120,7 +96,7 @@ int addLaneWidening(vector<laneSection> &secs, int addLaneId, double s, double d
     l.w.a = w;
     l.preId = l.id;
 
-    adLaneSec.lanes.back() = l;
+    adLaneSec.lanes[adLaneSec.lanes.find(l.id)] = l;
 
     adLaneSec.id++;
     adLaneSec.s += ds;
@@ -129,31 +105,14 @@ int addLaneWidening(vector<laneSection> &secs, int addLaneId, double s, double d
     id = findLane(adLaneSec, tmp, 0);
     adLaneSec.lanes[id].rm.type = "broken";
 
-    it++;
-    i++;
-    it = secs.insert(it, adLaneSec);
-
-    it++;
-    i++;
-
-
-    // --- shift all lanes in following lane sections --------------------------
-    for (; it != secs.end(); ++it)
-    {
-        secs[i].id += 2;
-
-            shiftLanes(secs[i], laneId, 1, false, false);
-            if (abs(l.id) <= abs(laneId))
-                l.rm.type = "broken";
-            it->lanes.push_back(l);
-        i++;
-    }
+    secs.push_back(adLaneSec);
 
     return 0;
 }
 
 /**
- * @brief function adds a laneSection with laneDrop to a given lanesection set
+ * @brief function appends the laneSections of a laneDrop to a given lanesection set.
+ *  The drop starts in the last lane section, so s has to be behind its start
  * 
  * @param secs          vector of all lanesections of a road
  * @param dropLaneID    determines the lane id of the drop
@@ -161,31 +120,11 @@ int addLaneWidening(vector<laneSection> &secs, int addLaneId, double s, double d
  * @param ds            length of laneDrop
  * @return int          error code
  */
-int addLaneDrop(vector<laneSection> &secs, int dropLaneID, double s, double ds)
+int addLaneDrop(arenaVector<laneSection> &secs, int dropLaneID, double s, double ds)
 {
-    std::vector<laneSection>::iterator it;
-    std::vector<lane>::iterator itt;
-
-    // search corresponding lane Section
-    int i = 0;
-    bool found = false;
-    int n = secs.size();
-    for (i = n - 1; i >= 0; i--)
-    {
-        if (secs[i].s <= s)
-        {
-            found = true;
-            it = secs.begin() + i;
-            break;
-        }
-    }
-    if (!found)
-    {
-        it = secs.begin() + secs.size() - 1;
-        i = secs.size() - 1;
-    }
+    arenaVector<lane>::iterator itt;
 
-    laneSection adLaneSec = *it;
+    laneSection adLaneSec = secs.back();
 
     int laneId = dropLaneID;
     
@@ -195,7 +134,7 @@ int addLaneDrop(vector<laneSection> &secs, int dropLaneID, double s, double ds)
         cerr << "ERR: lane drop can not be performed" << endl;
     }
 
-    adLaneSec.id = it->id + 1;
+    adLaneSec.id = secs.back().id + 1;
     adLaneSec.s = s;
 
     // find current lane in adLaneSec
@@ -217,12 +156,10 @@ int addLaneDrop(vector<laneSection> &secs, int dropLaneID, double s, double ds)
     id = findLane(adLaneSec, l, 0);
     adLaneSec.lanes[id].rm.type = "solid";
 
-
-    it++;
-    it = secs.insert(it, adLaneSec);
+    secs.push_back(adLaneSec);
 
     //adjust the successor links
-    for(lane &l: it->lanes)
+    for(lane &l: secs.back().lanes)
     {
         if(sgn(l.id) == sgn(dropLaneID))
             if(abs(l.id) > abs(dropLaneID))
@@ -257,10 +194,9 @@ int addLaneDrop(vector<laneSection> &secs, int dropLaneID, double s, double ds)
     itt = adLaneSec.lanes.begin() + id;
     adLaneSec.lanes.erase(itt);
 
-    it++;
-    it = secs.insert(it, adLaneSec);
+    secs.push_back(adLaneSec);
      //adjust the pred links
-    for(lane &l: it->lanes)
+    for(lane &l: secs.back().lanes)
     {
         if(sgn(l.id) == sgn(dropLaneID))
         {
@@ -275,25 +211,12 @@ int addLaneDrop(vector<laneSection> &secs, int dropLaneID, double s, double ds)
         }
     }
 
-    it++;
-
-    // --- shift all lanes in following lane sections --------------------------
-    //This routine might never get called
-    for (; it != secs.end(); ++it)
-    {
-        int id = findLane(*it, l, laneId);
-
-        shiftLanes(*it, laneId, -1, false);
-
-        itt = it->lanes.begin() + id;
-        it->lanes.erase(itt);
-    }
-
     return 0;
 }
 
 /**
- * @brief function adds a laneSection with restricted area after a lane widening
+ * @brief function adds a laneSection with restricted area in front of a lane widening.
+ *  The lane widening at s has to be the last change, its two laneSections are the last ones of the set
  * 
  * @param secs      vector of all lanesections of a road
  * @param side      determines the road's side of the widening
@@ -302,36 +225,23 @@ int addLaneDrop(vector<laneSection> &secs, int dropLaneID, double s, double ds)
  * @param ds2       length of restricted areay (always lager than ds1)
  * @return int      error code
  */
-int addRestrictedAreaWidening(vector<laneSection> &secs, int side, double s, double ds1, double ds2)
+int addRestrictedAreaWidening(arenaVector<laneSection> &secs, int side, double s, double ds1, double ds2)
 {
-    std::vector<laneSection>::iterator it;
-    std::vector<lane>::iterator itt;
-
     if (ds1 >= ds2)
     {
         cerr << "ERR: length in restricted area is to short." << endl;
         return 1;
     }
 
-    // search corresponding lane Section
-    int i = 0;
-    bool found = false;
-    for (i = 0; i < secs.size() - 1; i++)
-    {
-        if (secs[i].s <= s && secs[i + 1].s > s)
-        {
-            found = true;
-            it = secs.begin() + i;
-            break;
-        }
-    }
-    if (!found)
+    // first laneSection of the lane widening
+    int i = secs.size() - 2;
+    if (i < 1 || secs[i].s != s)
     {
-        it = secs.begin() + secs.size() - 1;
-        i = secs.size() - 1;
+        cerr << "ERR: restricted area is not at a lane widening." << endl;
+        return 1;
     }
 
-    laneSection adLaneSec = *it;
+    laneSection adLaneSec = secs[i];
 
     int laneId = 0;
     if (side > 0)
@@ -374,7 +284,7 @@ int addRestrictedAreaWidening(vector<laneSection> &secs, int side, double s, dou
     l.id = sgn(side) + laneId;
     adLaneSec.lanes.push_back(l);
 
-    secs[i] = adLaneSec;
+    laneSection widening = adLaneSec;
 
     // --- Section 2 -----------------------------------------
     adLaneSec.s = s - (ds2 - ds1);
@@ -403,13 +313,18 @@ int addRestrictedAreaWidening(vector<laneSection> &secs, int side, double s, dou
     l.rm.color = "white";
     adLaneSec.lanes[id] = l;
 
-    secs.insert(it, adLaneSec);
+    // the restricted area is put in front of the two laneSections of the lane widening
+    laneSection behind = secs[i + 1];
+    secs[i] = adLaneSec;
+    secs[i + 1] = widening;
+    secs.push_back(behind);
 
     return 0;
 }
 
 /**
- * @brief function adds a laneSection with restricted area after a lane drop
+ * @brief function adds a laneSection with restricted area after a lane drop.
+ *  The lane drop at s has to be the last change, its two laneSections are the last ones of the set
  * 
  * @param secs      vector of all lanesections of a road
  * @param side      determines the road's side of the drop
@@ -418,10 +333,9 @@ int addRestrictedAreaWidening(vector<laneSection> &secs, int side, double s, dou
  * @param ds2       length of restricted areay (always lager than ds1)
  * @return int      error code
  */
-int addRestrictedAreaDrop(vector<laneSection> &secs, int side, double s, double ds1, double ds2)
+int addRestrictedAreaDrop(arenaVector<laneSection> &secs, int side, double s, double ds1, double ds2)
 {
-    std::vector<laneSection>::iterator it;
-    std::vector<lane>::iterator itt;
+    arenaVector<lane>::iterator itt;
 
     if (ds1 >= ds2)
     {
@@ -429,25 +343,15 @@ int addRestrictedAreaDrop(vector<laneSection> &secs, int side, double s, double
         return 1;
     }
 
-    // search corresponding lane Section
-    int i = 0;
-    bool found = false;
-    for (i = 0; i < secs.size() - 1; i++)
-    {
-        if (secs[i].s <= s && secs[i + 1].s > s)
-        {
-            found = true;
-            it = secs.begin() + i;
-            break;
-        }
-    }
-    if (!found)
+    // first laneSection of the lane drop
+    int i = secs.size() - 2;
+    if (i < 0 || secs[i].s != s)
     {
-        it = secs.begin() + secs.size() - 1;
-        i = secs.size() - 1;
+        cerr << "ERR: restricted area is not at a lane drop." << endl;
+        return 1;
     }
 
-    laneSection adLaneSec = *it;
+    laneSection adLaneSec = secs[i];
 
     int laneId = 0;
     if (side > 0)
@@ -513,8 +417,8 @@ int addRestrictedAreaDrop(vector<laneSection> &secs, int side, double s, double
     l.type = "restricted";
     adLaneSec.lanes[id] = l;
 
-    it++;
-    secs.insert(it, adLaneSec);
+    // the restricted area replaces the second laneSection of the lane drop
+    secs[i + 1] = adLaneSec;
 
     // --- Section 3 -----------------------------------------
     adLaneSec.id++;
@@ -544,27 +448,27 @@ int addRestrictedAreaDrop(vector<laneSection> &secs, int side, double s, double
     id = findLane(adLaneSec, l, 0);
     adLaneSec.lanes[id].rm.type = "broken";
 
-    it++;
-    it = secs.insert(it, adLaneSec);
-
-    it++;
-    secs.erase(it);
+    secs.push_back(adLaneSec);
 
     return 0;
 }
 
 /**
- * @brief function creates laneWidenings in junction areas (in opposite s direction), for additional turning lanes 
+ * @brief function creates laneWidenings in junction areas (in opposite s direction), for additional turning lanes.
+ *  The two laneSections of the widening are put in front of the first laneSection of the road by the caller, 
+ *  they start at s = 0 and the first laneSection starts at s + ds
  * 
- * @param r                 road data
+ * @param first             first laneSection of the road, its lane links are adjusted to the widening
  * @param s                 start of widening
  * @param ds                 length of widening
  * @param turn              1 = left lane turn, -1 = right lane turn
  * @param verschwenkung     determines if a 'verschwenkung' exists
  * @param restricted        determines if widening is a restricted area
+ * @param opening           laneSection from s = 0 to s with the additional lane
+ * @param widening          laneSection from s to s + ds in which the additional lane closes
  * @return int              error code
  */
-int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenkung, bool restricted)
+int laneWideningJunction(laneSection &first, double s, double ds, int turn, bool verschwenkung, bool restricted, laneSection &opening, laneSection &widening)
 {
     /*
         s > 0 -> laneWidening
@@ -581,9 +485,7 @@ int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenk
     if (restricted)
         turn = 1;
 
-    vector<laneSection>::iterator it = r.laneSections.begin();
-
-    laneSection adLaneSec = *it;
+    laneSection adLaneSec = first;
     adLaneSec.s = 0;
     adLaneSec.id = 1;
 
@@ -593,15 +495,15 @@ int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenk
 
     if (turn == 1)
     {
-        laneId = findLeftLane(*it, 1);
+        laneId = findLeftLane(first, 1);
         if (laneId == 0)
-            laneId = findInnerMiddleLane(*it, 1);
+            laneId = findInnerMiddleLane(first, 1);
     }
     if (turn == -1)
     {
-        laneId = findRightLane(*it, 1);
+        laneId = findRightLane(first, 1);
         if (laneId == 0)
-            laneId = findOuterMiddleLane(*it, 1);
+            laneId = findOuterMiddleLane(first, 1);
     }
 
     int id = findLane(adLaneSec, l, laneId);
@@ -655,7 +557,7 @@ int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenk
 
     // laneOffset
     if (turn == 1 && verschwenkung)
-        adLaneSec.o.a = -abs(w) / 2 + it->o.a;
+        adLaneSec.o.a = -abs(w) / 2 + first.o.a;
 
     // update lane links
     for (int i = 0; i < adLaneSec.lanes.size(); i++)
@@ -664,9 +566,7 @@ int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenk
         adLaneSec.lanes[i].sucId = adLaneSec.lanes[i].id;
     }
 
-    // insert lane section
-    it = r.laneSections.insert(it, adLaneSec);
-    it++;
+    opening = adLaneSec;
 
     // ---------------------------------------------------------------------
     // widening lane
@@ -694,7 +594,7 @@ int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenk
 
     if (turn == 1 && verschwenkung)
     {
-        adLaneSec.o.a = -abs(w) / 2 + it->o.a;
+        adLaneSec.o.a = -abs(w) / 2 + first.o.a;
         adLaneSec.o.b = 0;
         adLaneSec.o.c = 3 * abs(w) / 2 / pow(ds, 2);
         adLaneSec.o.d = -2 * abs(w) / 2 / pow(ds, 3);
@@ -712,7 +612,7 @@ int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenk
         adLaneSec.lanes[i].preId = id;
 
         lane tmpLane;
-        int idL = findLane(*it, tmpLane, id);
+        int idL = findLane(first, tmpLane, id);
 
         if (sgn(id) == sgn(laneId))
         {
@@ -720,13 +620,13 @@ int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenk
             {
                 adLaneSec.lanes[i].sucId = id - sgn(id);
                 if (idL != -1)
-                    it->lanes[idL].preId = id + sgn(id);
+                    first.lanes[idL].preId = id + sgn(id);
             }
             if (turn == -1)
             {
                 adLaneSec.lanes[i].sucId = id;
                 if (idL != -1)
-                    it->lanes[idL].preId = id;
+                    first.lanes[idL].preId = id;
             }
             if (turn == -1 && id == laneId)
             {
@@ -736,19 +636,11 @@ int laneWideningJunction(road &r, double s, double ds, int turn, bool verschwenk
         else
         {
             adLaneSec.lanes[i].sucId = id;
-            it->lanes[idL].preId = id;
+            first.lanes[idL].preId = id;
         }
     }
 
-    // update lane links in next lane section
-    it = r.laneSections.insert(it, adLaneSec);
-    it++;
+    widening = adLaneSec;
 
-    // --- shift all lanes in following lane sections --------------------------
-    for (; it != r.laneSections.end(); ++it)
-    {
-        it->id += 2;
-        it->s += s + ds;
-    }
     return 0;
 }
\ No newline at end of file
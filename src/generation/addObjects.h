@@ -16,13 +16,14 @@
  */
 
 /**
- * @brief function adds a traffic island to the lane structure
+ * @brief function appends the lane sections of a traffic island to the lane structure.
+ *  The traffic island starts in the last lane section of the road
  * 
  * @param o         object data
  * @param r         road data
  * @return int      error code
  */
-int addTrafficIsland(object o, road &r)
+int addTrafficIsland(const object &o, road &r)
 {
     /*  design of a trafficIsland
      *          __________
@@ -32,17 +33,13 @@ int addTrafficIsland(object o, road &r)
      *         \__________/
      */
 
-    r.objects.push_back(o);
-
-    // find laneSection
-    int i;
-    laneSection lS;
-    for (i = r.laneSections.size() - 1; i >= 0; i--)
-        if (r.laneSections[i].s < o.s)
-        {
-            lS = r.laneSections[i];
-            break;
-        }
+    if (r.laneSections.back().s >= o.s)
+    {
+        cerr << "ERR: trafficIsland is not on the road." << endl;
+        return 1;
+    }
+    const laneSection lS = r.laneSections.back();
+    laneSection parts[4];
 
     lane l;
     findLane(lS, l, 1);
@@ -53,7 +50,7 @@ int addTrafficIsland(object o, road &r)
     laneSection sec;
 
     // --- part 1 (opening)
-    sec = r.laneSections[i];
+    sec = lS;
     sec.s = o.s - o.length;
 
     l.w.d = -2 * w / pow(ds, 3);
@@ -71,10 +68,10 @@ int addTrafficIsland(object o, road &r)
     l.id = -1;
     sec.lanes.push_back(l);
 
-    r.laneSections.push_back(sec);
+    parts[0] = sec;
 
     // --- part 2 (straight)
-    sec = r.laneSections[i];
+    sec = lS;
     sec.s = o.s - o.length / 2;
 
     l.w.d = 0;
@@ -92,10 +89,10 @@ int addTrafficIsland(object o, road &r)
     l.id = -1;
     sec.lanes.push_back(l);
 
-    r.laneSections.push_back(sec);
+    parts[1] = sec;
 
     // --- part 3 (closing)
-    sec = r.laneSections[i];
+    sec = lS;
     sec.s = o.s + o.length / 2;
 
     l.w.d = 2 * w / pow(ds, 3);
@@ -113,120 +110,89 @@ int addTrafficIsland(object o, road &r)
     l.id = -1;
     sec.lanes.push_back(l);
 
-    r.laneSections.push_back(sec);
+    parts[2] = sec;
 
     // --- part 4 (after trafficIsland)
-    sec = r.laneSections[i];
+    sec = lS;
     sec.s = o.s + o.length;
 
-    r.laneSections.push_back(sec);
+    parts[3] = sec;
+
+    for (const laneSection &part : parts)
+        r.laneSections.push_back(part);
 
     return 0;
 }
 
 /**
- * @brief function generates a roadwork
+ * @brief function generates a roadwork. The roadwork starts in the last lane section of the road
  * 
  * @param o         object containing length and position of roadwork   
  * @param r         road which contains the roadwork
  * @param laneId    lane which contains the roadwork
  * @return int      error code
  */
-int addRoadWork(object o, road &r, int laneId)
+int addRoadWork(const object &o, road &r, int laneId)
 {
-    std::vector<laneSection>::iterator it;
+    laneSection adLaneSec = r.laneSections.back();
+    adLaneSec.id++;
+    adLaneSec.s = o.s;
 
-    // find lane section of starting point
-    int i = 0;
-    bool found = false;
-    for (i = 0; i < r.laneSections.size() - 1; i++)
-    {
-        if (r.laneSections[i].s <= o.s && r.laneSections[i + 1].s > o.s)
-        {
-            found = true;
-            it = r.laneSections.begin() + i;
-            break;
-        }
-    }
-    if (!found)
+    lane l;
+    int id = findLane(adLaneSec, l, laneId);
+    if (id == -1)
     {
-        it = r.laneSections.begin() + r.laneSections.size() - 1;
-        i = r.laneSections.size() - 1;
+        cerr << "ERR: lane of roadwork does not exist." << endl;
+        return 1;
     }
 
-    // if laneSection does not end before end of roadwork
-    if (i == r.laneSections.size() - 1 || r.laneSections[i + 1].s - it->s > o.len)
-    {
-        laneSection adLaneSec = *it;
-        adLaneSec.id++;
-        adLaneSec.s = o.s;
-
-        it++;
-        i++;
-        r.laneSections.insert(it, adLaneSec);
-
-        lane l;
-        int id = findLane(r.laneSections[i], l, laneId);
-        r.laneSections[i].lanes[id].type = "roadWorks";
+    r.laneSections.push_back(adLaneSec);
+    r.laneSections.back().lanes[id].type = "roadWorks";
 
-        adLaneSec.id++;
-        adLaneSec.s += o.len;
+    // the section behind the roadwork has the lanes of the section in front of it
+    adLaneSec.id++;
+    adLaneSec.s += o.len;
+    r.laneSections.push_back(adLaneSec);
 
-        it++;
-        i++;
-        r.laneSections.insert(it, adLaneSec);
-    }
-    else
-    {
-        cerr << "ERR: Length of roadwork is longer than  laneSection." << endl;
-        return 1;
-    }
-
-    // shift remaining sections
-    i++;
-    for (; i < r.laneSections.size(); i++)
-    {
-        r.laneSections[i].id++;
-    }
     return 0;
 }
 
 /**
- * @brief function adds parking splot objects
+ * @brief function places a parking spot object next to the outer lane of the road
  * 
- * @param o         object data
+ * @param p         object data
  * @param r         road data
  * @return int      error code
  */
-int addParking(object o, road &r)
+int addParking(object &p, const road &r)
 {
     // find laneSection
     int i;
     for (i = r.laneSections.size() - 1; i >= 0; i--)
-        if (r.laneSections[i].s < o.s)
+        if (r.laneSections[i].s < p.s)
             break;
 
-    laneSection lS = r.laneSections[i];
+    const laneSection &lS = r.laneSections[i];
 
     int laneId;
-    if (o.t > 0)
+    if (p.t > 0)
         laneId = findMaxLaneId(lS);
-    if (o.t < 0)
+    if (p.t < 0)
         laneId = findMinLaneId(lS);
-    double t = findTOffset(lS, laneId, o.s);
-    fixAngle(o.hdg);
+    double t = findTOffset(lS, laneId, p.s);
 
-    if (abs(o.hdg) > M_PI / 4)
+    fixAngle(p.hdg);
+
+    if (abs(p.hdg) > M_PI / 4)
     {
-        o.t = t + sgn(laneId) * abs(o.length / (2 * sin(o.hdg)));
-        o.distance = abs(o.width / sin(o.hdg));
+        p.t = t + sgn(laneId) * abs(p.length / (2 * sin(p.hdg)));
+        p.distance = abs(p.width / sin(p.hdg));
     }
-    if (abs(o.hdg) < M_PI / 4)
+    if (abs(p.hdg) < M_PI / 4)
     {
-        o.t = t + sgn(laneId) * abs(o.width / (2 * cos(o.hdg)));
-        o.distance = abs(o.length / cos(o.hdg));
+        p.t = t + sgn(laneId) * abs(p.width / (2 * cos(p.hdg)));
+        p.distance = abs(p.length / cos(p.hdg));
     }
-    r.objects.push_back(o);
 
     return 0;
 }
@@ -234,19 +200,12 @@ int addParking(object o, road &r)
 /**
  * @brief function adds a bus top
  * 
- * @param o     objct data
- * @param r     road data
- * @return int  error code
+ * @param o         objct data
+ * @param changes   lane changes of the road
+ * @return int      error code
  */
-int addBusStop(object o, road &r)
+int addBusStop(const object &o, laneChangeBuilder &changes)
 {
-    // find starting laneSection
-    int i;
-    for (i = r.laneSections.size() - 1; i >= 0; i--)
-        if (r.laneSections[i].s < o.s)
-            break;
-    laneSection lS = r.laneSections[i];
-
     int side;
     if (o.t > 0)
         side = 1;
@@ -256,16 +215,8 @@ int addBusStop(object o, road &r)
     double length = setting.busStop.length;
     double widening = setting.busStop.widening;
 
-    if (addLaneWidening(r.laneSections, side, o.s - length / 2 - widening, widening, true))
-        {
-            cerr << "ERR: error in addLaneWidening" << endl;
-            return 1;
-        }
-    if (addLaneDrop(r.laneSections, side, o.s + length / 2, widening))
-    {
-        cerr << "ERR: error in addLaneDrop" << endl;
-        return 1;
-    }
+    changes.addLaneWidening(side, o.s - length / 2 - widening, widening, true);
+    changes.addLaneDrop(side, o.s + length / 2, widening);
 
     return 0;
 }
@@ -302,15 +253,18 @@ int getPosition(DOMElement* node, object &o)
 }
 
 /**
- * @brief function creates objects
+ * @brief function creates objects. The lane changes of the objects are applied together with the lane changes of the road
  * 
  * @param inRoad    road input data from input file
  * @param r         road data 
  * @param data      roadNetwork structure where the generated roads and junctions are stored
+ * @param changes   lane changes of the road which are not applied yet
  * @return int      error code
  */
-int addObjects(DOMElement* inRoad, road &r, roadNetwork &data)
+int addObjects(DOMElement* inRoad, road &r, roadNetwork &data, laneChangeBuilder &changes)
 {
+    // parking spaces are placed after the lane changes, since they depend on the outer lanes
+    vector<int> parkingSpaces;
 
     DOMNodeList* objects = inRoad->getElementsByTagName(X("objects"));
     for (int i = 0; i < objects->getLength(); i++)
@@ -334,7 +288,8 @@ int addObjects(DOMElement* inRoad, road &r, roadNetwork &data)
             o.width = readDoubleAttrFromNode(obj, "width");
             o.height = 4;
 
-            addParking(o, r);
+            r.objects.push_back(o);
+            parkingSpaces.push_back(r.objects.size() - 1);
         }
 
         if (type == "streetLamp")
@@ -350,12 +305,12 @@ int addObjects(DOMElement* inRoad, road &r, roadNetwork &data)
             o.len = readDoubleAttrFromNode(obj, "length");
             int laneId = readIntAttrFromNode(obj, "laneId");
 
-            addRoadWork(o, r, laneId);
+            changes.addRoadWork(o, laneId);
         }
 
         if (type == "busStop")
         {
-            addBusStop(o, r);
+            addBusStop(o, changes);
         }
 
         if (type == "trafficIsland")
@@ -366,7 +321,8 @@ int addObjects(DOMElement* inRoad, road &r, roadNetwork &data)
             o.length = readDoubleAttrFromNode(obj, "length");
             o.width = readDoubleAttrFromNode(obj, "width");
 
-            addTrafficIsland(o, r);
+            r.objects.push_back(o);
+            changes.addTrafficIsland(o);
         }
 
         //--- Traffic Rule -----------------------------------------------------
@@ -396,6 +352,16 @@ int addObjects(DOMElement* inRoad, road &r, roadNetwork &data)
         }
         data.controller.push_back(c);
     }
+
+    if (changes.build(r))
+    {
+        cerr << "ERR: error in lane changes" << endl;
+        return 1;
+    }
+
+    for (int i : parkingSpaces)
+        addParking(r.objects[i], r);
+
     return 0;
 }
 
@@ -17,47 +17,36 @@
 
 #include "../utils/curve.h"
 #include "addLaneSections.h"
+#include "laneChangeBuilder.h"
+#include "roadCache.h"
 
 extern settings setting;
 
 /**
  * @brief function computes first and last considered geometry in s interval 
  * 
- * @param roadIn        road input data
+ * @param t             parsed road input data
  * @param foundfirst    id of the first considerd geometry
  * @param foundlast     id of the last considerd geometry
  * @param sStart        start of the s interval
  * @param sEnd          end of the s interval
  * @return int          error code
  */
-int computeFirstLast(DOMElement* roadIn, int &foundfirst, int &foundlast, double &sStart, double &sEnd)
+int computeFirstLast(const roadTemplate &t, int &foundfirst, int &foundlast, double &sStart, double &sEnd)
 {
     int cc = 0;
     double s = 0;
 
-    if (roadIn != NULL) {
-        DOMNodeList* referenceLines = getChildWithName(roadIn, "referenceLine")->getChildNodes();
-
-        for (int i = 0; i < referenceLines->getLength(); i++)
-        {
-            DOMElement* it = (DOMElement*)referenceLines->item(i);
-            if(it->getNodeType() != 1) //1 is an Element Node https://xerces.apache.org/xerces-c/apiDocs-3/classDOMNode.html
-            {
-                continue;
-            }
-
-            double length = readDoubleAttrFromNode(it, "length");
-
-            if (s + length > sStart && foundfirst == -1)
-                foundfirst = cc;
-
-            if (s + length >= sEnd && foundlast == -1)
-                foundlast = cc;
+    for (const geometry &g : t.geometries)
+    {
+        if (s + g.length > sStart && foundfirst == -1)
+            foundfirst = cc;
 
-            cc++;
-            s += length;
+        if (s + g.length >= sEnd && foundlast == -1)
+            foundlast = cc;
 
-        }
+        cc++;
+        s += g.length;
     }
 
     // set sEnd to last containing s value if it's set to inf
@@ -71,99 +60,37 @@ int computeFirstLast(DOMElement* roadIn, int &foundfirst, int &foundlast, double
 }
 
 /**
- * @brief function genetares the geometries of the reference line based on an s intervall
+ * @brief function cuts the geometries of the reference line from a parsed road template based on an s intervall
  * 
- * @param roadIn    road input data
+ * @param t         parsed road input data
  * @param r         road data containing the reference line information
  * @param sStart    start of the s interval
  * @param sEnd      end of the s interval
  * @return int      error code
  */
-int generateGeometries(DOMElement* roadIn, road &r, double &sStart, double &sEnd)
+int cutGeometries(const roadTemplate &t, road &r, double &sStart, double &sEnd)
 {
     // search first and last relevant geometry
     int foundfirst = -1;
     int foundlast = -1;
-    computeFirstLast(roadIn, foundfirst, foundlast, sStart, sEnd);
+    computeFirstLast(t, foundfirst, foundlast, sStart, sEnd);
 
-    // start values (starting point at origin)
-    int cc = 0;
     r.length = 0;
 
-    double s = 0;
-    double x = 0;
-    double y = 0;
-    double hdg = 0;
-
-    if(roadIn == NULL) return 0;
-
-    DOMNodeList* referenceLines =  getChildWithName(roadIn, "referenceLine")->getChildNodes();
-    for (int i = 0; i < referenceLines->getLength(); i++)
+    for (int cc = 0; cc < (int)t.geometries.size(); cc++)
     {
-        DOMElement* it = (DOMElement*)referenceLines->item(i);
-        if(it->getNodeType() != 1) continue;
-        
-        geometryType type;
-        double c = 0, c1 = 0, c2 = 0;
-        double R = 0, R1 = 0, R2 = 0;
-
-        // define type
-        if (readNameFromNode(it) == "line")
-            type = line;
-        if (readNameFromNode(it) == "spiral")
-            type = spiral;
-        if (readNameFromNode(it) == "arc")
-            type = arc;
-        if (readNameFromNode(it) == "circle")
-            type = arc;
-
-        double length = readDoubleAttrFromNode(it, "length");
-
-        // define radi and curvatures
-        if (type == spiral)
-        {
-            R1 = readDoubleAttrFromNode(it, "Rs");
-            R2 = readDoubleAttrFromNode(it, "Re");
-            if (R1 != 0)
-                c1 = 1 / R1;
-            if (R2 != 0)
-                c2 = 1 / R2;
-        }
-        if (type == arc)
-        {
-            R = readDoubleAttrFromNode(it, "R");
-            if (R != 0)
-                c = 1 / R;
-        }
-
-        // create new geometry struct
-        geometry geo;
-        geo.s = s;
-        geo.x = x;
-        geo.y = y;
-        geo.hdg = hdg;
-        geo.length = length;
-        geo.c = c;
-        geo.c1 = c1;
-        geo.c2 = c2;
-        geo.type = type;
-
-        // actual length can vary if a cut has to be perfomed
-        double actuallength = length;
-
         if (cc < foundfirst)
-        {
-            // calculate new position and increase s but do not save this
-            curve(length, geo, x, y, hdg, 1);
-            s += length;
-            cc++;
             continue;
-        }
         if (cc > foundlast)
-        {
-            // do nothing and break the loop at the end
             break;
-        }
+
+        // start pose, s and length of the uncut geometry
+        geometry geo = t.geometries[cc];
+        double s = geo.s;
+        double length = geo.length;
+
+        // actual length can vary if a cut has to be perfomed
+        double actuallength = length;
 
         // --- different cases has to be observed: |---| is the current geometry
 
@@ -175,9 +102,6 @@ int generateGeometries(DOMElement* roadIn, road &r, double &sStart, double &sEnd
             // reset s to zero
             geo.s = 0;
 
-            // normal calculation of full length
-            curve(length, geo, x, y, hdg, 1);
-
             // calculate new start point of geometry
             curve(sStart - s, geo, geo.x, geo.y, geo.hdg, 1);
 
@@ -192,7 +116,6 @@ int generateGeometries(DOMElement* roadIn, road &r, double &sStart, double &sEnd
         if (cc != foundfirst && cc == foundlast)
         {
             actuallength = sEnd - s;
-            curve(actuallength, geo, x, y, hdg, 1);
 
             // update second curvature
             geo.c2 = geo.c1 + (actuallength) * (geo.c2 - geo.c1) / length;
@@ -227,21 +150,43 @@ int generateGeometries(DOMElement* roadIn, road &r, double &sStart, double &sEnd
         if (cc != foundfirst && cc != foundlast)
         {
             geo.s -= sStart;//s values start at 0 after the cut. Therefore we need to substract the offset
-            curve(length, geo, x, y, hdg, 1);
         }
 
         // update road
         fixAngle(geo.hdg);
         r.length += actuallength;
         r.geometries.push_back(geo);
-
-        // increase variables
-        s += length;
-        cc++;
     }
     return 0;
 }
 
+/**
+ * @brief function genetares the geometries of the reference line based on an s intervall
+ *      the geometries are cut from the cached reference line of the input element
+ * 
+ * @param roadIn    road input data
+ * @param r         road data containing the reference line information
+ * @param sStart    start of the s interval
+ * @param sEnd      end of the s interval
+ * @return int      error code
+ */
+int generateGeometries(DOMElement* roadIn, road &r, double &sStart, double &sEnd)
+{
+    const roadTemplate &t = roadCache().get(roadIn);
+
+    if (roadIn == NULL)
+    {
+        // keep the interval update of the empty template
+        int foundfirst = -1;
+        int foundlast = -1;
+        computeFirstLast(t, foundfirst, foundlast, sStart, sEnd);
+        r.length = 0;
+        return 0;
+    }
+
+    return cutGeometries(t, r, sStart, sEnd);
+}
+
 /**
  * @brief function shift the geometries of the reference line
  * 
@@ -318,22 +263,25 @@ int shiftGeometries(road &r, double sStart, double sEnd, double s0, double x0, d
         dphi = phi0 - hdg + M_PI;
     }
 
-    // shift x,y,phi according to x0, y0, phi0
-    for (int i = 0; i < r.geometries.size(); i++)
+    // shift x,y,phi according to x0, y0, phi0 (column wise, so that the loop can be vectorized)
+    referenceLine &ref = r.geometries;
+    int n = ref.size();
+    double cosPhi = cos(dphi);
+    double sinPhi = sin(dphi);
+
+    for (int i = 0; i < n; i++)
     {
         // shift in origin
-        double xtemp = r.geometries[i].x - x;
-        double ytemp = r.geometries[i].y - y;
+        double xtemp = ref.x[i] - x;
+        double ytemp = ref.y[i] - y;
 
-        // rotate with dphi
-        r.geometries[i].hdg += dphi;
-        r.geometries[i].x = xtemp * cos(dphi) - ytemp * sin(dphi);
-        r.geometries[i].y = xtemp * sin(dphi) + ytemp * cos(dphi);
-
-        // shift back with x0, y0
-        r.geometries[i].x += x0;
-        r.geometries[i].y += y0;
+        // rotate with dphi and shift back with x0, y0
+        ref.x[i] = xtemp * cosPhi - ytemp * sinPhi + x0;
+        ref.y[i] = xtemp * sinPhi + ytemp * cosPhi + y0;
     }
+    for (int i = 0; i < n; i++)
+        ref.hdg[i] += dphi;
+
     return 0;
 }
 
@@ -345,65 +293,69 @@ int shiftGeometries(road &r, double sStart, double sEnd, double s0, double x0, d
  */
 int flipGeometries(road &r)
 {
-    road rNew = r;
-    rNew.geometries.clear();
+    referenceLine &ref = r.geometries;
+    int n = ref.size();
 
-    for (int i = r.geometries.size() - 1; i >= 0; i--)
+    // the end point of each geometry becomes its start point
+    for (int i = 0; i < n; i++)
     {
-        geometry g = r.geometries[i];
-
-        curve(g.length, g, g.x, g.y, g.hdg, 1);
-
-        // flip angles and curvature
-        g.hdg += M_PI;
-        fixAngle(g.hdg);
-
-        //flip s
-        g.s = r.length - g.length - g.s;
+        geometry g = ref[i];
+        curve(g.length, g, ref.x[i], ref.y[i], ref.hdg[i], 1);
+    }
 
-        double c1 = g.c1;
-        double c2 = g.c2;
-        if (g.type == arc)
-            g.c *= -1;
-        if (g.type == spiral)
-        {
-            g.c1 = -c2;
-            g.c2 = -c1;
-        }
-        rNew.geometries.push_back(g);
+    // flip angles and s
+    for (int i = 0; i < n; i++)
+    {
+        ref.hdg[i] += M_PI;
+        fixAngle(ref.hdg[i]);
+        ref.s[i] = r.length - ref.length[i] - ref.s[i];
     }
-    r.geometries.clear();
-    r.geometries = rNew.geometries;
+
+    // flip curvatures: arcs change their sign, spirals additionally swap start and end curvature.
+    // Reversing the whole curvature column reverses the order of the geometries and swaps c1 and c2 at once
+    for (double &c : ref.curvature)
+        c = -c;
+    std::reverse(ref.curvature.begin(), ref.curvature.end());
+
+    // reverse order of geometries
+    std::reverse(ref.type.begin(), ref.type.end());
+    std::reverse(ref.s.begin(), ref.s.end());
+    std::reverse(ref.x.begin(), ref.x.end());
+    std::reverse(ref.y.begin(), ref.y.end());
+    std::reverse(ref.hdg.begin(), ref.hdg.end());
+    std::reverse(ref.length.begin(), ref.length.end());
+    ref.updateCurvatureIndex();
 
     return 0;
 }
 
 /**
- * @brief function adds lanes to the road structure
+ * @brief function reads the basic lane section of a road
  * 
- * @param roadIn    road input data
- * @param r         road data
- * @param mode      defines the mode (flipped or not)
- * @return int      error code
+ * @param roadIn            road input data
+ * @param classification    classification of the road
+ * @param mode              defines the mode (flipped or not)
+ * @param laneSec           basic lane section
+ * @return int              error code
  */
-int addLanes(DOMElement* roadIn, road &r, int mode)
+int readLanes(DOMElement* roadIn, const string &classification, int mode, laneSection &laneSec)
 {
     double desWidth = setting.width.standard;
     double desSpeed = setting.speed.standard;
 
-    if (r.classification == "main")
+    if (classification == "main")
     {
         desWidth = setting.width.main;
         desSpeed = setting.speed.main;
     }
-    else if (r.classification == "access")
+    else if (classification == "access")
     {
         desWidth = setting.width.access;
         desSpeed = setting.speed.access;
     }
 
     // --- add basic laneSection to road ---------------------------------------
-    laneSection laneSec;
+    laneSec = laneSection();
     laneSec.id = 1;
     laneSec.s = 0;
 
@@ -430,8 +382,6 @@ int addLanes(DOMElement* roadIn, road &r, int mode)
     l3.sucId = -1;
     laneSec.lanes.push_back(l3);
 
-    r.laneSections.push_back(laneSec);
-
     // --- add user defined laneSection to road --------------------------------
     if (roadIn != NULL)
     {
@@ -503,23 +453,55 @@ int addLanes(DOMElement* roadIn, road &r, int mode)
             }
         }
     }
-    r.laneSections.front() = laneSec;
 
     return 0;
 }
 
 /**
- * @brief function adds additional lane sections for changing lane structure
+ * @brief function adds lanes to the road structure
+ *      the lanes of an input element are only read once per mode
+ * 
+ * @param roadIn    road input data
+ * @param r         road data
+ * @param mode      defines the mode (flipped or not)
+ * @return int      error code
+ */
+int addLanes(DOMElement* roadIn, road &r, int mode)
+{
+    if (roadIn == NULL)
+    {
+        laneSection laneSec;
+        readLanes(roadIn, r.classification, mode, laneSec);
+        r.laneSections.push_back(laneSec);
+        return 0;
+    }
+
+    roadTemplate &t = roadCache().get(roadIn);
+    if (!t.lanesParsed[mode - 1])
+    {
+        if (readLanes(roadIn, r.classification, mode, t.lanes[mode - 1]))
+            return 1;
+        t.lanesParsed[mode - 1] = true;
+    }
+    r.laneSections.push_back(t.lanes[mode - 1]);
+
+    return 0;
+}
+
+/**
+ * @brief function collects the lane changes of a road, which create additional lane sections for changing lane structure
  *  
  * @param roadIn                road input data
  * @param r                     road data
  * @param automaticWidening     automatic widing input data
+ * @param restrictedWidening    if true, the automatic widening is a restricted area, independent of the input data
+ * @param changes               lane changes of the road
  * @return int                  error code
  */
-int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWidening)
+int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWidening, bool restrictedWidening, laneChangeBuilder &changes)
 {
     // --- user defined lanedrops or lanewidenings -----------------------------
-    //      -> have to be defined in increasing s order, because the lane changes are concatenated in s direction
+    //      -> the lane changes are collected and applied in increasing s order, because they are concatenated in s direction
 
     if(roadIn == NULL) return 0; //leave if the road is null. might cause errros 
 
@@ -554,11 +536,7 @@ int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWide
                 if (s > r.length)
                     continue;
 
-                if (addLaneWidening(r.laneSections, side, s, ds, false))
-                {
-                    cerr << "ERR: error in addLaneWidening";
-                    return 1;
-                }
+                changes.addLaneWidening(side, s, ds, false);
 
                 //restricted area
                 if (getChildWithName(itt, "restrictedArea") != NULL)
@@ -567,11 +545,7 @@ int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWide
                     if (attributeExits(getChildWithName(itt, "restrictedArea"),"length"))
                         ds2 = readIntAttrFromNode(getChildWithName(itt, "restrictedArea"),"length");
 
-                    if (addRestrictedAreaWidening(r.laneSections, side, s, ds, ds2))
-                    {
-                        cerr << "ERR: error in addRestrictedAreaWidening" << endl;
-                        return 1;
-                    }
+                    changes.addRestrictedAreaWidening(side, s, ds, ds2);
                 }
             }
             if (readNameFromNode(itt) == "laneDrop")
@@ -594,11 +568,7 @@ int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWide
                 if (s > r.length)
                     continue;
 
-                if (addLaneDrop(r.laneSections, side, s, ds))
-                {
-                    cerr << "ERR: error in addLaneDrop";
-                    return 1;
-                }
+                changes.addLaneDrop(side, s, ds);
 
                 //restricted area
                 if (getChildWithName(itt, "restrictedArea") != NULL)
@@ -607,11 +577,7 @@ int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWide
                     if (attributeExits(getChildWithName(itt, "restrictedArea"),"length"))
                         ds2 = readIntAttrFromNode(getChildWithName(itt, "restrictedArea"),"length");
 
-                    if (addRestrictedAreaDrop(r.laneSections, side, s, ds, ds2))
-                    {
-                        cerr << "ERR: error in addRestrictedAreaDrop";
-                        return 1;
-                    }
+                    changes.addRestrictedAreaDrop(side, s, ds, ds2);
                 }
             }
         }
@@ -636,36 +602,14 @@ int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWide
                 widening_ds = readDoubleAttrFromNode(automaticWidening, "ds");
         }
 
-        bool restricted = false;
+        bool restricted = restrictedWidening;
         if (readBoolAttrFromNode(automaticWidening, "restricted"))
             restricted = true;
 
-        if (active == "all")
-        {
-            if (laneWideningJunction(r, widening_s, widening_ds, 1, true, restricted))
-            {
-                cerr << "ERR: error in laneWideningJunction";
-                return 1;
-            }
-        }
-        else if (active == "main" && r.classification == "main")
-        {
-
-            if (laneWideningJunction(r, widening_s, widening_ds, 1, true, restricted))
-            {
-                cerr << "ERR: error in laneWideningJunction";
-                return 1;
-            }
-        }
-        else if (active == "access" && r.classification == "access")
-        {
-            if (laneWideningJunction(r, widening_s, widening_ds, 1, true, restricted))
-            {
-                cerr << "ERR: error in laneWideningJunction";
-                return 1;
-            }
-        }
+        if (active == "all" || (active == "main" && r.classification == "main") || (active == "access" && r.classification == "access"))
+            changes.addJunctionWidening(widening_s, widening_ds, 1, true, restricted);
     }
+
     return 0;
 }
 
@@ -681,11 +625,31 @@ int addLaneSectionChanges(DOMElement* roadIn, road &r, DOMElement* automaticWide
  * @param x0                reference x position
  * @param y0                reference y position
  * @param phi0              reference angle
+ * @param restrictedWidening if true, the automatic widening is a restricted area, independent of the input data
+ * @param changes           if given, the lane changes of the road are only added to it and applied by the caller together 
+ *                          with its own lane changes; otherwise they are applied here
  * @return int              error code
  */
-int buildRoad(DOMElement* roadIn, road &r, double sStart, double sEnd, DOMElement* automaticWidening, double s0, double x0, double y0, double phi0)
+int buildRoad(DOMElement* roadIn, road &r, double sStart, double sEnd, DOMElement* automaticWidening, double s0, double x0, double y0, double phi0, bool restrictedWidening = false, laneChangeBuilder *changes = NULL)
 {
-    
+    // full untransformed builds (helper roads of junctions and roundabouts) are done once per input element
+    roadTemplate *t = NULL;
+    if (roadIn != NULL && automaticWidening == NULL && changes == NULL && sStart == 0 && sEnd == INFINITY && s0 == 0 && x0 == 0 && y0 == 0 && phi0 == 0
+        && r.geometries.empty() && r.laneSections.empty())
+    {
+        t = &roadCache().get(roadIn);
+        if (t->fullBuilt)
+        {
+            r.classification = t->full.classification;
+            r.inputId = t->full.inputId;
+            r.inputPos = t->full.inputPos;
+            r.length = t->full.length;
+            r.geometries = t->full.geometries;
+            r.laneSections = t->full.laneSections;
+            return 0;
+        }
+    }
+
     if(roadIn != NULL)
         r.classification = readStrAttrFromNode(roadIn,"classification");
     r.inputId = readIntAttrFromNode(roadIn, "id", true);
@@ -741,11 +705,28 @@ int buildRoad(DOMElement* roadIn, road &r, double sStart, double sEnd, DOMElemen
     }
 
     // // add lane section changes
-    if (addLaneSectionChanges(roadIn, r, automaticWidening))
+    laneChangeBuilder roadChanges;
+    if (addLaneSectionChanges(roadIn, r, automaticWidening, restrictedWidening, (changes != NULL) ? *changes : roadChanges))
     {
         cerr << "ERR: error in addLaneSectionChanges";
         return 1;
     }
+    if (roadChanges.build(r))
+    {
+        cerr << "ERR: error in lane changes";
+        return 1;
+    }
+
+    if (t != NULL)
+    {
+        t->full.classification = r.classification;
+        t->full.inputId = r.inputId;
+        t->full.inputPos = r.inputPos;
+        t->full.length = r.length;
+        t->full.geometries = r.geometries;
+        t->full.laneSections = r.laneSections;
+        t->fullBuilt = true;
+    }
 
     return 0;
 }
@@ -19,6 +19,7 @@
 #include "addObjects.h"
 #include "createLaneConnection.h"
 #include "createRoadConnection.h"
+#include "junctionCache.h"
 
 #define non "none"
 #define bro "broken"
@@ -29,6 +30,61 @@
 #include "connectingRoad.h"
 
 extern settings setting;
+
+/**
+ * @brief function reserves the id blocks of all segments before any road is generated, so that the naming schemes
+ *      of the segments take precedence over the overflow ids. Junctions and connecting roads own the block of their id,
+ *      the blocks of roundabout junctions and closing roads are claimed during generation but kept free from overflow ids.
+ *
+ * @param rootNode 	root node of the input file
+ * @param data 		roadNetwork data
+ * @return int 		error code
+ */
+int reserveSegmentIds(const DOMElement* rootNode, roadNetwork &data)
+{
+	data.ids = idAllocator();
+
+	DOMElement *roadNode = getChildWithName(rootNode, "segments");
+	if (roadNode == NULL)
+		return 1;
+
+	int nSegments = 0;
+	int lastBlock = 0;
+	for(DOMElement* em = roadNode->getFirstElementChild(); em != NULL ;em = em->getNextElementSibling())
+	{
+		int id = readIntAttrFromNode(em, "id");
+		nSegments++;
+
+		// roundabout junctions use the blocks 100 * id + k
+		if (readNameFromNode(em) == "roundabout")
+		{
+			lastBlock = max(lastBlock, idAllocator::blockOf(juncGroupIdToJuncId(id, idAllocator::blockSize - 1)));
+			continue;
+		}
+
+		if (data.ids.owner.count(id))
+			throwWarning("segment id " + to_string(id) + " is used more than once, the roads of the second segment get overflow ids", true);
+		data.ids.reserve(id, id);
+		lastBlock = max(lastBlock, id);
+	}
+
+	// closing roads use the blocks of the segment counter
+	int nLinks = 0;
+	DOMElement *closeRoad = getChildWithName(rootNode, "closeRoads");
+	if (closeRoad != NULL)
+	{
+		for (DOMElement *segmentLink = closeRoad->getFirstElementChild(); segmentLink != NULL; segmentLink = segmentLink->getNextElementSibling())
+		{
+			if (readNameFromNode(segmentLink) == "segmentLink")
+				nLinks++;
+		}
+	}
+	lastBlock = max(lastBlock, nSegments + nLinks);
+
+	data.ids.reserveBelow(lastBlock + 1);
+	return 0;
+}
+
 /**
  * @brief function creates all segments which can be either a junction, roundabout or connectingroad
  * 
@@ -49,9 +105,19 @@ int buildSegments(const DOMElement* rootNode, roadNetwork &data)
 
 	DOMNodeList* segmentNodes = roadNode->getChildNodes();
 
+	// parsed road elements are shared by all roads built from them; the cache is bound to the input DOM of this run
+	roadCacheScope cacheScope;
+
+	if (reserveSegmentIds(rootNode, data))
+	{
+		cerr << "ERR: error in reserveSegmentIds." << endl;
+		return 1;
+	}
 
 	for(DOMElement* em = roadNode->getFirstElementChild(); em != NULL ;em = em->getNextElementSibling())
 	{
+		ALLOC_SEGMENT(readIntAttrFromNode(em, "id", true));
+
 		if (readNameFromNode(em) == "junction")
 		{
 			if(!setting.suppressOutput)
@@ -85,6 +151,7 @@ int buildSegments(const DOMElement* rootNode, roadNetwork &data)
 			}
 		}
 	}
+	ALLOC_SEGMENT(-1);
 
 	return 0;
 }
\ No newline at end of file
@@ -46,7 +46,7 @@ int connectingRoad(DOMElement *node, roadNetwork &data)
 
     road r;
     int id = readIntAttrFromNode(mainRoad, "id");
-    r.id = 100 * readIntAttrFromNode(node, "id") + id;
+    r.id = data.ids.allocate(readIntAttrFromNode(node, "id"), 100 * readIntAttrFromNode(node, "id") + id);
     r.inputSegmentId = readIntAttrFromNode(node, "id");
     r.junction = readIntAttrFromNode(node, "id"); 
 
@@ -56,12 +56,14 @@ int connectingRoad(DOMElement *node, roadNetwork &data)
 
     DOMElement* tmp = getChildWithName(node, "road");
 
-    if (buildRoad(mainRoad, r, 0, INFINITY, dummy, 0, 0, 0, 0))
+    // the lane changes of the road and of its objects are applied at once in addObjects
+    laneChangeBuilder changes;
+    if (buildRoad(mainRoad, r, 0, INFINITY, dummy, 0, 0, 0, 0, false, &changes))
     {
         cerr << "ERR: error in buildRoad" << endl;
         return 1;
     }
-    if (addObjects(mainRoad, r, data))
+    if (addObjects(mainRoad, r, data, changes))
     {
         cerr << "ERR: error in addObjects" << endl;
         return 1;
@@ -105,7 +107,7 @@ int connectingRoad(DOMElement *node, roadNetwork &data)
 
     }
 
-    data.roads.push_back(r);
+    data.roads.push_back(std::move(r));
 
     return 0;
 }
\ No newline at end of file
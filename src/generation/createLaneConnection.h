@@ -29,7 +29,7 @@ extern settings setting;
  * @param right     right roadmarking
  * @return int      error code
  */
-int createLaneConnection(road &r, laneSection lS1, laneSection lS2, int from, int to, string left, string right)
+int createLaneConnection(road &r, const laneSection &lS1, const laneSection &lS2, int from, int to, const internedString &left, const internedString &right)
 {
     if (from == 0 || to == 0)
     {
@@ -65,16 +65,10 @@ int createLaneConnection(road &r, laneSection lS1, laneSection lS2, int from, in
     double w2 = laneWidth(l2, 0);
 
     // check if center already contained in laneSection
-    bool foundCenter = false;
-    for (int i = 0; i < r.laneSections.back().lanes.size(); i++)
-    {
-        if (r.laneSections.back().lanes[i].id == 0)
-        {
-            foundCenter = true;
-            r.laneSections.back().lanes[i].rm.type = "none";
-            break;
-        }
-    }
+    lane *existingCenter = r.laneSections.back().lanes.get(0);
+    bool foundCenter = (existingCenter != NULL);
+    if (foundCenter)
+        existingCenter->rm.type = "none";
 
     lane center;
     center.id = 0;
@@ -15,181 +15,150 @@
  *
  */
 extern settings setting;
+
 /**
- * @brief function creates a new road connection 
- * 
- * @param r1                road at start point
- * @param r2                road at end point
- * @param r                 resulting road which is connection from r1 to r2
- * @param junc              current junction 
- * @param fromId            start lane Id
- * @param toId              end lane Id
- * @param laneMarkLeft      left roadmarking
- * @param laneMarkRight     right roadmarking
- * @return int              error code
+ * @brief status of a turn path
+ *
  */
-int createRoadConnection(road r1, road r2, road &r, junction &junc, int fromId, int toId, string laneMarkLeft, string laneMarkRight)
+enum turnPathStatus
 {
-    laneSection lS;
-    if (r.laneSections.size() == 0)
-        r.laneSections.push_back(lS);
+    turnPathOk,
+    turnPathCoincident,     // start and end point are the same
+    turnPathAntiParallel,   // opposite headings, the tangents do not intersect; a line is used instead
+    turnPathBehind          // the tangents intersect behind the start or in front of the end point
+};
 
-    r.junction = junc.id;
-    r.predecessor.id = r1.id;
-    r.successor.id = r2.id;
-    r.predecessor.elementType = roadType;
-    r.successor.elementType = roadType;
-    r.predecessor.contactPoint = startType;
-    r.successor.contactPoint = startType;
-    
-   
-    // connect r1 with r2 at reference points
-    double x1, y1, hdg1, x2, y2, hdg2, s1, s2;
-    geometry g1, g2;
-    laneSection lS1, lS2;
-
-    // --- compute starting point ----------------------------------------------
-    if (r1.predecessor.elementType == junctionType)
-    {
-        g1 = r1.geometries.front();
-        lS1 = r1.laneSections.front();
-        x1 = g1.x;
-        y1 = g1.y;
-        s1 = 0;
-        hdg1 = g1.hdg + M_PI;
-
-        fixAngle(g1.hdg);
-        fixAngle(hdg1);
-    }
+/**
+ * @brief start and end poses of connecting roads and the resulting paths (line or line and arc) as packed arrays
+ *
+ */
+struct turnPathBatch
+{
+    // input
+    arenaVector<double> x1, y1, hdg1;
+    arenaVector<double> x2, y2, hdg2;
 
-    if (r1.successor.elementType == junctionType)
-    {
-        g1 = r1.geometries.back();
-        lS1 = r1.laneSections.back();
-        x1 = g1.x;
-        y1 = g1.y;
-        s1 = r1.length - lS1.s;
-        hdg1 = g1.hdg;
-        curve(g1.length, g1, x1, y1, hdg1, 1);
-
-        fixAngle(hdg1);
-        g1.hdg = hdg1;
-    }
+    // output; each path has up to two geometries in driving direction
+    arenaVector<int> status;
+    arenaVector<int> nGeo;
+    arenaVector<geometry> geo;
+    arenaVector<double> length;
 
-    // connection between starting road and current road
-    connection con1;
-    con1.id = junc.connections.size() + 1;
-    con1.contactPoint = startType;
-    con1.from = r1.id;
-    con1.to = r.id;
-    con1.fromLane = fromId;
-    con1.toLane = sgn(toId);
-    junc.connections.push_back(con1);
+    int size() const { return x1.size(); }
 
-    // --- compute ending point ------------------------------------------------
-    if (r2.predecessor.elementType == junctionType)
+    void reserve(int n)
     {
-        g2 = r2.geometries.front();
-        lS2 = r2.laneSections.front();
-        x2 = g2.x;
-        y2 = g2.y;
-        s2 = 0;
-        hdg2 = g2.hdg;
-
-        fixAngle(hdg2);
-        g2.hdg = hdg2;
+        x1.reserve(n);
+        y1.reserve(n);
+        hdg1.reserve(n);
+        x2.reserve(n);
+        y2.reserve(n);
+        hdg2.reserve(n);
     }
 
-    if (r2.successor.elementType == junctionType)
+    /**
+     * @brief adds a path from (x1, y1, hdg1) to (x2, y2, hdg2) and returns its index
+     */
+    int add(double xs, double ys, double hdgs, double xe, double ye, double hdge)
     {
-        g2 = r2.geometries.back();
-        lS2 = r2.laneSections.back();
-        x2 = g2.x;
-        y2 = g2.y;
-        s2 = r2.length - lS2.s;
-        hdg2 = g2.hdg;
-        curve(g2.length, g2, x2, y2, hdg2, 1);
-
-        g2.hdg = hdg2;
-        fixAngle(g2.hdg);
-
-        hdg2 = hdg2 + M_PI;
-        fixAngle(hdg2);
+        x1.push_back(xs);
+        y1.push_back(ys);
+        hdg1.push_back(hdgs);
+        x2.push_back(xe);
+        y2.push_back(ye);
+        hdg2.push_back(hdge);
+        return size() - 1;
     }
+};
 
+/**
+ * @brief returns a description of the turn path status
+ */
+string turnPathStatusText(int status)
+{
+    if (status == turnPathCoincident)
+        return "start and end point are the same";
+    if (status == turnPathAntiParallel)
+        return "start and end heading are opposite";
+    if (status == turnPathBehind)
+        return "tangents intersect behind the start or end point";
+    return "ok";
+}
 
-    // --- correct laneOffset --------------------------------------------------
-    double w1 = lS1.o.a + s1 * lS1.o.b + s1 * s1 * lS1.o.c + s1 * s1 * s1 * lS.o.d;
-    double w2 = lS2.o.a + s2 * lS2.o.b + s2 * s2 * lS2.o.c + s2 * s2 * s2 * lS.o.d;
-
-    x1 += cos(g1.hdg + M_PI / 2) * w1;
-    y1 += sin(g1.hdg + M_PI / 2) * w1;
-
-    x2 += cos(g2.hdg + M_PI / 2) * w2;
-    y2 += sin(g2.hdg + M_PI / 2) * w2;
+/**
+ * @brief function computes the paths of all connecting roads in the batch.
+ *      Paths with almost equal headings are straight lines, all other paths are an arc combined with a line.
+ *      The tangents are intersected in vector form, so that vertical headings are no special case.
+ *
+ * @param b         turn paths
+ * @return int      number of degenerate paths
+ */
+int solveTurnPaths(turnPathBatch &b)
+{
+    int n = b.size();
+    b.status.assign(n, turnPathOk);
+    b.nGeo.assign(n, 0);
+    b.geo.resize(2 * n);
+    b.length.assign(n, 0);
 
-    // --- update start end endpoint according to lane position ----------------
-    double phi1 = 0;
-    double phi2 = 0;
-    double t1 = findTOffset(lS1, fromId - sgn(fromId), 0);
-    double t2 = findTOffset(lS2, toId - sgn(toId), 0);
+    double minLength = setting.minConnectingRoadLength; //min length for line segment. below that it will get disregarded
+    int degenerate = 0;
 
-    if (t1 > 0)
-        phi1 = g1.hdg + M_PI / 2;
-    if (t1 < 0)
-        phi1 = g1.hdg - M_PI / 2;
-    fixAngle(phi1);
+    for (int i = 0; i < n; i++)
+    {
+        double x1 = b.x1[i], y1 = b.y1[i], hdg1 = b.hdg1[i];
+        double x2 = b.x2[i], y2 = b.y2[i], hdg2 = b.hdg2[i];
+        geometry *out = &b.geo[2 * i];
 
-    if (t2 > 0)
-        phi2 = g2.hdg + M_PI / 2;
-    if (t2 < 0)
-        phi2 = g2.hdg - M_PI / 2;
-    fixAngle(phi2);
+        double ex = x2 - x1;
+        double ey = y2 - y1;
 
-    x1 += cos(phi1) * fabs(t1);
-    y1 += sin(phi1) * fabs(t1);
+        double a = hdg2 - hdg1;
+        fixAngle(a);
 
-    x2 += cos(phi2) * fabs(t2);
-    y2 += sin(phi2) * fabs(t2);
+        double dx1 = cos(hdg1), dy1 = sin(hdg1);
+        double dx2 = cos(hdg2), dy2 = sin(hdg2);
+        double cross = dx1 * dy2 - dy1 * dx2;
 
-    // --- compute connecting road ---------------------------------------------
-    double a = hdg2 - hdg1;
-    fixAngle(a);
+        if (ex * ex + ey * ey < 1e-12)
+            b.status[i] = turnPathCoincident;
+        else if (abs(a) >= 0.1 && abs(cross) < 1e-9)
+            b.status[i] = turnPathAntiParallel;
 
-    // simple line if angles are almost the same
-    if (abs(a) < 0.1)
-    {
-        
-        geometry g;
-        g.s = 0;
-        g.c = 0;
-        g.c1 = 0;
-        g.c2 = 0;
-        g.x = x1;
-        g.y = y1;
-        g.hdg = atan2(y2 - y1, x2 - x1);
-
-        g.length = sqrt(pow(x2 - x1, 2) + pow(y2 - y1, 2));
-        g.type = line;
-        r.geometries.push_back(g);
-        r.length = g.length;
-    }
-    // combine an arc with a line to connect both points
-    //  -> maybe better a composite curve
-    else
-    {
-        double m1 = tan(hdg1);
-        double b1 = y1 - m1 * x1;
+        // simple line if angles are almost the same
+        if (abs(a) < 0.1 || b.status[i] != turnPathOk)
+        {
+            geometry &g = out[0];
+            g.s = 0;
+            g.c = 0;
+            g.c1 = 0;
+            g.c2 = 0;
+            g.x = x1;
+            g.y = y1;
+            g.hdg = atan2(ey, ex);
+            g.length = sqrt(ex * ex + ey * ey);
+            g.type = line;
+
+            b.nGeo[i] = 1;
+            b.length[i] = g.length;
+            degenerate += (b.status[i] != turnPathOk);
+            continue;
+        }
 
-        double m2 = tan(hdg2);
-        double b2 = y2 - m2 * x2;
+        // combine an arc with a line to connect both points
+        //  -> maybe better a composite curve
+        // intersection point of the tangents: p1 + t1 * d1 = p2 + t2 * d2
+        double t1 = (ex * dy2 - ey * dx2) / cross;
+        double t2 = (ex * dy1 - ey * dx1) / cross;
 
-        // intersection point of lines
-        double ipX = (b2 - b1) / (m1 - m2);
-        double ipY = m1 * (b2 - b1) / (m1 - m2) + b1;
+        if (t1 < 0 || t2 > 0)
+        {
+            b.status[i] = turnPathBehind;
+            degenerate++;
+        }
 
-        double d1 = sqrt(pow(ipX - x1, 2) + pow(ipY - y1, 2));
-        double d2 = sqrt(pow(ipX - x2, 2) + pow(ipY - y2, 2));
+        double d1 = abs(t1);
+        double d2 = abs(t2);
 
         // additional line
         geometry g1;
@@ -199,7 +168,6 @@ int createRoadConnection(road r1, road r2, road &r, junction &junc, int fromId,
         g1.c2 = 0;
         g1.type = line;
         g1.length = abs(d2 - d1);
-        double minLength = setting.minConnectingRoadLength;  //min length for line segment. below that it will get disregarded
 
         // line at start
         if (d1 > d2)
@@ -207,15 +175,15 @@ int createRoadConnection(road r1, road r2, road &r, junction &junc, int fromId,
             g1.x = x1;
             g1.y = y1;
             g1.hdg = hdg1;
-            
-            x1 = g1.x + cos(hdg1) * (d1 - d2);
-            y1 = g1.y + sin(hdg1) * (d1 - d2);
+
+            x1 = g1.x + dx1 * (d1 - d2);
+            y1 = g1.y + dy1 * (d1 - d2);
         }
         // line at end
         if (d1 < d2)
         {
-            g1.x = x2 - cos(hdg2) * (d2 - d1);
-            g1.y = y2 - sin(hdg2) * (d2 - d1);
+            g1.x = x2 - dx2 * (d2 - d1);
+            g1.y = y2 - dy2 * (d2 - d1);
             g1.hdg = hdg2;
 
             x2 = g1.x;
@@ -239,34 +207,194 @@ int createRoadConnection(road r1, road r2, road &r, junction &junc, int fromId,
         g2.c = 1 / R;
         g2.length = abs(R * a);
         g2.type = arc;
-        
+
         // first line then arc
         if (d1 - d2 > minLength)
         {
             g2.s = g1.length;
-            r.geometries.push_back(g1);
-            r.geometries.push_back(g2);
+            out[0] = g1;
+            out[1] = g2;
+            b.nGeo[i] = 2;
         }
         // first arc then line
         else if (d2 - d1 > minLength)
         {
             g1.s = g2.length;
-            r.geometries.push_back(g2);
-            r.geometries.push_back(g1);
+            out[0] = g2;
+            out[1] = g1;
+            b.nGeo[i] = 2;
         }
         // only arc is necessary
         else
         {
-            r.geometries.push_back(g2);
+            out[0] = g2;
+            b.nGeo[i] = 1;
         }
 
         if (d1 != d2)
-            r.length += g1.length;
-        r.length += g2.length;
+            b.length[i] += g1.length;
+        b.length[i] += g2.length;
+    }
+    return degenerate;
+}
+
+/**
+ * @brief returns the lane section of an arm at its junction end or NULL if the arm does not end at a junction
+ */
+const laneSection *junctionLaneSection(const road &arm)
+{
+    const laneSection *lS = NULL;
+    if (arm.predecessor.elementType == junctionType)
+        lS = &arm.laneSections.front();
+    if (arm.successor.elementType == junctionType)
+        lS = &arm.laneSections.back();
+    return lS;
+}
+
+/**
+ * @brief function computes the pose of a connecting road at the junction end of an arm
+ *
+ * @param arm       arm of the junction
+ * @param laneId    lane of the arm which is connected
+ * @param start     true if the connecting road starts at the arm, false if it ends there
+ * @param x         x position of the pose
+ * @param y         y position of the pose
+ * @param hdg       heading of the pose in driving direction of the connecting road
+ * @return int      error code
+ */
+int connectionPose(const road &arm, int laneId, bool start, double &x, double &y, double &hdg)
+{
+    x = 0;
+    y = 0;
+    hdg = 0;
+
+    double s = 0;
+    geometry g;
+    const laneSection *lS = junctionLaneSection(arm);
+    if (lS == NULL)
+        return 1;
+
+    if (arm.predecessor.elementType == junctionType)
+    {
+        g = arm.geometries.front();
+        x = g.x;
+        y = g.y;
+        s = 0;
+        hdg = g.hdg + (start ? M_PI : 0);
+
+        fixAngle(g.hdg);
+        fixAngle(hdg);
+    }
+
+    if (arm.successor.elementType == junctionType)
+    {
+        g = arm.geometries.back();
+        x = g.x;
+        y = g.y;
+        s = arm.length - lS->s;
+        hdg = g.hdg;
+        curve(g.length, g, x, y, hdg, 1);
+
+        fixAngle(hdg);
+        g.hdg = hdg;
+
+        if (!start)
+        {
+            hdg = hdg + M_PI;
+            fixAngle(hdg);
+        }
     }
 
+    // --- correct laneOffset (the cubic term is not applied) ------------------
+    double w = lS->o.a + s * lS->o.b + s * s * lS->o.c;
+
+    x += cos(g.hdg + M_PI / 2) * w;
+    y += sin(g.hdg + M_PI / 2) * w;
+
+    // --- update point according to lane position -----------------------------
+    double phi = 0;
+    double t = findTOffset(*lS, laneId - sgn(laneId), 0);
+
+    if (t > 0)
+        phi = g.hdg + M_PI / 2;
+    if (t < 0)
+        phi = g.hdg - M_PI / 2;
+    fixAngle(phi);
+
+    x += cos(phi) * fabs(t);
+    y += sin(phi) * fabs(t);
+
+    return 0;
+}
+
+/**
+ * @brief function adds the start and end pose of a connecting road to the batch
+ *
+ * @param r1        road at start point
+ * @param r2        road at end point
+ * @param fromId    start lane Id
+ * @param toId      end lane Id
+ * @param b         turn paths
+ * @return int      index of the path in the batch
+ */
+int addTurnPath(const road &r1, const road &r2, int fromId, int toId, turnPathBatch &b)
+{
+    double x1, y1, hdg1, x2, y2, hdg2;
+    connectionPose(r1, fromId, true, x1, y1, hdg1);
+    connectionPose(r2, toId, false, x2, y2, hdg2);
+    return b.add(x1, y1, hdg1, x2, y2, hdg2);
+}
+
+/**
+ * @brief function creates a new road connection from a solved turn path
+ * 
+ * @param r1                road at start point
+ * @param r2                road at end point
+ * @param r                 resulting road which is connection from r1 to r2
+ * @param junc              current junction 
+ * @param fromId            start lane Id
+ * @param toId              end lane Id
+ * @param laneMarkLeft      left roadmarking
+ * @param laneMarkRight     right roadmarking
+ * @param b                 solved turn paths
+ * @param i                 index of the path
+ * @return int              error code
+ */
+int buildRoadConnection(const road &r1, const road &r2, road &r, junction &junc, int fromId, int toId, const internedString &laneMarkLeft, const internedString &laneMarkRight, const turnPathBatch &b, int i)
+{
+    laneSection lS;
+    if (r.laneSections.size() == 0)
+        r.laneSections.push_back(lS);
+
+    r.junction = junc.id;
+    r.predecessor.id = r1.id;
+    r.successor.id = r2.id;
+    r.predecessor.elementType = roadType;
+    r.successor.elementType = roadType;
+    r.predecessor.contactPoint = startType;
+    r.successor.contactPoint = startType;
+
+    // connection between starting road and current road
+    connection con1;
+    con1.id = junc.connections.size() + 1;
+    con1.contactPoint = startType;
+    con1.from = r1.id;
+    con1.to = r.id;
+    con1.fromLane = fromId;
+    con1.toLane = sgn(toId);
+    junc.connections.push_back(con1);
+
+    // --- geometry of connecting road -----------------------------------------
+    for (int k = 0; k < b.nGeo[i]; k++)
+        r.geometries.push_back(b.geo[2 * i + k]);
+    r.length += b.length[i];
+
     // --- lanemarkings in crossing section ------------------------------------
-    if (createLaneConnection(r, lS1, lS2, fromId, toId, laneMarkLeft, laneMarkRight))
+    laneSection none;
+    const laneSection *lS1 = junctionLaneSection(r1);
+    const laneSection *lS2 = junctionLaneSection(r2);
+
+    if (createLaneConnection(r, lS1 ? *lS1 : none, lS2 ? *lS2 : none, fromId, toId, laneMarkLeft, laneMarkRight))
     {
         cerr << "Error in createLaneConnection" << endl;
         exit(0);
@@ -274,4 +402,150 @@ int createRoadConnection(road r1, road r2, road &r, junction &junc, int fromId,
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief function creates a new road connection 
+ * 
+ * @param r1                road at start point
+ * @param r2                road at end point
+ * @param r                 resulting road which is connection from r1 to r2
+ * @param junc              current junction 
+ * @param fromId            start lane Id
+ * @param toId              end lane Id
+ * @param laneMarkLeft      left roadmarking
+ * @param laneMarkRight     right roadmarking
+ * @return int              error code
+ */
+int createRoadConnection(const road &r1, const road &r2, road &r, junction &junc, int fromId, int toId, const internedString &laneMarkLeft, const internedString &laneMarkRight)
+{
+    turnPathBatch b;
+    int i = addTurnPath(r1, r2, fromId, toId, b);
+
+    if (solveTurnPaths(b))
+        throwWarning("connecting road " + to_string(r.id) + " is degenerate: " + turnPathStatusText(b.status[i]));
+
+    return buildRoadConnection(r1, r2, r, junc, fromId, toId, laneMarkLeft, laneMarkRight, b, i);
+}
+
+/**
+ * @brief connecting road which is generated by createRoadConnections
+ *
+ */
+struct connectionTask
+{
+    const road *from = NULL;
+    const road *to = NULL;
+    int fromId = 0;
+    int toId = 0;
+    internedString laneMarkLeft;  // interned when the task is built, the workers only copy the pointer
+    internedString laneMarkRight;
+
+    // input
+    int id = -1;
+    int inputSegmentId = -1;
+
+    // output
+    road r;
+    arenaVector<connection> connections;
+    int error = 0;
+};
+
+/**
+ * @brief function appends the generated connecting roads to the road network and their connections to the junction
+ * 
+ * @param tasks     generated connecting roads
+ * @param junc      current junction
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int commitRoadConnections(vector<connectionTask> &tasks, junction &junc, roadNetwork &data)
+{
+    data.roads.reserve(data.roads.size() + tasks.size());
+    for (connectionTask &t : tasks)
+    {
+        if (t.error)
+        {
+            cerr << "ERR: error in createRoadConnection" << endl;
+            return 1;
+        }
+
+        for (connection &c : t.connections)
+        {
+            c.id = junc.connections.size() + 1;
+            junc.connections.push_back(c);
+        }
+        data.roads.push_back(std::move(t.r));
+    }
+    tasks.clear();
+
+    return 0;
+}
+
+// junction cache, see junctionCache.h
+string junctionCacheKey(const vector<connectionTask> &tasks);
+bool loadCachedConnections(const string &key, vector<connectionTask> &tasks, const junction &junc);
+void storeCachedConnections(const string &key, const vector<connectionTask> &tasks);
+
+/**
+ * @brief function generates the connecting roads of a junction in parallel. The road ids are set by the caller before, 
+ *      the roads are appended to the road network and the connections to the junction in the order of the tasks afterwards.
+ *      So the result does not depend on the number of threads.
+ *      If the junction cache is enabled, the roads of an identical junction are reused instead.
+ * 
+ * @param tasks     connecting roads
+ * @param junc      current junction
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int createRoadConnections(vector<connectionTask> &tasks, junction &junc, roadNetwork &data)
+{
+    string key;
+    if (setting.junctionCache)
+    {
+        key = junctionCacheKey(tasks);
+        if (loadCachedConnections(key, tasks, junc))
+            return commitRoadConnections(tasks, junc, data);
+    }
+
+    // the poses are computed serially, this also tabulates the lane borders of the arms before they are shared between threads
+    turnPathBatch paths;
+    paths.reserve(tasks.size());
+    for (const connectionTask &t : tasks)
+        addTurnPath(*t.from, *t.to, t.fromId, t.toId, paths);
+
+    if (solveTurnPaths(paths))
+    {
+        for (int i = 0; i < (int)tasks.size(); i++)
+        {
+            if (paths.status[i] == turnPathOk)
+                continue;
+
+            const connectionTask &t = tasks[i];
+            throwWarning("connecting road " + to_string(t.id) + " from road " + to_string(t.from->id) + " lane " + to_string(t.fromId) +
+                         " to road " + to_string(t.to->id) + " lane " + to_string(t.toId) + " is degenerate: " + turnPathStatusText(paths.status[i]));
+        }
+    }
+
+    parallelFor(tasks.size(), [&](int i) {
+        connectionTask &t = tasks[i];
+
+        // the road and the connections are created in the worker, so that their containers do not use the arena of the run
+        road r;
+        r.id = t.id;
+        r.inputSegmentId = t.inputSegmentId;
+
+        junction j;
+        j.id = junc.id;
+
+        t.error = buildRoadConnection(*t.from, *t.to, r, j, t.fromId, t.toId, t.laneMarkLeft, t.laneMarkRight, paths, i);
+
+        t.r = std::move(r);
+        t.connections = std::move(j.connections);
+    });
+
+    if (setting.junctionCache)
+        storeCachedConnections(key, tasks);
+
+    return commitRoadConnections(tasks, junc, data);
+}
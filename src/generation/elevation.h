@@ -15,6 +15,7 @@
  *
  */
 
+#pragma once
 #include "utils/interface.h"
 #include "utils/helper.h"
 #include <vector>
@@ -74,16 +75,26 @@ double poly3Derivation(double x, double b, double c, double d)
     return b + 2*c*x + 3*d*x*x;
 }
 
-int generateElevationProfile(vector<elevationProfile> &eps)
+/**
+ * @brief generates the output polynoms of an elevation profile
+ * 
+ * @param eps       elevation points of the road (relative heights)
+ * @param offset    absolute elevation offset of the road
+ * @return int      error code
+ */
+int generateElevationProfile(arenaVector<elevationProfile> &eps, double offset)
 {
 
-    for(int i = 0; i < eps.size() - 1; i ++)
+    for(int i = 0; i < (int)eps.size(); i ++)
+        eps[i].outputElevation.clear();
+
+    for(int i = 0; i + 1 < (int)eps.size(); i ++)
     {
         double o1 = eps[i].sOffset;
         double o2 = eps[i+1].sOffset;
 
-        double y1 = eps[i].tOffset;
-        double y2 = eps[i+1].tOffset;
+        double y1 = eps[i].tOffset + offset;
+        double y2 = eps[i+1].tOffset + offset;
         
         double r1 = eps[i].radius;
         double r2 = eps[i+1].radius;
@@ -131,312 +142,703 @@ int generateElevationProfile(vector<elevationProfile> &eps)
     return 0;
 }
 
+/**
+ * @brief evaluates an elevation polynom at the given s position
+ * 
+ * @param p         elevation polynom
+ * @param s         s position along the road
+ * @param value     elevation at s
+ * @param slope     derivation at s
+ */
+void evaluateElevationPolynom(const elevationPolynom &p, double s, double &value, double &slope)
+{
+    double ds = s - p.s;
+    value = poly3(ds, p.a, p.b, p.c, p.d);
+    slope = poly3Derivation(ds, p.b, p.c, p.d);
+}
 
-
-int generateElevationProfiles(const DOMElement* rootNode, roadNetwork &data)
+/**
+ * @brief merges the output polynoms of a road. Zero length polynoms are removed and consecutive polynoms are replaced by a single cubic
+ *  polynom as long as it deviates less than the tolerance from them. The cubic polynom matches elevation and slope at both ends, 
+ *  so identical and collinear polynoms are merged exactly and the profile stays continuous. 
+ *  The result is stored in the first elevation profile of the road.
+ * 
+ * @param r         road
+ * @param tolerance maximal elevation deviation of the merged polynoms
+ * @return int      error code
+ */
+int simplifyElevationProfile(road &r, double tolerance)
 {
-    cout << "Generating Elevation Profiles TODO: DELETE THIS" << endl;
+    if(r.elevationProfiles.size() == 0)
+        return 0;
+
+    // collect all polynoms of the road and remove zero length polynoms
+    arenaVector<elevationPolynom> polys;
+    for(elevationProfile &ep: r.elevationProfiles)
+    {
+        for(elevationPolynom &p: ep.outputElevation)
+            polys.push_back(p);
+        ep.outputElevation.clear();
+    }
+
+    arenaVector<elevationPolynom> pieces;
+    vector<double> ends;
+    for(int i = 0; i < (int)polys.size(); i++)
+    {
+        double end = (i + 1 < (int)polys.size()) ? polys[i + 1].s : r.length;
+        if(end - polys[i].s <= 1e-9)
+            continue;
+        pieces.push_back(polys[i]);
+        ends.push_back(end);
+    }
 
-    //this helper struct stores information that about the parent object that is required to process the elevation of each road. 
-    //Since (for instance) the successor of the successor of a road can be the same road again, we need to keep book of what road we were coming from
-    struct elevationLinkInformation
+    if(pieces.size() == 0)
     {
-        road*               curRoad;                //road that needs processing
-        road*               parentRoad;             //road that put curRoad in the processing queue. This can be successor or predecessor
-        contactPointType    parentLinkingPoint = noneType; //-1: curRoad was linked as predecessor. 1:road was linked as successor
-        double              offsetHeightAtLink = 0; //height at linking point
+        if(polys.size() > 0)
+            r.elevationProfiles.front().outputElevation.push_back(polys.front());
+        return 0;
+    }
 
-    };
+    const int nSamples = 8;
+    arenaVector<elevationPolynom> &res = r.elevationProfiles.front().outputElevation;
 
-    //sanity checks
-    for(road &r: data.roads)
+    int first = 0;
+    while(first < (int)pieces.size())
     {
-        //fill in missing elevation data
-        if(r.elevationProfiles.size() == 0)
-        {
-            elevationProfile ep1, ep2;
-            ep1.radius = 10;
-            ep1.sOffset = 0;
-            ep1.tOffset = 0;
-            ep2.radius = 10;
-            ep2.sOffset = r.length;
-            ep2.tOffset = 0;
-
-            r.elevationProfiles.push_back(ep1);
-            r.elevationProfiles.push_back(ep2);
-        }
+        double p0, m0;
+        evaluateElevationPolynom(pieces[first], pieces[first].s, p0, m0);
 
-        //check if s bounds are violated
-        if(r.elevationProfiles[0].sOffset < 0 || r.elevationProfiles[r.elevationProfiles.size() -1].sOffset > r.length)
-        {
-            throwError("invalid elevation profile in segment " + to_string(r.inputSegmentId) + " road " + to_string(r.inputId));
-            return 1;
-        }
+        elevationPolynom best = pieces[first];
+        int last = first;
 
-        //check if multiple elevation poitns occur at the same s
-        if(r.elevationProfiles.size() > 1)
+        // try to extend the current polynom over the following pieces
+        for(int j = first + 1; j < (int)pieces.size(); j++)
         {
-            for(int i = 0; i < r.elevationProfiles.size() -2; i++)
+            double h = ends[j] - pieces[first].s;
+            double p1, m1;
+            evaluateElevationPolynom(pieces[j], ends[j], p1, m1);
+
+            elevationPolynom cubic;
+            cubic.s = pieces[first].s;
+            cubic.a = p0;
+            cubic.b = m0;
+            cubic.c = (3 * (p1 - p0) - (2 * m0 + m1) * h) / (h * h);
+            cubic.d = (2 * (p0 - p1) + (m0 + m1) * h) / (h * h * h);
+
+            bool fits = true;
+            for(int k = first; k <= j && fits; k++)
             {
-                if(r.elevationProfiles[i].sOffset == r.elevationProfiles[i+1].sOffset)
+                for(int n = 0; n <= nSamples; n++)
                 {
-                    throwWarning("multiple elevation points are defined for one s offset in segment " + to_string(r.inputSegmentId) + " road " + to_string(r.inputId));
+                    double s = pieces[k].s + (ends[k] - pieces[k].s) * n / nSamples;
+                    double v, dv, vCubic;
+                    evaluateElevationPolynom(pieces[k], s, v, dv);
+                    evaluateElevationPolynom(cubic, s, vCubic, dv);
+                    if(fabs(v - vCubic) > tolerance)
+                    {
+                        fits = false;
+                        break;
+                    }
                 }
             }
+            if(!fits)
+                break;
+
+            best = cubic;
+            last = j;
         }
+
+        res.push_back(best);
+        first = last + 1;
     }
 
-    //--------------
+    // if zero length polynoms were removed at the road start, the first polynom starts slightly behind it; it is moved to s = 0
+    elevationPolynom &front = res.front();
+    if(front.s != 0)
+    {
+        double ds = -front.s;
+        double value, slope;
+        evaluateElevationPolynom(front, 0, value, slope);
+        front.c += 3 * front.d * ds;
+        front.a = value;
+        front.b = slope;
+        front.s = 0;
+    }
 
-    queue<elevationLinkInformation> remaining = queue<elevationLinkInformation>();
-    vector<int> completededIds = vector<int>();
+    return 0;
+}
 
+/**
+ * @brief fills in missing elevation data and checks the elevation profile of a road
+ * 
+ * @param r     road
+ * @return int  error code
+ */
+int checkElevationProfile(road &r)
+{
+    //fill in missing elevation data
+    if(r.elevationProfiles.size() == 0)
+    {
+        elevationProfile ep1, ep2;
+        ep1.radius = 10;
+        ep1.sOffset = 0;
+        ep1.tOffset = 0;
+        ep2.radius = 10;
+        ep2.sOffset = r.length;
+        ep2.tOffset = 0;
+
+        r.elevationProfiles.push_back(ep1);
+        r.elevationProfiles.push_back(ep2);
+    }
 
-	DOMElement *links = getChildWithName(rootNode, "links");
-	if (links == NULL)
-	{
-		throwWarning("'links' are not specified in input file.\n\t -> skip segment linking", true);
+    //check if s bounds are violated
+    if(r.elevationProfiles[0].sOffset < 0 || r.elevationProfiles[r.elevationProfiles.size() -1].sOffset > r.length)
+    {
+        throwError("invalid elevation profile in segment " + to_string(r.inputSegmentId) + " road " + to_string(r.inputId));
+        return 1;
+    }
 
-		return 0;
-	}
+    //check if multiple elevation poitns occur at the same s
+    for(int i = 0; i + 1 < (int)r.elevationProfiles.size(); i++)
+    {
+        if(r.elevationProfiles[i].sOffset == r.elevationProfiles[i+1].sOffset)
+        {
+            throwWarning("multiple elevation points are defined for one s offset in segment " + to_string(r.inputSegmentId) + " road " + to_string(r.inputId));
+        }
+    }
+    return 0;
+}
 
-	// define reference system
-    
-    //find ref road
-    road* ref = NULL;
-    for(road &r: data.roads)
+/**
+ * @brief returns the relative elevation of a node of the elevation graph at the given contact point
+ * 
+ * @param data      roadNetwork data
+ * @param node      node index
+ * @param pos       contact point of the node
+ * @return double   relative elevation (junctions are always 0)
+ */
+double getNodeElevation(roadNetwork &data, int node, contactPointType pos)
+{
+    if(node >= data.elevGraph.nRoads)
+        return 0;
+
+    if(pos == endType)
+        return data.roads[node].getRelativeElevationAt(1);
+
+    return data.roads[node].getRelativeElevationAt(-1);
+}
+
+/**
+ * @brief adds an undirected edge to the elevation graph
+ * 
+ * @param g         elevation graph
+ * @param a         first node index
+ * @param posA      contact point at the first node
+ * @param b         second node index
+ * @param posB      contact point at the second node
+ */
+void addElevationEdge(elevationGraph &g, int a, contactPointType posA, int b, contactPointType posB)
+{
+    elevationEdge e;
+    e.to = b;
+    e.fromPos = posA;
+    e.toPos = posB;
+    g.edges[a].push_back(e);
+
+    e.to = a;
+    e.fromPos = posB;
+    e.toPos = posA;
+    g.edges[b].push_back(e);
+}
+
+/**
+ * @brief builds the elevation graph of the road network. Roads and junctions are the nodes, links are the edges.
+ *  The roads inside a junction are stored in a membership list of the junction and are linked to the junction node.
+ * 
+ * @param data      roadNetwork data
+ * @param g         elevation graph
+ * @return int      error code
+ */
+int buildElevationGraph(roadNetwork &data, elevationGraph &g)
+{
+
+    g.nRoads = data.roads.size();
+    g.roadIndex.clear();
+    g.junctionIndex.clear();
+
+    for(int i = 0; i < (int)data.roads.size(); i++)
+        g.roadIndex[data.roads[i].id] = i;
+
+    for(int i = 0; i < (int)data.junctions.size(); i++)
+        g.junctionIndex[data.junctions[i].id] = g.nRoads + i;
+
+    int nNodes = g.nRoads + data.junctions.size();
+    g.edges.assign(nNodes, vector<elevationEdge>());
+    g.junctionMembers.assign(data.junctions.size(), vector<int>());
+
+    for(int i = 0; i < (int)data.roads.size(); i++)
     {
-        if(r.inputSegmentId == data.refRoad)
+        road &r = data.roads[i];
+
+        // roads inside of a junction are members of the junction
+        if(!r.isConnectingRoad && g.junctionIndex.count(r.junction) > 0)
+        {
+            int j = g.junctionIndex[r.junction];
+            g.junctionMembers[j - g.nRoads].push_back(i);
+            addElevationEdge(g, i, startType, j, noneType);
+            continue;
+        }
+
+        link *links[2] = {&r.predecessor, &r.successor};
+        contactPointType positions[2] = {startType, endType};
+
+        for(int k = 0; k < 2; k++)
         {
-            ref = &r;
+            link &l = *links[k];
+            if(l.id < 0)
+                continue;
+
+            if(l.elementType == junctionType)
+            {
+                if(g.junctionIndex.count(l.id) == 0)
+                    continue;
+
+                int j = g.junctionIndex[l.id];
+                g.junctionMembers[j - g.nRoads].push_back(i);
+                addElevationEdge(g, i, positions[k], j, noneType);
+                continue;
+            }
+
+            if(g.roadIndex.count(l.id) == 0)
+                continue;
+
+            int n = g.roadIndex[l.id];
+            road &neighbour = data.roads[n];
+
+            // roads inside of a junction are only linked to the junction node
+            if(!neighbour.isConnectingRoad && g.junctionIndex.count(neighbour.junction) > 0)
+                continue;
+
+            // both roads reference each other -> the edge is added when the road with the smaller index is processed
+            int adjacent = neighbour.getAdjacentRoadWithId(r.id);
+            if(adjacent != 0 && n < i)
+                continue;
+
+            contactPointType neighbourPos = l.contactPoint;
+            if(adjacent == -1)
+                neighbourPos = startType;
+            else if(adjacent == 1)
+                neighbourPos = endType;
+
+            if(neighbourPos == noneType)
+                continue;
+
+            addElevationEdge(g, i, positions[k], n, neighbourPos);
         }
     }
-    if(NULL == ref)
+
+    return 0;
+}
+
+/**
+ * @brief computes the elevation offset of a node from its spanning tree parent
+ * 
+ * @param data      roadNetwork data
+ * @param node      node index
+ * @return double   elevation offset
+ */
+double getOffsetFromParent(roadNetwork &data, int node)
+{
+    elevationGraph &g = data.elevGraph;
+    elevationEdge &p = g.parentEdge[node];
+
+    if(p.to == -1)
+        return g.offset[node];
+
+    return g.offset[p.to] + getNodeElevation(data, p.to, p.toPos) - getNodeElevation(data, node, p.fromPos);
+}
+
+/**
+ * @brief propagates the elevation offset from the reference road over the whole graph and stores the spanning tree
+ * 
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int propagateElevation(roadNetwork &data)
+{
+    elevationGraph &g = data.elevGraph;
+    int nNodes = g.edges.size();
+
+    g.parentEdge.assign(nNodes, elevationEdge());
+    g.children.assign(nNodes, vector<int>());
+    g.offset.assign(nNodes, 0);
+
+    if(g.root < 0 || g.root >= nNodes)
     {
         throwError("Could not find reference road in elevation generation");
-        return -1;
+        return 1;
     }
 
-    data.refElev = readIntAttrFromNode(links, "reElev"); // This tag is not yet defined. TODO: add this tag to xml scheme
-    completededIds.push_back(ref->id);
-    //handle successors of root
-    if(ref->successor.id > -1)
+    vector<bool> visited(nNodes, false);
+    queue<int> remaining;
+
+    g.offset[g.root] = g.rootOffset;
+    visited[g.root] = true;
+    remaining.push(g.root);
+
+    while(!remaining.empty())
     {
-        road *suc;
-        findRoad(data.roads, suc, ref->successor.id);
+        int cur = remaining.front();
+        remaining.pop();
 
-        //when processing an element, adjust the next roads elevation offset. This way we dont need to keep the current offset stored
-       
-        
-        if(suc->isLinkedToNetwork)
+        for(elevationEdge &e: g.edges[cur])
         {
-            elevationLinkInformation eli;
-            eli.curRoad = suc;
-            eli.parentRoad = ref;
-            eli.parentLinkingPoint = startType;
-
-            remaining.push(eli);
+            if(visited[e.to])
+                continue;
+            visited[e.to] = true;
+
+            elevationEdge &p = g.parentEdge[e.to];
+            p.to = cur;
+            p.fromPos = e.toPos;
+            p.toPos = e.fromPos;
+
+            g.children[cur].push_back(e.to);
+            g.offset[e.to] = getOffsetFromParent(data, e.to);
+            remaining.push(e.to);
         }
-        completededIds.push_back(ref->id);
+    }
+
+    for(int i = 0; i < g.nRoads; i++)
+        data.roads[i].elevationOffset = g.offset[i];
+
+    return 0;
+}
 
+/**
+ * @brief solves (L_tree) z = r for the spanning tree laplacian with fixed root in linear time. Is used as preconditioner.
+ * 
+ * @param g         elevation graph
+ * @param order     reached nodes in bfs order, starting with the root
+ * @param r         right hand side
+ * @param z         solution
+ * @param flow      buffer
+ */
+void solveTreeLaplacian(elevationGraph &g, const vector<int> &order, const vector<double> &r, vector<double> &z, vector<double> &flow)
+{
+    for(int k = order.size() - 1; k >= 0; k--)
+    {
+        int n = order[k];
+        flow[n] = r[n];
+        for(int c: g.children[n])
+            flow[n] += flow[c];
     }
-     //----handle predecessors of root-----------------------------------
 
-    if(ref->predecessor.id > -1)
+    z[order[0]] = 0;
+    for(int k = 1; k < (int)order.size(); k++)
     {
-        road *pre;
-        findRoad(data.roads, pre, ref->predecessor.id);
+        int n = order[k];
+        z[n] = z[g.parentEdge[n].to] + flow[n];
+    }
+}
 
-        //when processing an element, adjust the next roads elevation offset. This way we dont need to keep the current offset stored
-        
-        if(pre->isLinkedToNetwork)
-        {
-            elevationLinkInformation eli;
-            eli.curRoad = pre;
-            eli.parentRoad = ref;
-            eli.parentLinkingPoint = endType;
+/**
+ * @brief computes all elevation offsets at once as least squares solution of the height continuity constraints of all edges.
+ *  The offset of the reference road is fixed. The system is solved by a conjugate gradient method preconditioned with the
+ *  spanning tree of the bfs propagation, which is the initial guess. The iteration count is bounded by the number of loops in the network.
+ *  requires that propagateElevation was called before
+ * 
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int solveElevationLeastSquares(roadNetwork &data)
+{
+    elevationGraph &g = data.elevGraph;
+    int nNodes = g.edges.size();
+
+    // reached nodes in bfs order
+    vector<int> order;
+    order.reserve(nNodes);
+    order.push_back(g.root);
+    for(int k = 0; k < (int)order.size(); k++)
+    {
+        for(int c: g.children[order[k]])
+            order.push_back(c);
+    }
 
-            remaining.push(eli);
-        }
-        completededIds.push_back(ref->id);
+    // flatten all edges between reached nodes: x[u] - x[v] = rhs
+    vector<bool> reached(nNodes, false);
+    for(int n: order)
+        reached[n] = true;
 
+    vector<int> eu, ev;
+    vector<double> eb;
+    for(int u = 0; u < nNodes; u++)
+    {
+        if(!reached[u])
+            continue;
+        for(elevationEdge &e: g.edges[u])
+        {
+            if(e.to <= u || !reached[e.to])
+                continue;
+            eu.push_back(u);
+            ev.push_back(e.to);
+            eb.push_back(getNodeElevation(data, e.to, e.toPos) - getNodeElevation(data, u, e.fromPos));
+        }
     }
-   
+    int nEdges = eu.size();
 
-  
-    while(remaining.size() > 0)
+    // residual of the normal equations r = A^T b - A^T A x for the bfs solution
+    vector<double> r(nNodes, 0), z(nNodes, 0), p(nNodes, 0), q(nNodes, 0), flow(nNodes, 0);
+    for(int k = 0; k < nEdges; k++)
     {
-     
-        elevationLinkInformation curEli = remaining.front();
-        remaining.pop();
-        if(isIn(completededIds, curEli.curRoad->id))
-            continue;
-        cout << "iterating loop with id " << curEli.curRoad->id << "and pre " << curEli.parentRoad->id << "\n";
+        double res = eb[k] - (g.offset[eu[k]] - g.offset[ev[k]]);
+        r[eu[k]] += res;
+        r[ev[k]] -= res;
+    }
+    r[g.root] = 0;
+
+    solveTreeLaplacian(g, order, r, z, flow);
+    p = z;
+
+    double rz = 0;
+    for(int n: order)
+        rz += r[n] * z[n];
 
-        if(curEli.curRoad->id == 1004)
+    const double tolerance = 1e-10;
+    const int maxIterations = 1000;
+    int it = 0;
+    for(; it < maxIterations; it++)
+    {
+        double rr = 0;
+        for(int n: order)
+            rr += r[n] * r[n];
+        if(sqrt(rr) < tolerance)
+            break;
+
+        // q = A^T A p
+        for(int n: order)
+            q[n] = 0;
+        for(int k = 0; k < nEdges; k++)
         {
-            cout <<endl;
+            double d = p[eu[k]] - p[ev[k]];
+            q[eu[k]] += d;
+            q[ev[k]] -= d;
         }
-        if(curEli.parentLinkingPoint == noneType)//when linked from junction
-        {
-            curEli.curRoad->elevationOffset = curEli.parentRoad->elevationOffset;
-            if(curEli.curRoad->successor.id > -1 && !isIn(completededIds, curEli.curRoad->successor.id))
-            {
-                elevationLinkInformation newEli;
-                road *ssuc;
-                findRoad(data.roads, ssuc, curEli.curRoad->successor.id);
-                newEli.curRoad = ssuc;
-                newEli.parentRoad = curEli.curRoad;
-                newEli.parentLinkingPoint = startType;
-                
-                remaining.push(newEli);
-            }
+        q[g.root] = 0;
 
-        }
-        else if(curEli.parentLinkingPoint == startType)
+        double pq = 0;
+        for(int n: order)
+            pq += p[n] * q[n];
+        if(pq <= 0)
+            break;
+
+        double alpha = rz / pq;
+        for(int n: order)
         {
-            if(curEli.curRoad->predecessor.contactPoint == endType)
-            {
-                double elevationOffsetAtLink = curEli.parentRoad->getRelativeElevationAt(1) + curEli.parentRoad->elevationOffset;
-                if(curEli.parentRoad->successor.contactPoint == startType)
-                {
-                    // |pre>  |suc>
-                    curEli.curRoad->elevationOffset = elevationOffsetAtLink;
+            g.offset[n] += alpha * p[n];
+            r[n] -= alpha * q[n];
+        }
 
-                }
+        solveTreeLaplacian(g, order, r, z, flow);
 
-                else if(curEli.parentRoad->successor.contactPoint == endType)
-                {
-                        // |pre>  <suc|
-                    curEli.curRoad->elevationOffset = elevationOffsetAtLink - curEli.curRoad->getRelativeElevationAt(1);
-                }
+        double rzNew = 0;
+        for(int n: order)
+            rzNew += r[n] * z[n];
 
-            }
+        double beta = rzNew / rz;
+        rz = rzNew;
+        for(int n: order)
+            p[n] = z[n] + beta * p[n];
+    }
 
-            else if(curEli.curRoad->predecessor.contactPoint == startType)
-            {
-                double elevationOffsetAtLink = curEli.parentRoad->getRelativeElevationAt(0) + curEli.parentRoad->elevationOffset;
-                if(curEli.parentRoad->successor.contactPoint == startType)
-                {
-                    // <pre|  |suc>
-                    curEli.curRoad->elevationOffset = elevationOffsetAtLink;
-                }
+    if(it == maxIterations)
+        throwWarning("least squares elevation solver did not converge");
 
-                else if(curEli.parentRoad->successor.contactPoint == endType)
-                {
-                    // <pre|  <suc|
-                    curEli.curRoad->elevationOffset = elevationOffsetAtLink - curEli.curRoad->getRelativeElevationAt(1);
-                }
+    for(int i = 0; i < g.nRoads; i++)
+        data.roads[i].elevationOffset = g.offset[i];
 
-            }
+    return 0;
+}
 
-            completededIds.push_back(curEli.curRoad->id);
-            if(curEli.curRoad->successor.id > -1 && !isIn(completededIds, curEli.curRoad->successor.id))
-            {
-                elevationLinkInformation newEli;
-                road *ssuc;
-                findRoad(data.roads, ssuc, curEli.curRoad->successor.id);
-                newEli.curRoad = ssuc;
-                newEli.parentRoad = curEli.curRoad;
-                newEli.parentLinkingPoint = startType;
-                
-                remaining.push(newEli);
-            }
-        }
-        else if(curEli.parentLinkingPoint == endType)
+/**
+ * @brief recomputes the elevation offsets of a node and all nodes in its spanning tree subtree
+ * 
+ * @param data      roadNetwork data
+ * @param node      node index
+ * @param changed   road indices of all roads whose offset was recomputed
+ * @return int      error code
+ */
+int propagateElevationFromNode(roadNetwork &data, int node, vector<int> &changed)
+{
+    elevationGraph &g = data.elevGraph;
+
+    queue<int> remaining;
+    remaining.push(node);
+
+    while(!remaining.empty())
+    {
+        int cur = remaining.front();
+        remaining.pop();
+
+        if(cur != g.root)
+            g.offset[cur] = getOffsetFromParent(data, cur);
+
+        if(cur < g.nRoads)
         {
-            cout << "iterating second loop\n";
+            data.roads[cur].elevationOffset = g.offset[cur];
+            changed.push_back(cur);
+        }
 
-           
+        for(int c: g.children[cur])
+            remaining.push(c);
+    }
 
-            if(curEli.curRoad->successor.contactPoint == startType )
-            {
-                double elevationOffsetAtLink = curEli.parentRoad->getRelativeElevationAt(0) + curEli.parentRoad->elevationOffset;
-                if(curEli.parentRoad->predecessor.contactPoint == endType)
-                {
-                    curEli.curRoad->elevationOffset = elevationOffsetAtLink - curEli.curRoad->getRelativeElevationAt(1);
+    return 0;
+}
 
-                }
+/**
+ * @brief generates and merges the output polynoms of a road from its elevation profile and its elevation offset
+ * 
+ * @param r         road
+ * @return int      error code
+ */
+int generateRoadElevation(road &r)
+{
+    if (generateElevationProfile(r.elevationProfiles, r.elevationOffset))
+    {
+        cerr << "ERR: error in generateElevationProfile" << endl;
+        return 1;
+    }
+    if (simplifyElevationProfile(r, setting.elevationTolerance))
+    {
+        cerr << "ERR: error in simplifyElevationProfile" << endl;
+        return 1;
+    }
+    return 0;
+}
 
-                else if(curEli.parentRoad->predecessor.contactPoint == startType)
-                {
-                    curEli.curRoad->elevationOffset = elevationOffsetAtLink;
-                }
+/**
+ * @brief function replaces the elevation profile of a single road and recomputes only the affected part of the network:
+ *  the offsets of the road and of its spanning tree subtree are propagated again and only the polynoms of these roads are generated.
+ *  With the least squares solver all offsets depend on each other, so they are solved again and all roads are generated.
+ *  requires that generateElevationProfiles was called before
+ * 
+ * @param data      roadNetwork data
+ * @param roadId    id of the road with the changed elevation profile
+ * @param eps       new elevation profile (relative heights)
+ * @return int      error code
+ */
+int updateElevationProfile(roadNetwork &data, int roadId, const arenaVector<elevationProfile> &eps)
+{
+    elevationGraph &g = data.elevGraph;
 
-            }
+    if(g.nRoads != (int)data.roads.size() || g.offset.size() != g.edges.size() || g.roadIndex.count(roadId) == 0)
+    {
+        throwError("elevation graph is not up to date for road " + to_string(roadId));
+        return 1;
+    }
 
-            else if(curEli.curRoad->successor.contactPoint == endType)
-            {
-                double elevationOffsetAtLink = curEli.parentRoad->getRelativeElevationAt(1) + curEli.parentRoad->elevationOffset;
-                if(curEli.parentRoad->predecessor.contactPoint == startType)
-                {
-                    curEli.curRoad->elevationOffset = elevationOffsetAtLink;
-                }
+    int node = g.roadIndex[roadId];
+    road &r = data.roads[node];
 
-                else if(curEli.parentRoad->predecessor.contactPoint == endType)
-                {
-                    curEli.curRoad->elevationOffset = elevationOffsetAtLink - curEli.curRoad->getRelativeElevationAt(1);
+    r.elevationProfiles = eps;
+    std::sort(r.elevationProfiles.begin(), r.elevationProfiles.end());
+    if(checkElevationProfile(r))
+        return 1;
 
-                }
+    vector<int> changed;
+    if(setting.leastSquaresElevation)
+    {
+        if(propagateElevation(data) || solveElevationLeastSquares(data))
+        {
+            throwError("Could not solve elevation offsets");
+            return 1;
+        }
+        for(int i = 0; i < g.nRoads; i++)
+            changed.push_back(i);
+    }
+    else
+    {
+        propagateElevationFromNode(data, node, changed);
+    }
 
-            }
+    for(int i: changed)
+    {
+        if(generateRoadElevation(data.roads[i]))
+            return 1;
+    }
 
-            completededIds.push_back(curEli.curRoad->id);
-            if(curEli.curRoad->isConnectingRoad && curEli.curRoad->predecessor.id > -1 && !isIn(completededIds, curEli.curRoad->predecessor.id))
-            {
-                elevationLinkInformation newEli;
-                road *ppre;
-                if(curEli.curRoad->predecessor.elementType == roadType)
-                {
-                    findRoad(data.roads, ppre, curEli.curRoad->predecessor.id);
-                    newEli.curRoad = ppre;
-                    newEli.parentRoad = curEli.curRoad;
-                    newEli.parentLinkingPoint = endType;
+    return 0;
+}
 
-                    remaining.push(newEli);
-                }
-                else //TODO: linking to junction
-                {
-                    cout << "linking to junction\n";
-                    findRoad(data.roads, ppre, curEli.curRoad->predecessor.id);
-                    //process all in junction
-                    for(road &r: data.roads)
-                    {
-                        if(!r.isConnectingRoad && r.junction == curEli.curRoad->predecessor.id && !isIn(completededIds, r.id))
-                        {
-                            r.elevationOffset = curEli.curRoad->elevationOffset;
-                            completededIds.push_back(r.id);
-                        }
-                        if(r.isConnectingRoad && r.predecessor.id == curEli.curRoad->predecessor.id)//this is a connecting road that is generated by the junction as has the junction as predecessor
-                        {
-                            elevationLinkInformation junEli;
-                            junEli.curRoad = &r;
-                            junEli.parentRoad = curEli.curRoad;
-                            junEli.parentLinkingPoint = noneType;
-                            remaining.push(junEli);
-                        }
+/**
+ * @brief function generates the elevation profiles of all roads. The elevation offsets are propagated from the reference road over the road graph.
+ * 
+ * @param rootNode  root of the input xml
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int generateElevationProfiles(const DOMElement* rootNode, roadNetwork &data)
+{
+    //sanity checks
+    for(road &r: data.roads)
+    {
+        if(checkElevationProfile(r))
+            return 1;
+    }
 
-                    }
-                }
-            
-            }
+	DOMElement *links = getChildWithName(rootNode, "links");
+	if (links == NULL)
+	{
+		throwWarning("'links' are not specified in input file.\n\t -> skip segment linking", true);
+
+		return 0;
+	}
+
+	// define reference system
+    
+    //find ref road
+    int ref = -1;
+    for(int i = 0; i < (int)data.roads.size(); i++)
+    {
+        if(data.roads[i].inputSegmentId == data.refRoad)
+        {
+            ref = i;
         }
+    }
+    if(ref == -1)
+    {
+        throwError("Could not find reference road in elevation generation");
+        return -1;
+    }
+
+    data.refElev = 0;
+    if(attributeExits(links, "reElev"))
+        data.refElev = readIntAttrFromNode(links, "reElev"); // This tag is not yet defined. TODO: add this tag to xml scheme
 
+    if(buildElevationGraph(data, data.elevGraph))
+    {
+        throwError("Could not build elevation graph");
+        return 1;
+    }
+
+    data.elevGraph.root = ref;
+    data.elevGraph.rootOffset = data.refElev;
+
+    if(propagateElevation(data))
+        return 1;
+
+    if(setting.leastSquaresElevation && solveElevationLeastSquares(data))
+    {
+        throwError("Could not solve elevation offsets");
+        return 1;
     }
-   
   
     for(road &r:data.roads)
     {
-        for(elevationProfile &p: r.elevationProfiles)
-        {
-            p.tOffset += r.elevationOffset; //converts relative offset to absolute offset
-        }
-        if (generateElevationProfile(r.elevationProfiles))
-        {
-            cerr << "ERR: error in generateElevationProfile" << endl;
+        if (generateRoadElevation(r))
             return 1;
-        }
     }
 
+    return 0;
 }
-
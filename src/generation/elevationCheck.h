@@ -0,0 +1,353 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file elevationCheck.h
+ *
+ * @brief file contains methods to sample the generated elevation polynoms and to check their continuity
+ *
+ * @author Jannik Busse
+ * Contact: jannik.busse@rwth-aachen.de
+ *
+ */
+
+#pragma once
+#include "generation/elevation.h"
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief sampled elevation of a road
+ *
+ */
+struct elevationSamples
+{
+    vector<double> s;           // unit m, position along the road
+    vector<double> z;           // unit m, elevation
+    vector<double> grade;       // unit 1, dz/ds
+    vector<double> curvature;   // unit 1/m, vertical curvature
+};
+
+/**
+ * @brief result of the elevation check
+ *
+ */
+struct elevationReport
+{
+    int nSamples = 0;
+
+    double maxGrade = 0;        // max absolute grade of all roads
+    int maxGradeRoad = -1;      // road id where the max grade occurs
+    double maxGradeS = 0;       // s position where the max grade occurs
+    int gradeViolations = 0;    // number of roads exceeding the allowed grade
+
+    double maxHeightGap = 0;    // max elevation difference at a link
+    double maxGradeGap = 0;     // max grade difference at a link
+    int c0Violations = 0;
+    int c1Violations = 0;
+};
+
+/**
+ * @brief kernel evaluates a polynom at packed ds positions. The loop has no branches, so that the compiler can vectorize it
+ *
+ * @param p         elevation polynom
+ * @param ds        packed positions relative to the polynom start
+ * @param z         elevation
+ * @param grade     first derivation
+ * @param curvature vertical curvature
+ * @param n         number of positions
+ */
+void evaluateElevationKernel(const elevationPolynom &p, const double *ds, double *z, double *grade, double *curvature, int n)
+{
+    const double a = p.a;
+    const double b = p.b;
+    const double c = p.c;
+    const double d = p.d;
+
+    for (int k = 0; k < n; k++)
+    {
+        double x = ds[k];
+        double g = b + x * (2 * c + 3 * d * x);
+        double dd = 2 * c + 6 * d * x;
+        double q = 1 + g * g;
+
+        z[k] = a + x * (b + x * (c + d * x));
+        grade[k] = g;
+        curvature[k] = dd / (q * sqrt(q));
+    }
+}
+
+/**
+ * @brief samples the output elevation polynoms of a road
+ *
+ * @param r         road
+ * @param step      sample step (maximal sample step in adaptive mode)
+ * @param adaptive  if true, the step of each polynom is reduced such that a linear interpolation of the samples deviates less than setting.elevationTolerance
+ * @param res       sampled elevation
+ * @return int      error code
+ */
+int sampleElevation(road &r, double step, bool adaptive, elevationSamples &res)
+{
+    res.s.clear();
+    res.z.clear();
+    res.grade.clear();
+    res.curvature.clear();
+
+    if (step <= 0)
+    {
+        throwError("invalid sample step for elevation sampling");
+        return 1;
+    }
+
+    arenaVector<elevationPolynom> polys;
+    for (elevationProfile &ep : r.elevationProfiles)
+        polys.insert(polys.end(), ep.outputElevation.begin(), ep.outputElevation.end());
+
+    vector<double> ds;
+    for (int i = 0; i < (int)polys.size(); i++)
+    {
+        elevationPolynom &p = polys[i];
+        double end = (i + 1 < (int)polys.size()) ? polys[i + 1].s : r.length;
+        double len = end - p.s;
+        if (len <= 0)
+            continue;
+
+        double h = step;
+        if (adaptive)
+        {
+            // linear interpolation error is bounded by h^2 / 8 * max|z''|
+            double maxCurv = max(fabs(2 * p.c), fabs(2 * p.c + 6 * p.d * len));
+            if (maxCurv > 0)
+                h = min(step, sqrt(8 * setting.elevationTolerance / maxCurv));
+        }
+
+        // the last polynom includes the road end
+        int n = ceil(len / h);
+        bool last = (i + 1 == (int)polys.size());
+        ds.resize(n + last);
+        for (int k = 0; k < (int)ds.size(); k++)
+            ds[k] = len * k / n;
+
+        int offset = res.s.size();
+        res.s.resize(offset + ds.size());
+        res.z.resize(offset + ds.size());
+        res.grade.resize(offset + ds.size());
+        res.curvature.resize(offset + ds.size());
+
+        for (int k = 0; k < (int)ds.size(); k++)
+            res.s[offset + k] = p.s + ds[k];
+
+        evaluateElevationKernel(p, ds.data(), &res.z[offset], &res.grade[offset], &res.curvature[offset], ds.size());
+    }
+
+    return 0;
+}
+
+/**
+ * @brief computes elevation and grade at the start or end of a road. The grade points out of the road.
+ *
+ * @param r         road
+ * @param pos       contact point
+ * @param z         elevation at the contact point
+ * @param grade     grade in outward direction
+ * @return bool     false if the road has no elevation
+ */
+bool getElevationAtContactPoint(road &r, contactPointType pos, double &z, double &grade)
+{
+    const elevationPolynom *p = NULL;
+    for (elevationProfile &ep : r.elevationProfiles)
+    {
+        if (ep.outputElevation.size() == 0)
+            continue;
+        if (p == NULL || pos == endType)
+            p = &ep.outputElevation.back();
+        if (pos == startType)
+        {
+            p = &ep.outputElevation.front();
+            break;
+        }
+    }
+    if (p == NULL)
+        return false;
+
+    if (pos == endType)
+    {
+        evaluateElevationPolynom(*p, r.length, z, grade);
+    }
+    else
+    {
+        evaluateElevationPolynom(*p, 0, z, grade);
+        grade = -grade;
+    }
+    return true;
+}
+
+/**
+ * @brief checks elevation and grade continuity between two contact points
+ *
+ * @param a         first road
+ * @param posA      contact point at the first road
+ * @param b         second road
+ * @param posB      contact point at the second road
+ * @param checkC1   if true, also the grade is checked
+ * @param report    elevation report
+ */
+void checkElevationContinuity(road &a, contactPointType posA, road &b, contactPointType posB, bool checkC1, elevationReport &report)
+{
+    double zA, gA, zB, gB;
+    if (!getElevationAtContactPoint(a, posA, zA, gA) || !getElevationAtContactPoint(b, posB, zB, gB))
+        return;
+
+    double heightGap = fabs(zA - zB);
+    report.maxHeightGap = max(report.maxHeightGap, heightGap);
+    if (heightGap > setting.elevationTolerance)
+    {
+        report.c0Violations++;
+        throwWarning("elevation gap of " + to_string(heightGap) + " m between road " + to_string(a.id) + " and road " + to_string(b.id), true);
+    }
+
+    if (!checkC1)
+        return;
+
+    // outward grades of continuous roads cancel each other
+    double gradeGap = fabs(gA + gB);
+    report.maxGradeGap = max(report.maxGradeGap, gradeGap);
+    if (gradeGap > setting.gradeTolerance)
+    {
+        report.c1Violations++;
+        throwWarning("grade jump of " + to_string(gradeGap) + " between road " + to_string(a.id) + " and road " + to_string(b.id), true);
+    }
+}
+
+/**
+ * @brief function samples the elevation of all roads, reports the max grade and checks the continuity at all road links and junctions
+ *
+ * @param data      roadNetwork data
+ * @param report    elevation report
+ * @param step      sample step
+ * @param adaptive  adaptive sampling
+ * @return int      error code, 1 if a check failed
+ */
+int checkElevation(roadNetwork &data, elevationReport &report, double step = 1, bool adaptive = false)
+{
+    report = elevationReport();
+
+    // --- grade ---------------------------------------------------------------
+    elevationSamples samples;
+    for (road &r : data.roads)
+    {
+        if (sampleElevation(r, step, adaptive, samples))
+            return 1;
+
+        report.nSamples += samples.s.size();
+
+        double roadMax = 0;
+        int roadMaxIdx = -1;
+        for (int k = 0; k < (int)samples.grade.size(); k++)
+        {
+            if (fabs(samples.grade[k]) > roadMax)
+            {
+                roadMax = fabs(samples.grade[k]);
+                roadMaxIdx = k;
+            }
+        }
+
+        if (roadMaxIdx != -1 && roadMax > report.maxGrade)
+        {
+            report.maxGrade = roadMax;
+            report.maxGradeRoad = r.id;
+            report.maxGradeS = samples.s[roadMaxIdx];
+        }
+
+        if (roadMax > setting.maxGrade)
+        {
+            report.gradeViolations++;
+            throwWarning("grade of " + to_string(roadMax) + " exceeds the maximal grade in road " + to_string(r.id), true);
+        }
+    }
+
+    // --- continuity at links -------------------------------------------------
+    elevationGraph g;
+    if (buildElevationGraph(data, g))
+        return 1;
+
+    for (int u = 0; u < g.nRoads; u++)
+    {
+        for (elevationEdge &e : g.edges[u])
+        {
+            if (e.to >= g.nRoads || e.to <= u)
+                continue;
+            checkElevationContinuity(data.roads[u], e.fromPos, data.roads[e.to], e.toPos, true, report);
+        }
+    }
+
+    // all roads of a junction meet at the same elevation; grades are checked between connecting roads and the linked arms
+    for (int j = 0; j < (int)g.junctionMembers.size(); j++)
+    {
+        int junctionNode = g.nRoads + j;
+        int first = -1;
+        contactPointType firstPos = noneType;
+
+        for (int u : g.junctionMembers[j])
+        {
+            road &r = data.roads[u];
+
+            // contact points of the road at the junction; roads inside of the junction touch it with both ends
+            vector<contactPointType> positions;
+            if (r.junction == data.junctions[j].id)
+            {
+                positions.push_back(startType);
+                positions.push_back(endType);
+            }
+            else
+            {
+                for (elevationEdge &e : g.edges[u])
+                {
+                    if (e.to == junctionNode && find(positions.begin(), positions.end(), e.fromPos) == positions.end())
+                        positions.push_back(e.fromPos);
+                }
+            }
+
+            for (contactPointType pos : positions)
+            {
+                if (first == -1)
+                {
+                    first = u;
+                    firstPos = pos;
+                }
+                else if (u != first || pos != firstPos)
+                {
+                    checkElevationContinuity(data.roads[first], firstPos, r, pos, false, report);
+                }
+            }
+
+            if (r.isConnectingRoad)
+                continue;
+
+            link *links[2] = {&r.predecessor, &r.successor};
+            contactPointType linkPositions[2] = {startType, endType};
+            for (int k = 0; k < 2; k++)
+            {
+                if (links[k]->elementType != roadType || g.roadIndex.count(links[k]->id) == 0 || links[k]->contactPoint == noneType)
+                    continue;
+                road &arm = data.roads[g.roadIndex[links[k]->id]];
+                checkElevationContinuity(r, linkPositions[k], arm, links[k]->contactPoint, true, report);
+            }
+        }
+    }
+
+    if (!setting.suppressOutput)
+    {
+        cout << "\tElevation check: " << report.nSamples << " samples, max grade " << report.maxGrade << " in road " << report.maxGradeRoad
+             << ", max elevation gap " << report.maxHeightGap << " m, max grade jump " << report.maxGradeGap << endl;
+    }
+
+    if (report.gradeViolations > 0 || report.c0Violations > 0 || report.c1Violations > 0)
+        return 1;
+
+    return 0;
+}
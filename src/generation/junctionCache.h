@@ -0,0 +1,469 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file junctionCache.h
+ *
+ * @brief file contains the cache of the connecting roads of junctions
+ *
+ *      The connecting roads only depend on the ends of the arms, the lane ids which are connected and a few settings.
+ *      These inputs are written in a canonical form (arms numbered by their first use, no road or junction ids) as key.
+ *      Junctions are generated in their own frame (intersection point at the origin, reference road in x direction)
+ *      and placed later by linkSegments, so the cached roads are stored in the junction frame and only the ids are
+ *      replaced at a hit. Entries are kept in memory and, if a directory is set, in one file per entry.
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+
+#define JUNCTION_CACHE_VERSION 1
+
+extern settings setting;
+
+/**
+ * @brief byte buffer for the keys and entries of the junction cache; values are stored in the native byte order
+ *
+ */
+class cacheBuffer
+{
+public:
+    cacheBuffer() {}
+    cacheBuffer(const string &bytes) : bytes(bytes) {}
+
+    template <class T>
+    void put(const T &v) { bytes.append((const char *)&v, sizeof(T)); }
+
+    void putString(const string &s)
+    {
+        put((uint32_t)s.size());
+        bytes.append(s);
+    }
+
+    template <class T>
+    bool get(T &v)
+    {
+        if (pos + sizeof(T) > bytes.size())
+            return false;
+        memcpy(&v, bytes.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool getString(string &s)
+    {
+        uint32_t size;
+        if (!get(size) || pos + size > bytes.size())
+            return false;
+        s = bytes.substr(pos, size);
+        pos += size;
+        return true;
+    }
+
+    bool getString(internedString &s)
+    {
+        string tmp;
+        if (!getString(tmp))
+            return false;
+        s = tmp;
+        return true;
+    }
+
+    string bytes;
+    size_t pos = 0;
+};
+
+/**
+ * @brief 64 bit FNV-1a hash, used for the file names of the cache entries
+ */
+uint64_t fnvHash(const string &bytes)
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : bytes)
+    {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+void putGeometry(cacheBuffer &b, const geometry &g)
+{
+    b.put((int)g.type);
+    b.put(g.s);
+    b.put(g.x);
+    b.put(g.y);
+    b.put(g.hdg);
+    b.put(g.length);
+    b.put(g.c);
+    b.put(g.c1);
+    b.put(g.c2);
+}
+
+bool getGeometry(cacheBuffer &b, geometry &g)
+{
+    int type;
+    bool ok = b.get(type) && b.get(g.s) && b.get(g.x) && b.get(g.y) && b.get(g.hdg) && b.get(g.length) && b.get(g.c) && b.get(g.c1) && b.get(g.c2);
+    g.type = (geometryType)type;
+    return ok;
+}
+
+void putLane(cacheBuffer &b, const lane &l)
+{
+    b.put(l.id);
+    b.putString(l.type.str());
+    b.put(l.turnLeft);
+    b.put(l.turnStraight);
+    b.put(l.turnRight);
+    b.put(l.level);
+    b.put(l.speed);
+    b.put(l.w);
+    b.put(l.rm.s);
+    b.putString(l.rm.type.str());
+    b.putString(l.rm.weight.str());
+    b.putString(l.rm.color.str());
+    b.put(l.rm.width);
+    b.put(l.m.s);
+    b.putString(l.m.surface.str());
+    b.put(l.m.friction);
+    b.put(l.m.roughness);
+    b.put(l.preId);
+    b.put(l.sucId);
+}
+
+bool getLane(cacheBuffer &b, lane &l)
+{
+    return b.get(l.id) && b.getString(l.type) && b.get(l.turnLeft) && b.get(l.turnStraight) && b.get(l.turnRight) && b.get(l.level) &&
+           b.get(l.speed) && b.get(l.w) && b.get(l.rm.s) && b.getString(l.rm.type) && b.getString(l.rm.weight) && b.getString(l.rm.color) &&
+           b.get(l.rm.width) && b.get(l.m.s) && b.getString(l.m.surface) && b.get(l.m.friction) && b.get(l.m.roughness) && b.get(l.preId) && b.get(l.sucId);
+}
+
+void putLaneSection(cacheBuffer &b, const laneSection &sec)
+{
+    b.put(sec.id);
+    b.put(sec.s);
+    b.put(sec.o);
+    b.put((uint32_t)sec.lanes.size());
+    for (const lane &l : sec.lanes)
+        putLane(b, l);
+}
+
+bool getLaneSection(cacheBuffer &b, laneSection &sec)
+{
+    uint32_t n;
+    if (!(b.get(sec.id) && b.get(sec.s) && b.get(sec.o) && b.get(n)))
+        return false;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        lane l;
+        if (!getLane(b, l))
+            return false;
+        sec.lanes.push_back(l);
+    }
+    return true;
+}
+
+/**
+ * @brief function writes the part of an arm which is used by createRoadConnection
+ */
+void putArm(cacheBuffer &b, const road &r)
+{
+    b.put((int)r.predecessor.elementType);
+    b.put((int)r.successor.elementType);
+    b.put(r.length);
+    putGeometry(b, r.geometries.front());
+    putGeometry(b, r.geometries.back());
+    putLaneSection(b, r.laneSections.front());
+    putLaneSection(b, r.laneSections.back());
+}
+
+/**
+ * @brief function computes the canonical key of the connecting roads of a junction
+ *
+ * @param tasks     connecting roads
+ * @return string   key
+ */
+string junctionCacheKey(const vector<connectionTask> &tasks)
+{
+    cacheBuffer b;
+    b.put((int)JUNCTION_CACHE_VERSION);
+
+    // settings which are used by createRoadConnection and createLaneConnection
+    b.put(setting.minConnectingRoadLength);
+    b.put(setting.speed);
+    b.put(setting.width);
+
+    // arms are numbered by their first use
+    vector<const road *> arms;
+    auto armIndex = [&](const road *r) {
+        for (int i = 0; i < (int)arms.size(); i++)
+        {
+            if (arms[i] == r)
+                return i;
+        }
+        arms.push_back(r);
+        return (int)arms.size() - 1;
+    };
+
+    b.put((uint32_t)tasks.size());
+    for (const connectionTask &t : tasks)
+    {
+        b.put(armIndex(t.from));
+        b.put(armIndex(t.to));
+        b.put(t.fromId);
+        b.put(t.toId);
+        b.putString(t.laneMarkLeft.str());
+        b.putString(t.laneMarkRight.str());
+    }
+
+    b.put((uint32_t)arms.size());
+    for (const road *r : arms)
+        putArm(b, *r);
+
+    return b.bytes;
+}
+
+/**
+ * @brief cache of generated connecting roads; entries are stored serialized, so that they do not depend on the arena of a run
+ *
+ */
+class junctionGeometryCache
+{
+public:
+    /**
+     * @brief returns the entry of the key from memory or from the cache directory
+     *
+     * @param key       canonical key
+     * @param entry     serialized connecting roads
+     * @return bool     true if the entry was found
+     */
+    bool find(const string &key, string &entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        map<string, string>::iterator it = entries.find(key);
+        if (it != entries.end())
+        {
+            entry = it->second;
+            return true;
+        }
+
+        if (setting.junctionCacheDir.empty())
+            return false;
+
+        ifstream in(fileName(key), ios::binary);
+        if (!in)
+            return false;
+
+        cacheBuffer file(string((istreambuf_iterator<char>(in)), istreambuf_iterator<char>()));
+        string magic, fileKey;
+        if (!file.getString(magic) || magic != "JCACHE" || !file.getString(fileKey) || fileKey != key || !file.getString(entry))
+            return false;
+
+        entries[key] = entry;
+        return true;
+    }
+
+    /**
+     * @brief stores the entry in memory and, if a cache directory is set, as file
+     *
+     * @param key       canonical key
+     * @param entry     serialized connecting roads
+     */
+    void store(const string &key, const string &entry)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries[key] = entry;
+
+        if (setting.junctionCacheDir.empty())
+            return;
+
+        cacheBuffer file;
+        file.putString("JCACHE");
+        file.putString(key);
+        file.putString(entry);
+
+        // the file is renamed after writing, so that other processes never read an incomplete file
+        string name = fileName(key);
+        string tmp = name + ".tmp";
+        ofstream out(tmp, ios::binary | ios::trunc);
+        out.write(file.bytes.data(), file.bytes.size());
+        out.close();
+        if (!out || rename(tmp.c_str(), name.c_str()))
+        {
+            remove(tmp.c_str());
+            throwWarning("junction cache entry could not be written to " + name);
+        }
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+    }
+
+private:
+    string fileName(const string &key) const
+    {
+        char hash[17];
+        snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)fnvHash(key));
+        return setting.junctionCacheDir + "/" + hash + ".jcache";
+    }
+
+    map<string, string> entries;
+    std::mutex mutex;
+};
+
+/**
+ * @brief returns the junction cache; it is shared by all runs of the process
+ *
+ * @return junctionGeometryCache&   cache
+ */
+inline junctionGeometryCache &junctionCache()
+{
+    static junctionGeometryCache cache;
+    return cache;
+}
+
+/**
+ * @brief function decodes the connecting roads of a cache entry
+ *
+ * @param b         cache entry
+ * @param tasks     connecting roads
+ * @param junc      current junction
+ * @return bool     true if the entry is valid
+ */
+bool decodeCachedConnections(cacheBuffer &b, vector<connectionTask> &tasks, const junction &junc)
+{
+    for (connectionTask &t : tasks)
+    {
+        road &r = t.r;
+        int preType, preContact, sucType, sucContact;
+        uint32_t nGeo, nSec, nCon;
+
+        if (!(b.get(r.length) && b.get(preType) && b.get(preContact) && b.get(sucType) && b.get(sucContact) && b.get(nGeo)))
+            return false;
+
+        r.id = t.id;
+        r.inputSegmentId = t.inputSegmentId;
+        r.junction = junc.id;
+        r.predecessor.id = t.from->id;
+        r.predecessor.elementType = (linkType)preType;
+        r.predecessor.contactPoint = (contactPointType)preContact;
+        r.successor.id = t.to->id;
+        r.successor.elementType = (linkType)sucType;
+        r.successor.contactPoint = (contactPointType)sucContact;
+
+        for (uint32_t i = 0; i < nGeo; i++)
+        {
+            geometry g;
+            if (!getGeometry(b, g))
+                return false;
+            r.geometries.push_back(g);
+        }
+
+        if (!b.get(nSec))
+            return false;
+        for (uint32_t i = 0; i < nSec; i++)
+        {
+            laneSection sec;
+            if (!getLaneSection(b, sec))
+                return false;
+            r.laneSections.push_back(sec);
+        }
+
+        if (!b.get(nCon))
+            return false;
+        for (uint32_t i = 0; i < nCon; i++)
+        {
+            connection c;
+            int contactPoint;
+            if (!(b.get(contactPoint) && b.get(c.fromLane) && b.get(c.toLane)))
+                return false;
+            c.contactPoint = (contactPointType)contactPoint;
+            c.from = t.from->id;
+            c.to = t.id;
+            t.connections.push_back(c);
+        }
+        t.error = 0;
+    }
+    return b.pos == b.bytes.size();
+}
+
+/**
+ * @brief function fills the connecting roads from the cache; ids are taken from the tasks
+ *
+ * @param key       canonical key of the tasks
+ * @param tasks     connecting roads
+ * @param junc      current junction
+ * @return bool     true if the roads were found in the cache
+ */
+bool loadCachedConnections(const string &key, vector<connectionTask> &tasks, const junction &junc)
+{
+    string entry;
+    if (!junctionCache().find(key, entry))
+        return false;
+
+    cacheBuffer b(entry);
+    if (decodeCachedConnections(b, tasks, junc))
+        return true;
+
+    // invalid entries are treated as miss
+    for (connectionTask &t : tasks)
+    {
+        t.r = road();
+        t.connections.clear();
+    }
+    return false;
+}
+
+/**
+ * @brief function stores the generated connecting roads in the cache; nothing is stored if a road could not be generated
+ *
+ * @param key       canonical key of the tasks
+ * @param tasks     generated connecting roads
+ */
+void storeCachedConnections(const string &key, const vector<connectionTask> &tasks)
+{
+    cacheBuffer b;
+    for (const connectionTask &t : tasks)
+    {
+        if (t.error)
+            return;
+
+        const road &r = t.r;
+        b.put(r.length);
+        b.put((int)r.predecessor.elementType);
+        b.put((int)r.predecessor.contactPoint);
+        b.put((int)r.successor.elementType);
+        b.put((int)r.successor.contactPoint);
+
+        b.put((uint32_t)r.geometries.size());
+        for (const geometry &g : r.geometries)
+            putGeometry(b, g);
+
+        b.put((uint32_t)r.laneSections.size());
+        for (const laneSection &sec : r.laneSections)
+            putLaneSection(b, sec);
+
+        b.put((uint32_t)t.connections.size());
+        for (const connection &c : t.connections)
+        {
+            b.put((int)c.contactPoint);
+            b.put(c.fromLane);
+            b.put(c.toLane);
+        }
+    }
+    junctionCache().store(key, b.bytes);
+}
@@ -0,0 +1,369 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file junctionCheck.h
+ *
+ * @brief file contains methods to check the generated junctions for crossing lane borders
+ *
+ *      The roads of each junction are tessellated and the border segments are sorted into a grid,
+ *      so that only segments in the same cell are tested against each other. Reported are
+ *      - arms whose borders cross each other
+ *      - connecting roads which cross an arm they don't connect, i.e. leave the junction area
+ *      - connecting roads with the same start and end arm whose reference lines cross
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+#include <vector>
+#include <set>
+#include <unordered_map>
+
+/**
+ * @brief result of the check of one junction
+ *
+ */
+struct junctionDiagnostics
+{
+    int junction = -1;
+    int arms = 0;
+    int connectingRoads = 0;
+
+    int segments = 0;       // tessellated border segments
+    int tests = 0;          // segment pairs tested after the grid pruning
+
+    int armOverlaps = 0;    // pairs of arms whose borders cross
+    int areaViolations = 0; // pairs of connecting road and arm which is not connected by the road
+    int laneCrossings = 0;  // pairs of connecting roads with the same start and end arm which cross
+};
+
+/**
+ * @brief result of the junction check
+ *
+ */
+struct junctionReport
+{
+    vector<junctionDiagnostics> junctions;
+    int violations = 0;
+};
+
+/**
+ * @brief tessellated line of a road
+ *
+ */
+struct junctionCheckLine
+{
+    enum lineType
+    {
+        armBorder,
+        connectingBorder,
+        connectingReference
+    };
+
+    lineType type;
+    int road = -1;      // index in data.roads
+    int from = -1;      // start arm of a connecting road
+    int to = -1;        // end arm of a connecting road
+    vector<double> x;
+    vector<double> y;
+};
+
+/**
+ * @brief function samples the reference line or the outer border of a road
+ *
+ * @param r         road
+ * @param step      sample step
+ * @param side      0: reference line, 1: outer border of the left lanes, -1: outer border of the right lanes
+ * @param line      tessellated line
+ * @return int      error code
+ */
+int tessellateRoad(const road &r, double step, int side, junctionCheckLine &line)
+{
+    line.x.clear();
+    line.y.clear();
+
+    if (r.geometries.empty() || r.length <= 0)
+        return 0;
+
+    int n = max(1, (int)ceil(r.length / step));
+    int g = 0;
+    int sec = 0;
+    for (int k = 0; k <= n; k++)
+    {
+        double s = r.length * k / n;
+
+        while (g + 1 < (int)r.geometries.size() && r.geometries.s[g + 1] <= s)
+            g++;
+        while (sec + 1 < (int)r.laneSections.size() && r.laneSections[sec + 1].s <= s)
+            sec++;
+
+        geometry geo = r.geometries[g];
+        double x = geo.x;
+        double y = geo.y;
+        double hdg = geo.hdg;
+        curve(s - geo.s, geo, x, y, hdg, 1);
+
+        double t = 0;
+        if (side != 0 && !r.laneSections.empty())
+        {
+            const laneSection &ls = r.laneSections[sec];
+            int id = (side > 0) ? findMaxLaneId(ls) : findMinLaneId(ls);
+
+            double inner;
+            laneBorders(ls, id, s - ls.s, inner, t);
+        }
+
+        line.x.push_back(x - sin(hdg) * t);
+        line.y.push_back(y + cos(hdg) * t);
+    }
+    return 0;
+}
+
+/**
+ * @brief function tests two segments of tessellated lines for an intersection.
+ *      The segments are half-open, so a crossing at a point of a line is counted once and segments which only touch
+ *      at the end of one segment don't intersect, e.g. of lines with a common reference line.
+ *      The first point of a line is excluded as well, so lines with a common start point don't intersect.
+ *
+ * @param firstAB   true if the segment from a to b is the first segment of its line
+ * @param firstCD   true if the segment from c to d is the first segment of its line
+ * @return bool     true if the segments intersect
+ */
+bool segmentsIntersect(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy, bool firstAB, bool firstCD)
+{
+    double rx = bx - ax, ry = by - ay;
+    double qx = dx - cx, qy = dy - cy;
+
+    double denom = rx * qy - ry * qx;
+    if (denom == 0)
+        return false;
+
+    double t = ((cx - ax) * qy - (cy - ay) * qx) / denom;
+    double u = ((cx - ax) * ry - (cy - ay) * rx) / denom;
+
+    return (firstAB ? t > 0 : t >= 0) && t < 1 && (firstCD ? u > 0 : u >= 0) && u < 1;
+}
+
+/**
+ * @brief function decides which kind of violation a crossing between two lines is
+ *
+ * @param a         first line
+ * @param b         second line
+ * @return int      0: no violation, 1: arm overlap, 2: area violation, 3: lane crossing
+ */
+int junctionCheckConflict(const junctionCheckLine &a, const junctionCheckLine &b)
+{
+    if (a.road == b.road)
+        return 0;
+
+    if (a.type == junctionCheckLine::armBorder && b.type == junctionCheckLine::armBorder)
+        return 1;
+
+    if (a.type == junctionCheckLine::connectingBorder && b.type == junctionCheckLine::armBorder)
+        return (b.road != a.from && b.road != a.to) ? 2 : 0;
+    if (b.type == junctionCheckLine::connectingBorder && a.type == junctionCheckLine::armBorder)
+        return (a.road != b.from && a.road != b.to) ? 2 : 0;
+
+    if (a.type == junctionCheckLine::connectingReference && b.type == junctionCheckLine::connectingReference)
+        return (a.from == b.from && a.to == b.to) ? 3 : 0;
+
+    return 0;
+}
+
+/**
+ * @brief function checks one junction
+ *
+ * @param data      roadNetwork data
+ * @param junc      junction
+ * @param roadIndex index of each road id in data.roads
+ * @param step      sample step
+ * @param diag      diagnostics of the junction
+ * @return int      error code
+ */
+int checkJunction(const roadNetwork &data, const junction &junc, const map<int, int> &roadIndex, double step, junctionDiagnostics &diag)
+{
+    diag = junctionDiagnostics();
+    diag.junction = junc.id;
+
+    // --- collect the connecting roads and their arms -------------------------
+    vector<int> connecting;
+    vector<int> arms;
+    for (const connection &c : junc.connections)
+    {
+        map<int, int>::const_iterator it = roadIndex.find(c.to);
+        if (it == roadIndex.end() || find(connecting.begin(), connecting.end(), it->second) != connecting.end())
+            continue;
+        connecting.push_back(it->second);
+
+        const road &r = data.roads[it->second];
+        int ends[2] = {r.predecessor.id, r.successor.id};
+        for (int e : ends)
+        {
+            map<int, int>::const_iterator arm = roadIndex.find(e);
+            if (arm != roadIndex.end() && find(arms.begin(), arms.end(), arm->second) == arms.end())
+                arms.push_back(arm->second);
+        }
+    }
+    diag.arms = arms.size();
+    diag.connectingRoads = connecting.size();
+
+    // --- tessellate ----------------------------------------------------------
+    vector<junctionCheckLine> lines;
+    for (int a : arms)
+    {
+        for (int side : {1, -1})
+        {
+            junctionCheckLine line;
+            line.type = junctionCheckLine::armBorder;
+            line.road = a;
+            tessellateRoad(data.roads[a], step, side, line);
+            lines.push_back(line);
+        }
+    }
+    for (int c : connecting)
+    {
+        const road &r = data.roads[c];
+        map<int, int>::const_iterator from = roadIndex.find(r.predecessor.id);
+        map<int, int>::const_iterator to = roadIndex.find(r.successor.id);
+
+        for (int side : {1, -1, 0})
+        {
+            junctionCheckLine line;
+            line.type = (side == 0) ? junctionCheckLine::connectingReference : junctionCheckLine::connectingBorder;
+            line.road = c;
+            line.from = (from != roadIndex.end()) ? from->second : -1;
+            line.to = (to != roadIndex.end()) ? to->second : -1;
+            tessellateRoad(r, step, side, line);
+            lines.push_back(line);
+        }
+    }
+
+    // --- sort the segments into the grid -------------------------------------
+    // segments are (line, first point); the cell size is a multiple of the sample step
+    double cell = 4 * step;
+    vector<pair<int, int>> segments;
+    unordered_map<long long, vector<int>> grid;
+
+    auto cellKey = [](long long cx, long long cy) { return (long long)(((unsigned long long)cx << 32) ^ ((unsigned long long)cy & 0xffffffffULL)); };
+
+    for (int l = 0; l < (int)lines.size(); l++)
+    {
+        for (int k = 0; k + 1 < (int)lines[l].x.size(); k++)
+        {
+            const vector<double> &x = lines[l].x;
+            const vector<double> &y = lines[l].y;
+
+            int idx = segments.size();
+            segments.push_back(make_pair(l, k));
+
+            long long x0 = floor(min(x[k], x[k + 1]) / cell), x1 = floor(max(x[k], x[k + 1]) / cell);
+            long long y0 = floor(min(y[k], y[k + 1]) / cell), y1 = floor(max(y[k], y[k + 1]) / cell);
+            for (long long cx = x0; cx <= x1; cx++)
+                for (long long cy = y0; cy <= y1; cy++)
+                    grid[cellKey(cx, cy)].push_back(idx);
+        }
+    }
+    diag.segments = segments.size();
+
+    // --- test the segments of each cell --------------------------------------
+    set<pair<int, int>> reported;
+    for (auto &entry : grid)
+    {
+        const vector<int> &members = entry.second;
+        for (int u = 0; u < (int)members.size(); u++)
+        {
+            for (int v = u + 1; v < (int)members.size(); v++)
+            {
+                int la = segments[members[u]].first, ka = segments[members[u]].second;
+                int lb = segments[members[v]].first, kb = segments[members[v]].second;
+                const junctionCheckLine &a = lines[la];
+                const junctionCheckLine &b = lines[lb];
+
+                int conflict = junctionCheckConflict(a, b);
+                if (conflict == 0)
+                    continue;
+
+                pair<int, int> roads = make_pair(min(a.road, b.road), max(a.road, b.road));
+                if (reported.count(roads))
+                    continue;
+
+                // a pair of segments is only tested in the first cell of their common bounding box
+                double cx = max(min(a.x[ka], a.x[ka + 1]), min(b.x[kb], b.x[kb + 1]));
+                double cy = max(min(a.y[ka], a.y[ka + 1]), min(b.y[kb], b.y[kb + 1]));
+                if (cellKey(floor(cx / cell), floor(cy / cell)) != entry.first)
+                    continue;
+
+                diag.tests++;
+                if (!segmentsIntersect(a.x[ka], a.y[ka], a.x[ka + 1], a.y[ka + 1], b.x[kb], b.y[kb], b.x[kb + 1], b.y[kb + 1], ka == 0, kb == 0))
+                    continue;
+
+                reported.insert(roads);
+
+                string ids = "road " + to_string(data.roads[a.road].id) + " and road " + to_string(data.roads[b.road].id) + " in junction " + to_string(junc.id);
+                if (conflict == 1)
+                {
+                    diag.armOverlaps++;
+                    throwWarning("arms overlap: " + ids, true);
+                }
+                if (conflict == 2)
+                {
+                    diag.areaViolations++;
+                    throwWarning("connecting road leaves the junction area: " + ids, true);
+                }
+                if (conflict == 3)
+                {
+                    diag.laneCrossings++;
+                    throwWarning("connecting roads cross: " + ids, true);
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function checks all junctions of the road network for crossing lane borders
+ *
+ * @param data      roadNetwork data
+ * @param report    junction report with the diagnostics of each junction
+ * @param step      sample step of the tessellation
+ * @return int      error code, 1 if a check failed
+ */
+int checkJunctions(const roadNetwork &data, junctionReport &report, double step = 0.5)
+{
+    report = junctionReport();
+
+    map<int, int> roadIndex;
+    for (int k = 0; k < (int)data.roads.size(); k++)
+        roadIndex.insert(make_pair(data.roads[k].id, k));
+
+    for (const junction &junc : data.junctions)
+    {
+        junctionDiagnostics diag;
+        if (checkJunction(data, junc, roadIndex, step, diag))
+            return 1;
+
+        int violations = diag.armOverlaps + diag.areaViolations + diag.laneCrossings;
+        report.violations += violations;
+        report.junctions.push_back(diag);
+
+        if (!setting.suppressOutput)
+        {
+            cout << "\tJunction " << diag.junction << ": " << diag.arms << " arms, " << diag.connectingRoads << " connecting roads, "
+                 << diag.tests << " of " << diag.segments << " segments tested, " << violations << " violation(s)" << endl;
+        }
+    }
+
+    if (report.violations > 0)
+        return 1;
+
+    return 0;
+}
@@ -15,55 +15,20 @@
  *
  */
 
-#include "xjunction.h"
-#include "tjunction.h"
+#include "njunction.h"
 
 /**
- * @brief function takes the junction as input argument and calls the junction type function
+ * @brief function takes the junction as input argument and calls the junction generation
  * 
- * @param node  input data from the input file for the tjunction
+ * @param node  input data from the input file for the junction
  * @param data  roadNetwork structure where the generated roads and junctions are stored
  * @return int  error code
  */
 int junctionWrapper(const DOMElement* node, roadNetwork &data)
 {   
-
-    std::string type = X(node->getAttributeNode(X("type"))->getValue());
-
-    // check type of the junction (M = mainroad, A = accessroad)
-    int mode = 0;
-    if (type == "2M")
-        mode = 1;
-    if (type == "M2A")
-        mode = 1;
-    if (type == "4A")
-        mode = 1;
-    if (type == "MA")
-        mode = 2;
-    if (type == "3A")
-        mode = 2;
-
-    if (mode == 1)
-    {
-        if (xjunction(node, data))
-        {
-            cerr << "ERR: error in xjunction." << endl;
-            return 1;
-        }
-    }
-    if (mode == 2)
-    {
-
-        if (tjunction(node, data))
-        {
-            cerr << "ERR: error in tjunction." << endl;
-            return 1;
-        }
-    }
-
-    if (mode == 0)
+    if (njunction(node, data))
     {
-        cerr << "ERR: junction type is not defined correct." << endl;
+        cerr << "ERR: error in junction generation." << endl;
         return 1;
     }
     return 0;
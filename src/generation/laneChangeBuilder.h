@@ -0,0 +1,249 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file laneChangeBuilder.h
+ *
+ * @brief file contains a builder which collects all lane changes of a road and creates the lane sections in increasing s order
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+#pragma once
+#include <algorithm>
+
+int addTrafficIsland(const object &o, road &r);
+int addRoadWork(const object &o, road &r, int laneId);
+int laneWideningJunction(laneSection &first, double s, double ds, int turn, bool verschwenkung, bool restricted, laneSection &opening, laneSection &widening);
+
+/**
+ * @brief type of a lane change
+ *
+ */
+enum laneChangeType
+{
+    laneWideningChange,
+    laneDropChange,
+    restrictedWideningChange,
+    restrictedDropChange,
+    trafficIslandChange,
+    roadWorkChange,
+    junctionWideningChange
+};
+
+/**
+ * @brief lane change which is applied to the lane sections of a road
+ *
+ */
+struct laneChange
+{
+    laneChangeType type;
+    double start = 0;       // first s position which is affected, used for sorting
+    double s = 0;
+    double ds = 0;
+    double ds2 = 0;         // length of a restricted area
+    int laneId = 0;         // lane id of widenings, drops and roadworks; side of restricted areas; turn of junction widenings
+    bool outerLane = false; // outer lane of widenings; verschwenkung of junction widenings
+    bool restricted = false;
+    object o;               // traffic island or roadwork
+};
+
+/**
+ * @brief builder collects all lane changes of a road (lane widenings and drops, restricted areas, bus stops, roadworks, 
+ *      traffic islands and widenings at the junction), sorts them by s and creates the lane sections and their lane links
+ *      in one pass. Every change starts in the last lane section created before, so its sections are appended; 
+ *      a restricted area only rewrites the two sections of its widening or drop. Changes which overlap are rejected.
+ *      Changes at the same s keep the order in which they were added.
+ *      Widenings at the junction open the road at s = 0 and move the other sections by their length; they are put in front 
+ *      of the road at once in the order they were added, each one in front of the previous one.
+ *
+ */
+class laneChangeBuilder
+{
+public:
+    void addLaneWidening(int laneId, double s, double ds, bool outerLane)
+    {
+        laneChange c;
+        c.type = laneWideningChange;
+        c.start = s;
+        c.s = s;
+        c.ds = ds;
+        c.laneId = laneId;
+        c.outerLane = outerLane;
+        changes.push_back(c);
+    }
+
+    void addLaneDrop(int laneId, double s, double ds)
+    {
+        laneChange c;
+        c.type = laneDropChange;
+        c.start = s;
+        c.s = s;
+        c.ds = ds;
+        c.laneId = laneId;
+        changes.push_back(c);
+    }
+
+    void addRestrictedAreaWidening(int side, double s, double ds1, double ds2)
+    {
+        laneChange c;
+        c.type = restrictedWideningChange;
+        c.start = s;
+        c.s = s;
+        c.ds = ds1;
+        c.ds2 = ds2;
+        c.laneId = side;
+        changes.push_back(c);
+    }
+
+    void addRestrictedAreaDrop(int side, double s, double ds1, double ds2)
+    {
+        laneChange c;
+        c.type = restrictedDropChange;
+        c.start = s;
+        c.s = s;
+        c.ds = ds1;
+        c.ds2 = ds2;
+        c.laneId = side;
+        changes.push_back(c);
+    }
+
+    void addTrafficIsland(const object &o)
+    {
+        laneChange c;
+        c.type = trafficIslandChange;
+        c.start = o.s - o.length;
+        c.o = o;
+        changes.push_back(c);
+    }
+
+    void addRoadWork(const object &o, int laneId)
+    {
+        laneChange c;
+        c.type = roadWorkChange;
+        c.start = o.s;
+        c.o = o;
+        c.laneId = laneId;
+        changes.push_back(c);
+    }
+
+    void addJunctionWidening(double s, double ds, int turn, bool verschwenkung, bool restricted)
+    {
+        laneChange c;
+        c.type = junctionWideningChange;
+        c.s = s;
+        c.ds = ds;
+        c.laneId = turn;
+        c.outerLane = verschwenkung;
+        c.restricted = restricted;
+        junctionChanges.push_back(c);
+    }
+
+    bool empty() const { return changes.empty() && junctionChanges.empty(); }
+
+    /**
+     * @brief applies all collected changes in increasing s order and numbers the lane sections consecutively
+     *
+     * @param r     road data
+     * @return int  error code
+     */
+    int build(road &r)
+    {
+        if (empty())
+            return 0;
+
+        std::stable_sort(changes.begin(), changes.end(), [](const laneChange &a, const laneChange &b) { return a.start < b.start; });
+
+        arenaVector<laneSection> &secs = r.laneSections;
+
+        // a change creates at most four lane sections
+        secs.reserve(secs.size() + 4 * changes.size() + 2 * junctionChanges.size());
+
+        for (const laneChange &c : changes)
+        {
+            bool restrictedArea = (c.type == restrictedWideningChange || c.type == restrictedDropChange);
+            if (!restrictedArea && c.start < secs.back().s)
+            {
+                cerr << "ERR: lane change at s = " << c.start << " overlaps the lane change at s = " << secs.back().s << endl;
+                return 1;
+            }
+
+            if (c.type == laneWideningChange && ::addLaneWidening(secs, c.laneId, c.s, c.ds, c.outerLane))
+            {
+                cerr << "ERR: error in addLaneWidening" << endl;
+                return 1;
+            }
+            if (c.type == laneDropChange && ::addLaneDrop(secs, c.laneId, c.s, c.ds))
+            {
+                cerr << "ERR: error in addLaneDrop" << endl;
+                return 1;
+            }
+            if (c.type == restrictedWideningChange && ::addRestrictedAreaWidening(secs, c.laneId, c.s, c.ds, c.ds2))
+            {
+                cerr << "ERR: error in addRestrictedAreaWidening" << endl;
+                return 1;
+            }
+            if (c.type == restrictedDropChange && ::addRestrictedAreaDrop(secs, c.laneId, c.s, c.ds, c.ds2))
+            {
+                cerr << "ERR: error in addRestrictedAreaDrop" << endl;
+                return 1;
+            }
+            if (c.type == trafficIslandChange && ::addTrafficIsland(c.o, r))
+            {
+                cerr << "ERR: error in addTrafficIsland" << endl;
+                return 1;
+            }
+            if (c.type == roadWorkChange && ::addRoadWork(c.o, r, c.laneId))
+            {
+                cerr << "ERR: error in addRoadWork" << endl;
+                return 1;
+            }
+        }
+        changes.clear();
+
+        // each junction widening is created from the first section of the road so far and put in front of it
+        int n = junctionChanges.size();
+        arenaVector<laneSection> front(2 * n);
+        for (int k = 0; k < n; k++)
+        {
+            const laneChange &c = junctionChanges[k];
+            laneSection &first = (k == 0) ? secs.front() : front[2 * (n - k)];
+            if (::laneWideningJunction(first, c.s, c.ds, c.laneId, c.outerLane, c.restricted, front[2 * (n - 1 - k)], front[2 * (n - 1 - k) + 1]))
+            {
+                cerr << "ERR: error in laneWideningJunction" << endl;
+                return 1;
+            }
+        }
+        if (n > 0)
+            secs.insert(secs.begin(), front.begin(), front.end());
+
+        // s positions behind the junction widenings and ids in one pass
+        double offset = 0;
+        for (int k = 0; k < (int)secs.size(); k++)
+        {
+            if (k < 2 * n)
+            {
+                const laneChange &c = junctionChanges[n - 1 - k / 2];
+                secs[k].s = offset + ((k % 2 == 0) ? 0 : c.s);
+                if (k % 2 == 1)
+                    offset += c.s + c.ds;
+            }
+            else
+                secs[k].s += offset;
+
+            secs[k].id = secs[0].id + k;
+        }
+        junctionChanges.clear();
+
+        return 0;
+    }
+
+private:
+    vector<laneChange> changes;
+    vector<laneChange> junctionChanges;
+};
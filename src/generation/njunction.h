@@ -0,0 +1,570 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file njunction.h
+ *
+ * @brief file contains the generation of junctions with an arbitrary number of arms
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+extern settings setting;
+
+/**
+ * @brief input road of a junction
+ *
+ */
+struct junctionRoad
+{
+    int id = -1;
+    DOMElement *node = NULL;
+    bool main = false;      // "M" roads cross the junction and form two arms, "A" roads form one arm
+    double s = 0;           // s position of the intersection point on the road
+    double phi = 0;         // angle of the road at the intersection point
+    double sOffset = 0;     // gap between intersection point and the start of the arms
+};
+
+/**
+ * @brief arm of a junction: part of an input road which starts at the junction area and points away from it
+ *
+ */
+struct junctionArm
+{
+    int input = -1;         // index of the input road
+    int dir = 1;            // 1: arm in s direction of the input road, -1: arm against s direction
+    road r;
+};
+
+/**
+ * @brief function parses the junction type, e.g. "M2A" -> main road, access road, access road
+ *
+ * @param type          junction type consisting of "M" and "A", each optionally preceded by a count
+ * @param mainRoads     for each input road true if it is a main road
+ * @return int          error code
+ */
+int parseJunctionType(const string &type, vector<bool> &mainRoads)
+{
+    mainRoads.clear();
+
+    int count = 0;
+    bool hasCount = false;
+    for (char c : type)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            count = 10 * count + (c - '0');
+            hasCount = true;
+            continue;
+        }
+        if (c != 'M' && c != 'A')
+            return 1;
+
+        int n = hasCount ? count : 1;
+        if (n == 0)
+            return 1;
+        for (int i = 0; i < n; i++)
+            mainRoads.push_back(c == 'M');
+
+        count = 0;
+        hasCount = false;
+    }
+
+    if (hasCount || mainRoads.empty())
+        return 1;
+    return 0;
+}
+
+/**
+ * @brief function adds the connecting roads between two arms to the tasks
+ *
+ * @param from              incoming arm
+ * @param to                outgoing arm
+ * @param mode              lanes which are connected: -1 right lanes, 0 middle lanes, 1 left lanes
+ * @param solidFirst        if true, the first connection gets a solid road mark at its right side
+ * @param junc              junction
+ * @param inputSegmentId    input segment id
+ * @param nCount            counter of the connecting roads
+ * @param tasks             connecting roads which are generated afterwards
+ * @param ids               id allocator of the road network
+ * @return int              error code
+ */
+int connectArms(const road &from, const road &to, int mode, bool solidFirst, const junction &junc, int inputSegmentId, int &nCount, vector<connectionTask> &tasks, idAllocator &ids)
+{
+    int fromLane, toLane, nF, nT;
+    calcFromTo(from, to, fromLane, toLane, nF, nT, mode);
+
+    // right lanes are counted from the inside to the outside, all other lanes from the outside to the inside
+    int step = (mode == -1) ? -1 : 1;
+
+    for (int i = 0; i < min(nF, nT); i++)
+    {
+        connectionTask t;
+        t.from = &from;
+        t.to = &to;
+        t.fromId = fromLane;
+        t.toId = toLane;
+        t.laneMarkLeft = non;
+        t.laneMarkRight = (solidFirst && i == 0) ? sol : non;
+        t.id = ids.allocate(inputSegmentId, 100 * junc.id + 50 + nCount);
+        t.inputSegmentId = inputSegmentId;
+        tasks.push_back(std::move(t));
+
+        fromLane += step;
+        toLane -= step;
+        nCount++;
+    }
+    return 0;
+}
+
+/**
+ * @brief function adds the additional lanes of the junction which belong to an arm as widenings at the junction
+ *
+ * @param addLanes  additional lanes input data, can be NULL
+ * @param r         road of the arm
+ * @param changes   lane changes of the arm
+ * @return int      error code
+ */
+int addAdditionalLanes(DOMElement *addLanes, const road &r, laneChangeBuilder &changes)
+{
+    if (addLanes == NULL)
+        return 0;
+
+    for (DOMElement *addLane = addLanes->getFirstElementChild(); addLane != NULL; addLane = addLane->getNextElementSibling())
+    {
+        if (readNameFromNode(addLane) != "additionalLane") continue;
+
+        int inputId = readIntAttrFromNode(addLane, "roadId");
+
+        string inputPos = "end";
+        if (attributeExits(addLane, "roadPos"))
+            inputPos = readStrAttrFromNode(addLane, "roadPos");
+
+        if (inputId != r.inputId || inputPos != r.inputPos)
+            continue;
+
+        int n = 1;
+        if (attributeExits(addLane, "amount"))
+            n = readIntAttrFromNode(addLane, "amount");
+
+        bool verschwenkung = true;
+        if (attributeExits(addLane, "verschwenkung"))
+            verschwenkung = readBoolAttrFromNode(addLane, "verschwenkung");
+
+        double length = setting.laneChange.s;
+        if (attributeExits(addLane, "length"))
+            length = readDoubleAttrFromNode(addLane, "length");
+
+        double ds = setting.laneChange.ds;
+        if (attributeExits(addLane, "ds"))
+            length = readDoubleAttrFromNode(addLane, "ds");
+
+        int type = 0;
+        string tmpType = readStrAttrFromNode(addLane, "type");
+        if (tmpType == "left" || tmpType == "leftRestricted")
+            type = 1;
+        if (tmpType == "right" || tmpType == "rightRestricted")
+            type = -1;
+
+        bool restricted = false;
+        if (tmpType == "leftRestricted" || tmpType == "rightRestricted")
+            restricted = true;
+
+        for (int i = 0; i < n; i++)
+            changes.addJunctionWidening(length, ds, type, verschwenkung, restricted);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function generates the roads and junctions for a junction with an arbitrary number of arms which is specified in the input file
+ *
+ *      The first input road is the refRoad of the intersection point, the following roads are the adRoads in input order.
+ *      The arms are placed in slots; both arms of a main road are placed in opposite slots:
+ *          3 arms:  MA -> 1: M (against s), 2: M (in s), 3: A
+ *          4 arms: M2A -> 1: M (against s), 2: A1, 3: M (in s), 4: A2
+ *      The arms are sorted by their angle to the first arm and each arm is connected to all other arms:
+ *      first the middle lanes of all non neighbouring arms, then the right and left lanes of all neighbouring arms.
+ *
+ * @param domNode   input data from the input file for the junction
+ * @param data      roadNetwork structure where the generated roads and junctions are stored
+ * @return int      error code
+ */
+int njunction(const DOMElement *domNode, roadNetwork &data)
+{
+    // check type of the junction (here: M = mainroad, A = accessroad)
+    vector<bool> mainRoads;
+    if (parseJunctionType(readStrAttrFromNode(domNode, "type"), mainRoads))
+    {
+        cerr << "ERR: junction type is not defined correct." << endl;
+        return 1;
+    }
+
+    int nRoads = mainRoads.size();
+    int nArms = 0;
+    for (bool m : mainRoads)
+        nArms += m ? 2 : 1;
+
+    if (nArms < 3)
+    {
+        cerr << "ERR: junction needs at least three arms." << endl;
+        return 1;
+    }
+
+    // create segment
+    data.nSegment++;
+    junction junc;
+    junc.id = readIntAttrFromNode(domNode, "id");
+    int inputSegmentId = readIntAttrFromNode(domNode, "id");
+
+    // automatic widening
+    DOMElement *dummy = NULL;
+    DOMElement *automaticWidening = getChildWithName(domNode, "automaticWidening");
+
+    // t junctions use restricted automatic widenings; this is passed to the widening, the input stays unchanged
+    bool restrictedWidening = (nArms == 3);
+
+    // define intersection properties
+    DOMElement *iP = getChildWithName(domNode, "intersectionPoint");
+    if (iP == NULL)
+    {
+        cerr << "ERR: intersection point is not defined correct." << endl;
+        return 1;
+    }
+    DOMElement *cA = getChildWithName(getChildWithName(domNode, "coupler"), "junctionArea");
+    DOMElement *con = getChildWithName(getChildWithName(domNode, "coupler"), "connection");
+    DOMElement *addLanes = getChildWithName(getChildWithName(domNode, "coupler"), "additionalLanes");
+
+    // --- input roads ---------------------------------------------------------
+    vector<junctionRoad> roads(nRoads);
+    for (int k = 0; k < nRoads; k++)
+        roads[k].main = mainRoads[k];
+
+    roads[0].id = readIntAttrFromNode(iP, "refRoad");
+    roads[0].s = readDoubleAttrFromNode(iP, "s");
+
+    int k = 1;
+    for (DOMElement *ad = getChildWithName(iP, "adRoad"); ad != NULL && k < nRoads; ad = getNextSiblingWithTagName(ad, "adRoad"))
+    {
+        roads[k].id = readIntAttrFromNode(ad, "id");
+        roads[k].s = readDoubleAttrFromNode(ad, "s");
+        roads[k].phi = readDoubleAttrFromNode(ad, "angle");
+        k++;
+    }
+    if (k < nRoads)
+    {
+        cerr << "ERR: 'adRoad' " << k << " is missing." << endl;
+        return 1;
+    }
+
+    DOMNodeList *roadList = domNode->getElementsByTagName(X("road"));
+    for (int i = 0; i < (int)roadList->getLength(); i++)
+    {
+        DOMElement *road = (DOMElement *)roadList->item(i);
+        if (road->getNodeType() != 1) continue; //we have to check the node type. Type 1 is an element. The reason for the check is that line breaks are handled as
+        // text nodes by xercesC.
+
+        int roadID = readIntAttrFromNode(road, "id");
+        for (junctionRoad &jr : roads)
+        {
+            if (jr.id == roadID)
+                jr.node = road;
+        }
+    }
+
+    for (junctionRoad &jr : roads)
+    {
+        if (jr.node == NULL)
+        {
+            cerr << "ERR: specified roads in intersection are not found." << endl;
+            return 1;
+        }
+    }
+
+    // calculate offsets
+    double sOffset = 0;
+    if (cA)
+        sOffset = readDoubleAttrFromNode(cA, "gap");
+
+    for (junctionRoad &jr : roads)
+        jr.sOffset = sOffset;
+
+    if (cA != NULL) // there might be no coupler provided
+    {
+        for (DOMElement *it = cA->getFirstElementChild(); it != NULL; it = it->getNextElementSibling())
+        {
+            for (junctionRoad &jr : roads)
+            {
+                if (readIntAttrFromNode(it, "id") == jr.id)
+                    jr.sOffset = readDoubleAttrFromNode(it, "gap");
+            }
+        }
+    }
+
+    // calculate helper roads; there is one helper road per arm, arms without own input road have the default lanes
+    vector<double> widths(nArms);
+    vector<double> lengths(nArms);
+    for (int i = 0; i < nArms; i++)
+    {
+        road help;
+        if (buildRoad((i < nRoads) ? roads[i].node : NULL, help, 0, INFINITY, dummy, 0, 0, 0, 0))
+        {
+            cerr << "ERR: error in buildRoad" << endl;
+            return 1;
+        }
+
+        const laneSection &lS = help.laneSections.front();
+        widths[i] = abs(findTOffset(lS, findMinLaneId(lS), 0)) + abs(findTOffset(lS, findMaxLaneId(lS), 0));
+        lengths[i] = help.length;
+    }
+
+    // check offsets and adjust them if necessary (here: 4 is safty factor)
+    bool changed = false;
+    for (int i = 0; i < nRoads; i++)
+    {
+        double w = 0;
+        for (int j = 0; j < nArms; j++)
+        {
+            if (j != i)
+                w = max(w, widths[j] / 2);
+        }
+        w *= 4;
+
+        if (roads[i].sOffset < w)
+        {
+            roads[i].sOffset = w;
+            changed = true;
+        }
+    }
+
+    if (changed)
+    {
+        cerr << "!!! sOffset of at least one road was changed, due to feasible road structure !!!" << endl;
+    }
+
+    for (int i = 0; i < nRoads; i++)
+    {
+        if (roads[i].s > lengths[i])
+        {
+            cerr << "ERR: error in generating junction road. Intersection point is too close to the end of road " << roads[i].id << endl;
+            return 1;
+        }
+        if (roads[i].main && roads[i].s <= roads[i].sOffset)
+        {
+            cerr << "ERR: error in generating junction road. Intersection point is too close to the start of road " << roads[i].id << endl;
+            return 1;
+        }
+    }
+
+    // --- place arms in slots -------------------------------------------------
+    vector<junctionArm> arms(nArms);
+    vector<bool> used(nArms, false);
+    for (int i = 0; i < nRoads; i++)
+    {
+        int slot = 0;
+        while (used[slot])
+            slot++;
+
+        arms[slot].input = i;
+        arms[slot].dir = roads[i].main ? -1 : 1;
+        used[slot] = true;
+
+        if (roads[i].main)
+        {
+            int opposite = (slot + nArms / 2) % nArms;
+            while (used[opposite])
+                opposite = (opposite + 1) % nArms;
+
+            arms[opposite].input = i;
+            arms[opposite].dir = 1;
+            used[opposite] = true;
+        }
+    }
+
+    // coordinates of intersectionPoint
+    double iPx = 0;
+    double iPy = 0;
+    double iPhdg = 0;
+
+    // --- generate roads ------------------------------------------------------
+    if (!setting.suppressOutput)
+        cout << "\tGenerating roads" << endl;
+
+    for (int i = 0; i < nArms; i++)
+    {
+        junctionArm &a = arms[i];
+        const junctionRoad &jr = roads[a.input];
+
+        a.r.id = data.ids.allocate(inputSegmentId, 100 * junc.id + i + 1);
+        a.r.junction = junc.id;
+        a.r.inputSegmentId = inputSegmentId;
+        a.r.isConnectingRoad = true;
+        a.r.predecessor.id = junc.id;
+        a.r.predecessor.elementType = junctionType;
+
+        // the lane changes of the road, the additional lanes and the objects are applied at once in addObjects
+        laneChangeBuilder changes;
+
+        double sEnd = (a.dir == 1) ? INFINITY : 0;
+        if (buildRoad(jr.node, a.r, jr.s + a.dir * jr.sOffset, sEnd, automaticWidening, jr.s, iPx, iPy, iPhdg + jr.phi, restrictedWidening, &changes))
+        {
+            cerr << "ERR: error in buildRoad" << endl;
+            return 1;
+        }
+
+        if (addAdditionalLanes(addLanes, a.r, changes))
+        {
+            cerr << "ERR: error in additional lanes" << endl;
+            return 1;
+        }
+
+        if (addObjects(jr.node, a.r, data, changes))
+        {
+            cerr << "ERR: error in addObjects" << endl;
+            return 1;
+        }
+    }
+
+    //set the correct lane link id for the predecessor
+    for (junctionArm &a : arms)
+    {
+        for (laneSection &ls : a.r.laneSections)
+        {
+            for (lane &l : ls.lanes)
+            {
+                l.preId = -1; //the junction connecting road always use lane -1
+            }
+        }
+        data.roads.push_back(a.r);
+    }
+
+    // ---Generating Connecting Lanes -------------------------------------------
+    if (!setting.suppressOutput)
+        cout << "\tGenerating Connecting Lanes" << endl;
+
+    // connecting roads are collected first and generated in parallel
+    vector<connectionTask> tasks;
+
+    // --- generate user-defined connecting lanes
+    if (con != NULL && readStrAttrFromNode(con, "type") == "single")
+    {
+        // t junctions draw solid road marks at user-defined connections by default
+        string defaultMark = (nArms == 3) ? sol : non;
+
+        for (DOMElement *roadLink = con->getFirstElementChild(); roadLink != NULL; roadLink = roadLink->getNextElementSibling())
+        {
+            if (readNameFromNode(roadLink) != "roadLink") continue;
+
+            int fromId = readIntAttrFromNode(roadLink, "fromId");
+            int toId = readIntAttrFromNode(roadLink, "toId");
+
+            string fromPos = "end";
+            if (attributeExits(roadLink, "fromPos"))
+                fromPos = readStrAttrFromNode(roadLink, "fromPos");
+
+            string toPos = "end";
+            if (attributeExits(roadLink, "toPos"))
+                toPos = readStrAttrFromNode(roadLink, "toPos");
+
+            int i1 = -1;
+            int i2 = -1;
+            for (int i = 0; i < (int)data.roads.size(); i++)
+            {
+                if (data.roads[i].inputId == fromId && data.roads[i].inputPos == fromPos)
+                    i1 = i;
+                if (data.roads[i].inputId == toId && data.roads[i].inputPos == toPos)
+                    i2 = i;
+            }
+            if (i1 == -1 || i2 == -1)
+            {
+                cerr << "ERR: error in user-defined lane connecting:" << endl;
+                cerr << "\t road to 'fromId' or 'toId' can not be found" << endl;
+                return 1;
+            }
+
+            for (DOMElement *laneLink = roadLink->getFirstElementChild(); laneLink != NULL; laneLink = laneLink->getNextElementSibling())
+            {
+                if (readNameFromNode(laneLink) != "laneLink") continue;
+
+                int from = readIntAttrFromNode(laneLink, "fromId");
+                int to = readIntAttrFromNode(laneLink, "toId");
+
+                // flip ids
+                if (fromPos == "start")
+                    from *= -1;
+                if (toPos == "end")
+                    to *= -1;
+
+                internedString left = defaultMark;
+                internedString right = defaultMark;
+
+                if (attributeExits(laneLink, "left"))
+                    left = readStrAttrFromNode(laneLink, "left");
+
+                if (attributeExits(laneLink, "right"))
+                    right = readStrAttrFromNode(laneLink, "right");
+
+                connectionTask t;
+                t.from = &data.roads[i1];
+                t.to = &data.roads[i2];
+                t.fromId = from;
+                t.toId = to;
+                t.laneMarkLeft = left;
+                t.laneMarkRight = right;
+                t.id = data.ids.allocate(inputSegmentId, 100 * junc.id + data.roads.size() + tasks.size() + 1);
+                t.inputSegmentId = inputSegmentId;
+                tasks.push_back(std::move(t));
+            }
+        }
+    }
+    // generate automatic connecting lanes
+    else
+    {
+        // sort arms by their angle to the first arm
+        vector<const road *> sorted;
+        for (junctionArm &a : arms)
+            sorted.push_back(&a.r);
+
+        if (sortRoads(sorted))
+        {
+            cerr << "ERR: roads can not be sorted." << endl;
+            return 1;
+        }
+
+        int nCount = 1;
+
+        // middle lanes of all arms which are not neighbours
+        for (int d = 2; d <= nArms - 2; d++)
+        {
+            for (int i = 0; i < nArms; i++)
+                connectArms(*sorted[i], *sorted[(i + d) % nArms], 0, false, junc, inputSegmentId, nCount, tasks, data.ids);
+        }
+
+        // right lanes to the next arm and left lanes back from it
+        for (int i = 0; i < nArms; i++)
+        {
+            const road &a = *sorted[i];
+            const road &b = *sorted[(i + 1) % nArms];
+
+            connectArms(a, b, -1, true, junc, inputSegmentId, nCount, tasks, data.ids);
+            connectArms(b, a, 1, false, junc, inputSegmentId, nCount, tasks, data.ids);
+        }
+    }
+
+    if (createRoadConnections(tasks, junc, data))
+    {
+        cerr << "ERR: error in createRoadConnections" << endl;
+        return 1;
+    }
+
+    data.junctions.push_back(std::move(junc));
+
+    return 0;
+}
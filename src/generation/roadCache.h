@@ -0,0 +1,165 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file roadCache.h
+ *
+ * @brief file contains a per-run cache of the parsed road input elements
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+#include <map>
+
+/**
+ * @brief parsed data of a road input element. Junctions and roundabouts build several arms and helper roads
+ *      from the same element; they are cut from this data instead of reading the DOM again.
+ *
+ */
+struct roadTemplate
+{
+    // full reference line starting at the origin; x, y and hdg are the start poses as integrated along the reference line
+    arenaVector<geometry> geometries;
+    double length = 0;
+
+    // basic lane section for mode 1 (in s direction) and mode 2 (flipped)
+    bool lanesParsed[2] = {false, false};
+    laneSection lanes[2];
+
+    // result of buildRoad(roadIn, r, 0, INFINITY, NULL, 0, 0, 0, 0)
+    bool fullBuilt = false;
+    road full;
+};
+
+/**
+ * @brief cache of the road templates keyed by the input element.
+ *      The keys are only valid as long as the input DOM exists, so the cache has to be cleared after each run.
+ *
+ */
+class roadTemplateCache
+{
+public:
+    /**
+     * @brief returns the template of the road element; the reference line is parsed at the first request
+     *
+     * @param roadIn            road input data
+     * @return roadTemplate&    template
+     */
+    roadTemplate &get(DOMElement *roadIn)
+    {
+        map<DOMElement *, roadTemplate>::iterator it = templates.find(roadIn);
+        if (it != templates.end())
+            return it->second;
+
+        roadTemplate &t = templates[roadIn];
+        if (roadIn != NULL)
+            parseReferenceLine(roadIn, t);
+        return t;
+    }
+
+    void clear() { templates.clear(); }
+
+private:
+    /**
+     * @brief function reads all geometries of the reference line and integrates their start poses
+     *
+     * @param roadIn    road input data
+     * @param t         template
+     */
+    static void parseReferenceLine(DOMElement *roadIn, roadTemplate &t)
+    {
+        double s = 0;
+        double x = 0;
+        double y = 0;
+        double hdg = 0;
+
+        DOMNodeList *referenceLines = getChildWithName(roadIn, "referenceLine")->getChildNodes();
+        for (int i = 0; i < (int)referenceLines->getLength(); i++)
+        {
+            DOMElement *it = (DOMElement *)referenceLines->item(i);
+            if (it->getNodeType() != 1) //1 is an Element Node
+                continue;
+
+            geometryType type;
+            double c = 0, c1 = 0, c2 = 0;
+            double R = 0, R1 = 0, R2 = 0;
+
+            // define type
+            if (readNameFromNode(it) == "line")
+                type = line;
+            if (readNameFromNode(it) == "spiral")
+                type = spiral;
+            if (readNameFromNode(it) == "arc")
+                type = arc;
+            if (readNameFromNode(it) == "circle")
+                type = arc;
+
+            double length = readDoubleAttrFromNode(it, "length");
+
+            // define radi and curvatures
+            if (type == spiral)
+            {
+                R1 = readDoubleAttrFromNode(it, "Rs");
+                R2 = readDoubleAttrFromNode(it, "Re");
+                if (R1 != 0)
+                    c1 = 1 / R1;
+                if (R2 != 0)
+                    c2 = 1 / R2;
+            }
+            if (type == arc)
+            {
+                R = readDoubleAttrFromNode(it, "R");
+                if (R != 0)
+                    c = 1 / R;
+            }
+
+            geometry geo;
+            geo.s = s;
+            geo.x = x;
+            geo.y = y;
+            geo.hdg = hdg;
+            geo.length = length;
+            geo.c = c;
+            geo.c1 = c1;
+            geo.c2 = c2;
+            geo.type = type;
+            t.geometries.push_back(geo);
+
+            curve(length, geo, x, y, hdg, 1);
+            s += length;
+        }
+        t.length = s;
+    }
+
+    map<DOMElement *, roadTemplate> templates;
+};
+
+/**
+ * @brief returns the road cache of the current thread
+ *
+ * @return roadTemplateCache&   cache
+ */
+inline roadTemplateCache &roadCache()
+{
+    static thread_local roadTemplateCache cache;
+    return cache;
+}
+
+/**
+ * @brief binds the road cache of the current thread to one run: the cache is cleared when the object is created and
+ *      destroyed, also on error paths, so no template outlives the input DOM and the arena of the run
+ *
+ */
+class roadCacheScope
+{
+public:
+    roadCacheScope() { roadCache().clear(); }
+    ~roadCacheScope() { roadCache().clear(); }
+};
@@ -19,17 +19,135 @@ extern settings setting;
 
 
 /**
- * @brief translates the input segment id and the index of the junction inside the roundabout to an absolute junction id
+ * @brief translates the input segment id and the index of the junction inside the roundabout to an absolute junction id;
+ *      the id follows the naming scheme and is passed to the id allocator, which replaces it if it is taken
  * 
  * @param juncGroupId input id of the segment. Equals the id of the junction group
  * @param juncIdx index of the junction inside the roundabout. Starts with 0 and counting up
- * @return int resulting id of the junction in the output file
+ * @return int id of the junction following the naming scheme
  */
 int juncGroupIdToJuncId(int juncGroupId, int juncIdx)
 {
     return juncGroupId * 10000 + juncIdx * 100;
 }
 
+/**
+ * @brief arm of a roundabout, parsed once from an intersection point and its additional road
+ * 
+ */
+struct roundAboutArm
+{
+    DOMElement* input = NULL;   // input element of the additional road
+    int id = -1;                // input id of the additional road
+    double sMain = 0;           // s of the intersection point on the circle
+    double sAdd = 0;            // s of the intersection point on the additional road
+    double phi = 0;             // angle of the additional road relative to the circle
+};
+
+/**
+ * @brief function parses the intersection points of a roundabout in one pass over the input element
+ *      the arms are sorted by their position on the circle
+ * 
+ * @param node      input data from the input file for the roundAbout
+ * @param refId     id of the circle road
+ * @param length    length of the circle road
+ * @param arms      parsed arms
+ * @return int      error code
+ */
+int parseRoundAboutArms(const DOMElement* node, int refId, double length, vector<roundAboutArm> &arms)
+{
+    map<int, DOMElement*> roads;
+    vector<DOMElement*> points;
+    for (DOMElement* child = node->getFirstElementChild(); child != NULL; child = child->getNextElementSibling())
+    {
+        string name = readNameFromNode(child);
+        if (name == "road")
+            roads[readIntAttrFromNode(child, "id")] = child;
+        else if (name == "intersectionPoint")
+            points.push_back(child);
+    }
+
+    for (DOMElement* iP : points)
+    {
+        DOMElement* adRoad = getChildWithName(iP, "adRoad");
+
+        roundAboutArm arm;
+        arm.id = readIntAttrFromNode(adRoad, "id");
+        arm.sMain = readDoubleAttrFromNode(iP, "s");
+        arm.sAdd = readDoubleAttrFromNode(adRoad, "s");
+        arm.phi = readDoubleAttrFromNode(adRoad, "angle");
+
+        map<int, DOMElement*>::iterator it = roads.find(arm.id);
+        if (it == roads.end())
+        {
+            cerr << "ERR: specified road in intersection " << arms.size() + 1 << " is not found." << endl;
+            return 1;
+        }
+        arm.input = it->second;
+
+        //sanity checks
+        if (arm.sMain > length)
+        {
+            throwError("Interesection point s from ref road "+ to_string(refId)  
+                + " to add road " + to_string(arm.id) + " is larger than the ref road's length");
+            return 1;
+        }
+        if (arm.sAdd > roadCache().get(arm.input).length)
+        {
+            throwError("Interesection point s from adRoad "+ to_string(arm.id)  
+                + " to ref road " + to_string(refId) + " is larger than the add road's length");
+            return 1;
+        }
+
+        arms.push_back(arm);
+    }
+
+    // the ring segments are cut between neighbouring arms, so the arms have to follow the circle
+    stable_sort(arms.begin(), arms.end(), [](const roundAboutArm &a, const roundAboutArm &b) { return a.sMain < b.sMain; });
+
+    return 0;
+}
+
+/**
+ * @brief function cuts a segment of the circle road of a roundabout
+ *      without lane changes on the circle the segment is cut directly from the parsed circle, otherwise it is built from the input element
+ * 
+ * @param circleRoad    input data of the circle road
+ * @param ring          full circle road
+ * @param laneChanges   true if the circle road has user defined lane changes
+ * @param r             road data of the segment
+ * @param sStart        starting s position
+ * @param sEnd          ending s position
+ * @param s0            position of s where x0, y0, phi0 should be reached
+ * @param x0            reference x position
+ * @param y0            reference y position
+ * @param phi0          reference angle
+ * @return int          error code
+ */
+int cutRingSegment(DOMElement* circleRoad, const road &ring, bool laneChanges, road &r, double sStart, double sEnd, double s0, double x0, double y0, double phi0)
+{
+    if (laneChanges || sEnd < sStart)
+        return buildRoad(circleRoad, r, sStart, sEnd, NULL, s0, x0, y0, phi0);
+
+    r.classification = ring.classification;
+    r.inputId = ring.inputId;
+    r.inputPos = "end";
+
+    if (cutGeometries(roadCache().get(circleRoad), r, sStart, sEnd))
+    {
+        cerr << "ERR: error in cutGeometries";
+        return 1;
+    }
+    if (shiftGeometries(r, sStart, sEnd, s0, x0, y0, phi0))
+    {
+        cerr << "ERR: error in shiftGeometries";
+        return 1;
+    }
+    r.laneSections.push_back(ring.laneSections.front());
+
+    return 0;
+}
+
 /**
  * @brief function generates the roads and junctions for a roundabout which is specified in the input file
  *  
@@ -41,7 +159,7 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
 {
     // create segment
     data.nSegment++;
-    vector<junction> junctions;
+    arenaVector<junction> junctions;
     junctionGroup juncGroup;
 
     juncGroup.id = readIntAttrFromNode(node, "id"); 
@@ -51,18 +169,19 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
 
     DOMElement* dummy = NULL;
     DOMElement* circleRoad = getChildWithName(node, "circle");
-    int refId = readIntAttrFromNode(circleRoad, "id");
 
     if (!circleRoad)
     {
         cerr << "ERR: circleRoad is not found.";
         return 1;
     }
+    int refId = readIntAttrFromNode(circleRoad, "id");
 
     // store properties of circleRoad
-    double length = readDoubleAttrFromNode(getChildWithName(getChildWithName(circleRoad, "referenceLine"), "circle"),"length") ;
+    DOMElement* circle = getChildWithName(getChildWithName(circleRoad, "referenceLine"), "circle");
+    double length = readDoubleAttrFromNode(circle, "length");
     double R = length / (2 * M_PI);
-    getChildWithName(getChildWithName(circleRoad, "referenceLine"), "circle")->setAttribute(X("R"), X(to_string(R).c_str()));
+    circle->setAttribute(X("R"), X(to_string(R).c_str()));
     
 
     double sOld;
@@ -79,111 +198,89 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         return 1;
     }
 
-    // get coupler
+    // parse all intersection points first
+    vector<roundAboutArm> arms;
+    if (parseRoundAboutArms(node, refId, length, arms))
+    {
+        cerr << "ERR: error in parseRoundAboutArms" << endl;
+        return 1;
+    }
+    int nIp = arms.size();
+
+    // get coupler and read the gaps of all roads
     DOMElement* cA = getChildWithName(getChildWithName(node, "coupler"), "junctionArea");
 
-    // count intersectionPoints
-    int nIp = 0;
-    for (DOMElement* child = node->getFirstElementChild(); child != NULL; child = child->getNextElementSibling())
+    double sOffset = 0;
+    if (cA)
+        sOffset = readDoubleAttrFromNode(cA, "gap");
+
+    double sOffRing = sOffset;
+    map<int, double> roadGaps;
+    if (cA != NULL)
     {
-        if(readNameFromNode(child) == "intersectionPoint")
+        for (DOMElement* sB = cA->getFirstElementChild(); sB != NULL; sB = sB->getNextElementSibling())
         {
-            nIp++;
+            if(readNameFromNode(sB) != "roadGap")
+            {
+                continue;
+            }
+
+            if (readIntAttrFromNode(sB, "id") == refId)
+                sOffRing = readDoubleAttrFromNode(sB, "gap");
+
+            roadGaps[readIntAttrFromNode(sB, "id")] = readDoubleAttrFromNode(sB, "gap");
         }
     }
 
-    //generate all junctions first for easier linking
-    int cc = 0;
-    for (DOMElement* iP = node->getFirstElementChild(); iP != NULL; iP = iP->getNextElementSibling())
+    // build the circle once; the ring segments are cut from it
+    road helpMain;
+    if (buildRoad(circleRoad, helpMain, 0, INFINITY, dummy, 0, 0, 0, 0))
+    {
+        cerr << "ERR: error in buildRoad" << endl;
+        return 1;
+    }
+    bool ringLaneChanges = circleRoad->getElementsByTagName(X("laneWidening"))->getLength() > 0 ||
+                           circleRoad->getElementsByTagName(X("laneDrop"))->getLength() > 0;
+
+    laneSection lSMain = helpMain.laneSections.front();
+    double widthMain = abs(findTOffset(lSMain, findMinLaneId(lSMain), 0));
+
+    //generate all junctions first for easier linking; the ring road in front of each junction is also the helper of the previous junction
+    vector<int> ringIds;
+    for (const roundAboutArm &arm : arms)
     {
-        if(readNameFromNode(iP) != "intersectionPoint")
-        {
-            continue;
-        }
-        int adId = stoi(readAttributeFromChildren(iP, "adRoad", "id"));
         junction junc;
-        junc.id = juncGroupIdToJuncId(juncGroup.id, adId);
-        cc++;
+        junc.id = data.ids.allocateJunction(inputSegmentId, juncGroupIdToJuncId(juncGroup.id, arm.id));
         junctions.push_back(junc);
         juncGroup.juncIds.push_back(junc.id);
-        
+        ringIds.push_back(data.ids.allocate(inputSegmentId, junc.id + 1));
     }
 
-    cc = 0;
     // iterate over all additonalRoads defined by separate intersectionPoints
-    // sMain of intersection points have to increase
-    for (DOMElement* iP = node->getFirstElementChild(); iP != NULL; iP = iP->getNextElementSibling())
+    for (int cc = 1; cc <= nIp; cc++)
     {
+        const roundAboutArm &arm = arms[cc - 1];
+        junction &junc = junctions[cc - 1];
 
-        if(readNameFromNode(iP) != "intersectionPoint")
-        {
-            continue;
-        }
-        junction &junc = junctions[cc];
-        cc++;
-
-        // find additionalRoad
-        int adId = stoi(readAttributeFromChildren(iP, "adRoad", "id"));
-        
-        DOMElement* additionalRoad;
-        for (DOMElement* road = node->getFirstElementChild(); road != NULL; road = road->getNextElementSibling())
-        {
-            if(readNameFromNode(road) != "road")
-            {
-                continue;
-            }
-            if (readIntAttrFromNode(road, "id") == adId)
-                additionalRoad = road;
-        }
-
-        if (additionalRoad == NULL)
-        {
-            cerr << "ERR: specified road in intersection" << cc << " is not found.";
-            return 1;
-        }
+        DOMElement* additionalRoad = arm.input;
+        int adId = arm.id;
 
         // calculate offsets
-        double sOffset = 0;
-        if (cA)
-            sOffset = readDoubleAttrFromNode(cA, "gap");
-
-        double sOffMain = sOffset;
+        double sOffMain = sOffRing;
         double sOffAdd = sOffset;
 
-        if(cA != NULL)
-        {
-            for (DOMElement* sB = cA->getFirstElementChild(); sB != NULL; sB = sB->getNextElementSibling())
-            {
-                if(readNameFromNode(sB) != "roadGap")
-                {
-                    continue;
-                }
-
-                if (readIntAttrFromNode(sB, "id") == refId)
-                    sOffMain = readDoubleAttrFromNode(sB, "gap");
-
-                if (readIntAttrFromNode(sB, "id") == adId)
-                    sOffAdd = readDoubleAttrFromNode(sB, "gap");
-            }
-        }
+        map<int, double>::iterator gap = roadGaps.find(adId);
+        if (gap != roadGaps.end())
+            sOffAdd = gap->second;
 
-        // calculate width of circleRoad and addtionalRoad
-        road helpMain;
+        // calculate width of addtionalRoad
         road helpAdd;
-        if (buildRoad(circleRoad, helpMain, 0, INFINITY, dummy, 0, 0, 0, 0))
-        {
-            cerr << "ERR: error in buildRoad" << endl;
-            return 1;
-        }
         if (buildRoad(additionalRoad, helpAdd, 0, INFINITY, dummy, 0, 0, 0, 0))
         {
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
 
-        laneSection lSMain = helpMain.laneSections.front();
-        double widthMain = abs(findTOffset(lSMain, findMinLaneId(lSMain), 0));
-
         laneSection lSAdd = helpAdd.laneSections.front();
         double widthAdd = abs(findTOffset(lSAdd, findMinLaneId(lSAdd), 0)) + abs(findTOffset(lSAdd, findMaxLaneId(lSAdd), 0));
 
@@ -211,35 +308,10 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
             return 1;
         }
 
-        // calculate s and phi at intersection
-        double sMain = readDoubleAttrFromNode(iP, "s");
-        double sAdd = readDoubleAttrFromNode(getChildWithName(iP, "adRoad"), "s");
-        double phi = readDoubleAttrFromNode(getChildWithName(iP, "adRoad"), "angle");
-
-        //sanity checks
-        if(sMain > length)
-        {
-            throwError("Interesection point s from ref road "+ to_string(refId)  
-                + " to add road " + to_string(adId) + " is larger than the ref road's length");
-            return 1;
-        }
-        //fint the length of the add road
-        double adLength = 0;
-        for (DOMElement* child = node->getFirstElementChild(); child != NULL; child = child->getNextElementSibling())
-        {
-                if(readNameFromNode(child) == "road" && readIntAttrFromNode(child, "id") == adId)
-                {
-                    adLength = readDoubleAttrFromNode(getFirstChildFromNode(getFirstChildFromNode(child)), "length");
-                }
-        }
-
-        if(sAdd > adLength)
-        {
-            throwError("Interesection point s from adRoad "+ to_string(adId)  
-                + " to ref road " + to_string(refId) + " is larger than the add road's length");
-            return 1;
-        }
-        //------end sanity checks
+        // s and phi at intersection
+        double sMain = arm.sMain;
+        double sAdd = arm.sAdd;
+        double phi = arm.phi;
 
         // calculate coordinates of intersectionPoint
         double curPhi = sMain / (2 * M_PI * R) * 2 * M_PI;
@@ -261,7 +333,7 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         int nCount = 1;
 
         road r1;
-        r1.id = junc.id + nCount;
+        r1.id = ringIds[cc - 1];
         r1.junction = -1;
         r1.inputSegmentId = inputSegmentId;
         r1.roundAboutInputSegment = juncGroup.id;
@@ -278,9 +350,9 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         if (cc == 1)
             sOld = sOffMain;
 
-        if (buildRoad(circleRoad, r1, sOld, sMain - sOffMain, dummy, sMain, iPx, iPy, iPhdg))
+        if (cutRingSegment(circleRoad, helpMain, ringLaneChanges, r1, sOld, sMain - sOffMain, sMain, iPx, iPy, iPhdg))
         {
-            cerr << "ERR: error in buildRoad" << endl;
+            cerr << "ERR: error in cutRingSegment" << endl;
             return 1;
         }
         nCount++;
@@ -290,7 +362,7 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         r2.roundAboutInputSegment = juncGroup.id;
         r2.inputSegmentId = inputSegmentId;
 
-        r2.id = junc.id + nCount;
+        r2.id = data.ids.allocate(inputSegmentId, junc.id + nCount);
         r2.junction = juncGroup.id; //storing the junction like this is a workaround for the problem with the id namespace. It needs to be this way
         //so there wont be a problem in linking and closing the road network
         r2.predecessor.id = junc.id;
@@ -298,12 +370,14 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         r2.predecessor.contactPoint = startType;
 
         r2.isConnectingRoad = true;
-        if (buildRoad(additionalRoad, r2, sAdd + sOffAdd, INFINITY, dummy, sAdd, iPx, iPy, iPhdg + phi))
+        // the lane changes of the road and of its objects are applied at once in addObjects
+        laneChangeBuilder changes;
+        if (buildRoad(additionalRoad, r2, sAdd + sOffAdd, INFINITY, dummy, sAdd, iPx, iPy, iPhdg + phi, false, &changes))
         {
             cerr << "ERR: error in buildRoad" << endl;
             return 1;
         }
-        if (addObjects(additionalRoad, r2, data))
+        if (addObjects(additionalRoad, r2, data, changes))
         {
             cerr << "ERR: error in addObjects" << endl;
             return 1;
@@ -314,13 +388,13 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         //addSignal(r2, data, 1, INFINITY, "1.000.001", "-", -1);
 
         road helper;
-        helper.id = junctions[(cc)%nIp].id + nCount - 2 ;
+        helper.id = ringIds[cc % nIp];
         helper.junction = junc.id;
         if (cc < nIp)
         {
-            if (buildRoad(circleRoad, helper, sMain + sOffMain, sMain + 2 * sOffMain, dummy, sMain, iPx, iPy, iPhdg))
+            if (cutRingSegment(circleRoad, helpMain, ringLaneChanges, helper, sMain + sOffMain, sMain + 2 * sOffMain, sMain, iPx, iPy, iPhdg))
             {
-                cerr << "ERR: error in buildRoad" << endl;
+                cerr << "ERR: error in cutRingSegment" << endl;
                 return 1;
             }
         }
@@ -387,7 +461,7 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
             road r;
             r.roundAboutInputSegment = juncGroup.id;
             r.inputSegmentId = inputSegmentId;
-            r.id = junc.id + nCount;
+            r.id = data.ids.allocate(inputSegmentId, junc.id + nCount);
 
             if (clockwise)
             {
@@ -408,12 +482,12 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
                 to--;
             }
 
-            data.roads.push_back(r); //these are the connecting roads in the roundabout 
+            data.roads.push_back(std::move(r)); //these are the connecting roads in the roundabout 
             nCount++;
         }
 
         road r5;
-        r5.id = junc.id  + nCount;
+        r5.id = data.ids.allocate(inputSegmentId, junc.id + nCount);
         r5.inputSegmentId = inputSegmentId;
 
         r5.roundAboutInputSegment = juncGroup.id;
@@ -443,7 +517,7 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         road r6;
         r6.roundAboutInputSegment = juncGroup.id;
         r6.inputSegmentId = inputSegmentId;
-        r6.id = junc.id + nCount;
+        r6.id = data.ids.allocate(inputSegmentId, junc.id + nCount);
         if (clockwise)
         {
             if (r2_T_R != 0)
@@ -476,9 +550,9 @@ int roundAbout(const DOMElement* node, roadNetwork &data)
         //end correcting lane links
 
         data.roads.push_back(r1);
-        data.roads.push_back(r2);
-        data.roads.push_back(r5);
-        data.roads.push_back(r6);
+        data.roads.push_back(std::move(r2));
+        data.roads.push_back(std::move(r5));
+        data.roads.push_back(std::move(r6));
 
         // update for next step
         sOld = sMain + sOffMain;
@@ -22,6 +22,10 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <map>
+#include <algorithm>
+#include <unordered_set>
+#include <iterator>
 #include <cmath>
 #include <ctime>
 
@@ -38,14 +42,23 @@ std::string::size_type st;
 using namespace std;
 
 #include "utils/settings.h"
+#include "utils/allocTracker.h"
+#include "utils/arena.h"
+#include "utils/idAllocator.h"
 #include "utils/interface.h"
 #include "utils/helper.h"
+#include "utils/rigidTransform.h"
 #include "utils/xml.h"
+#include "utils/laneGraph.h"
+#include "utils/parallel.h"
 #include "generation/buildSegments.h"
+#include "generation/elevationCheck.h"
+#include "generation/junctionCheck.h"
 #include "connection/linkSegments.h"
 #include "connection/closeRoadNetwork.h"
 
 settings setting;
+runArena _arena;
 
 EXPORTED void setFileName(char* file){
 	_fileName = file;
@@ -55,6 +68,39 @@ EXPORTED void setOverwriteLog(bool b){
 	setting.overwriteLog = b;
 }
 
+EXPORTED void setLeastSquaresElevation(bool b){
+	setting.leastSquaresElevation = b;
+}
+
+EXPORTED void setElevationCheck(bool b){
+	setting.checkElevation = b;
+}
+
+EXPORTED void setElevationSampling(double step, bool adaptive){
+	setting.elevationSampleStep = step;
+	setting.adaptiveElevationSampling = adaptive;
+}
+
+EXPORTED void setJunctionCheck(bool b){
+	setting.checkJunctions = b;
+}
+
+EXPORTED void setLaneGraphExport(bool b){
+	setting.exportLaneGraph = b;
+}
+
+EXPORTED void setThreads(int threads){
+	setting.threads = threads;
+}
+
+EXPORTED void setJunctionCache(bool b){
+	setting.junctionCache = b;
+}
+
+EXPORTED void setJunctionCacheDir(char* dir){
+	setting.junctionCacheDir = dir;
+}
+
 EXPORTED void setLogFile(char* file){
 	_logfile = file;
 }
@@ -108,6 +154,10 @@ EXPORTED int executePipeline(char* file)
 
 	// --- initialization ------------------------------------------------------
 
+	// all containers of the roadNetwork are placed in the arena of the run; the memory of the previous run is reused
+	_arena.reset();
+	arenaScope scope(_arena);
+
 	xmlTree inputxml;
 
 	roadNetwork data;
@@ -119,30 +169,37 @@ EXPORTED int executePipeline(char* file)
 	
 	// --- pipeline ------------------------------------------------------------
 
+	// the counters are reported when the run ends, also at an error
+	ALLOC_TRACKER_SCOPE();
 
+	ALLOC_STAGE("validateInput");
 	if (validateInput(file, inputxml))
 	{
 		cerr << "ERR: error in validateInput" << endl;
 		return -1;
 	}
 
+	ALLOC_STAGE("buildSegments");
 	if (buildSegments(inputxml.getRootElement(), data))
 	{
 		cerr << "ERR: error in buildSegments" << endl;
 		return -1;
 	}
+	ALLOC_STAGE("linkSegments");
 	if (linkSegments(inputxml.getRootElement(), data))
 	{
 		cerr << "ERR: error in linkSegments" << endl;
 		return -1;
 	}
 
+	ALLOC_STAGE("generateElevationProfiles");
 	if (generateElevationProfiles(inputxml.getRootElement(), data))
 	{
 		cerr << "ERR: error in generateElevationPforiles" << endl;
 		return -1;
 	}
 	
+	ALLOC_STAGE("closeRoadNetwork");
 	if (closeRoadNetwork(inputxml.getRootElement(), data))
 	{
 		cerr << "ERR: error in closeRoadNetwork" << endl;
@@ -151,12 +208,46 @@ EXPORTED int executePipeline(char* file)
 
 	//resolveLaneLinkConflicts(data);
 
+	if (setting.checkJunctions)
+	{
+		ALLOC_STAGE("checkJunctions");
+		junctionReport report;
+		if (checkJunctions(data, report))
+		{
+			cerr << "ERR: error in checkJunctions" << endl;
+			return -1;
+		}
+	}
+
+	if (setting.checkElevation)
+	{
+		ALLOC_STAGE("checkElevation");
+		elevationReport report;
+		if (checkElevation(data, report, setting.elevationSampleStep, setting.adaptiveElevationSampling))
+		{
+			cerr << "ERR: error in checkElevation" << endl;
+			return -1;
+		}
+	}
+
+	ALLOC_STAGE("createXML");
 	if (createXMLXercesC(data))
 	{
 		cerr << "ERR: error during createXML" << endl;
 		return -1;
 	}
 
+	if (setting.exportLaneGraph)
+	{
+		ALLOC_STAGE("exportLaneGraph");
+		if (exportLaneGraph(data))
+		{
+			cerr << "ERR: error in exportLaneGraph" << endl;
+			return -1;
+		}
+	}
+
+	ALLOC_STAGE("validateOutput");
 	if (validateOutput(data))
 	{
 		cerr << "ERR: error in validateOutput" << endl;
@@ -173,6 +264,7 @@ EXPORTED int executePipeline(char* file)
 
 	//Cleanup ----------------
 
+	ALLOC_STAGE("terminateXMLUtils");
 	terminateXMLUtils();
 
 	return 0;
@@ -78,6 +78,57 @@ extern "C" EXPORTED void setSilentMode(bool sMode);
  */
 extern "C" EXPORTED void setOverwriteLog(bool b);
 
+/**
+ * @brief enables the least squares elevation solver. All elevation offsets are solved at once, which removes height discontinuities in looped networks
+ * @param b true if the least squares solver should be used
+ */
+extern "C" EXPORTED void setLeastSquaresElevation(bool b);
+
+/**
+ * @brief enables the elevation check. The generated elevation is sampled and checked for max grade and continuity at all links. 
+ *  The pipeline returns an error if a check fails
+ * @param b true if the elevation should be checked
+ */
+extern "C" EXPORTED void setElevationCheck(bool b);
+
+/**
+ * @brief sets the sampling of the elevation check
+ * @param step      sample step in m, the max step if adaptive is set
+ * @param adaptive  true if the step of curved elevation polynoms should be reduced, so that the samples deviate less than the elevation tolerance
+ */
+extern "C" EXPORTED void setElevationSampling(double step, bool adaptive);
+
+/**
+ * @brief enables the junction check. The roads of each junction are tessellated and checked for overlapping arms,
+ *  connecting roads which leave the junction area and crossing connecting roads. The pipeline returns an error before the output is written if a check fails
+ * @param b true if the junctions should be checked
+ */
+extern "C" EXPORTED void setJunctionCheck(bool b);
+
+/**
+ * @brief enables the export of the lane level graph. The graph is written as binary file <output>.lanegraph next to the .xodr file
+ * @param b true if the lane graph should be exported
+ */
+extern "C" EXPORTED void setLaneGraphExport(bool b);
+
+/**
+ * @brief sets the number of worker threads, e.g. for the connecting roads of a junction
+ * @param threads number of threads, 0 uses the number of hardware threads and 1 disables the parallel generation
+ */
+extern "C" EXPORTED void setThreads(int threads);
+
+/**
+ * @brief enables the junction cache. Connecting roads of junctions which are identical to a junction of a previous run are reused instead of generated again
+ * @param b true if the junction cache should be used
+ */
+extern "C" EXPORTED void setJunctionCache(bool b);
+
+/**
+ * @brief sets the directory of the persistent junction cache. Each cache entry is stored as file, so that the cache is shared by several processes
+ * @param dir existing directory, an empty string keeps the cache in memory only
+ */
+extern "C" EXPORTED void setJunctionCacheDir(char* dir);
+
 
 
 #endif
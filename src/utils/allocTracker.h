@@ -0,0 +1,390 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file allocTracker.h
+ *
+ * @brief file contains an optional heap allocation tracker which attributes allocations to pipeline stages and segments
+ *
+ *      the tracker is only compiled in if TRACK_ALLOCATIONS is defined (cmake option TRACK_ALLOCATIONS).
+ *      It replaces the global operator new/delete and interposes malloc/calloc/realloc/free and the aligned allocations,
+ *      so that also the allocations of the Xerces DOM are counted. Without TRACK_ALLOCATIONS all macros expand to nothing.
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+
+#ifdef TRACK_ALLOCATIONS
+
+#ifndef __GLIBC__
+#error "TRACK_ALLOCATIONS requires glibc (__libc_malloc and malloc_usable_size)"
+#endif
+
+#include <malloc.h>
+#include <errno.h>
+#include <new>
+#include <chrono>
+#include <cstdio>
+
+#define MAX_TRACKED_STAGES 16
+#define MAX_TRACKED_SEGMENTS 512
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+extern "C" void *__libc_valloc(size_t size);
+extern "C" void *__libc_pvalloc(size_t size);
+
+/**
+ * @brief allocation counters of one stage or segment
+ *      byte values are usable sizes as reported by malloc_usable_size
+ *
+ */
+struct allocStats
+{
+    long allocs;
+    long frees;
+    long bytes;
+    long peakLive;  // max live bytes during the stage, relative to the start of the run
+    double time;    // unit ms
+};
+
+/**
+ * @brief state of the tracker. All members are zero initialized, so that the hooks can be called before any constructor ran
+ *
+ */
+struct allocTrackerState
+{
+    const char *stageNames[MAX_TRACKED_STAGES];
+    allocStats stages[MAX_TRACKED_STAGES];
+    int nStages;
+    int stage;      // current stage, -1 before the first stage
+
+    int segmentIds[MAX_TRACKED_SEGMENTS];
+    allocStats segments[MAX_TRACKED_SEGMENTS];
+    int nSegments;
+    int segment;    // current segment slot, -1 outside of segments
+
+    long live;
+    bool active;
+
+    std::chrono::steady_clock::time_point stageStart;
+};
+
+allocTrackerState _allocTracker;
+
+/**
+ * @brief counts an allocation
+ *
+ * @param ptr   allocated memory
+ */
+void trackAllocation(void *ptr)
+{
+    if (ptr == NULL || !_allocTracker.active)
+        return;
+
+    long size = malloc_usable_size(ptr);
+    _allocTracker.live += size;
+
+    if (_allocTracker.stage != -1)
+    {
+        allocStats &s = _allocTracker.stages[_allocTracker.stage];
+        s.allocs++;
+        s.bytes += size;
+        if (_allocTracker.live > s.peakLive)
+            s.peakLive = _allocTracker.live;
+    }
+    if (_allocTracker.segment != -1)
+    {
+        allocStats &s = _allocTracker.segments[_allocTracker.segment];
+        s.allocs++;
+        s.bytes += size;
+        if (_allocTracker.live > s.peakLive)
+            s.peakLive = _allocTracker.live;
+    }
+}
+
+/**
+ * @brief counts a deallocation. Has to be called before the memory is released
+ *
+ * @param ptr   memory which will be released
+ */
+void trackDeallocation(void *ptr)
+{
+    if (ptr == NULL || !_allocTracker.active)
+        return;
+
+    _allocTracker.live -= malloc_usable_size(ptr);
+
+    if (_allocTracker.stage != -1)
+        _allocTracker.stages[_allocTracker.stage].frees++;
+    if (_allocTracker.segment != -1)
+        _allocTracker.segments[_allocTracker.segment].frees++;
+}
+
+// --- hooks ----------------------------------------------------------------------
+
+extern "C" void *malloc(size_t size)
+{
+    void *ptr = __libc_malloc(size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+extern "C" void *calloc(size_t n, size_t size)
+{
+    void *ptr = __libc_calloc(n, size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    trackDeallocation(ptr);
+    void *res = __libc_realloc(ptr, size);
+    trackAllocation(res);
+    return res;
+}
+
+extern "C" void free(void *ptr)
+{
+    trackDeallocation(ptr);
+    __libc_free(ptr);
+}
+
+// aligned allocations are released by free, so they have to be counted as well; otherwise live underflows
+extern "C" int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr == NULL)
+        return ENOMEM;
+    trackAllocation(ptr);
+    *memptr = ptr;
+    return 0;
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+extern "C" void *memalign(size_t alignment, size_t size)
+{
+    void *ptr = __libc_memalign(alignment, size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+extern "C" void *valloc(size_t size)
+{
+    void *ptr = __libc_valloc(size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+extern "C" void *pvalloc(size_t size)
+{
+    void *ptr = __libc_pvalloc(size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+void *operator new(size_t size)
+{
+    void *ptr = __libc_malloc(size == 0 ? 1 : size);
+    if (ptr == NULL)
+        throw std::bad_alloc();
+    trackAllocation(ptr);
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    void *ptr = __libc_malloc(size == 0 ? 1 : size);
+    trackAllocation(ptr);
+    return ptr;
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    trackDeallocation(ptr);
+    __libc_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    operator delete(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    operator delete(ptr);
+}
+
+// --- control --------------------------------------------------------------------
+
+/**
+ * @brief function closes the current stage and stores its time
+ *
+ */
+void allocTrackerCloseStage()
+{
+    if (_allocTracker.stage == -1)
+        return;
+
+    std::chrono::duration<double, std::milli> dt = std::chrono::steady_clock::now() - _allocTracker.stageStart;
+    _allocTracker.stages[_allocTracker.stage].time += dt.count();
+    _allocTracker.stage = -1;
+}
+
+/**
+ * @brief function resets all counters and starts tracking
+ *
+ */
+void allocTrackerStart()
+{
+    _allocTracker.active = false;
+    _allocTracker.nStages = 0;
+    _allocTracker.stage = -1;
+    _allocTracker.nSegments = 0;
+    _allocTracker.segment = -1;
+    _allocTracker.live = 0;
+    _allocTracker.active = true;
+}
+
+/**
+ * @brief function sets the stage all following allocations are attributed to
+ *
+ * @param name  name of the stage (has to be a string literal)
+ */
+void allocTrackerSetStage(const char *name)
+{
+    allocTrackerCloseStage();
+    _allocTracker.segment = -1;
+
+    int i;
+    for (i = 0; i < _allocTracker.nStages; i++)
+        if (_allocTracker.stageNames[i] == name)
+            break;
+
+    if (i == _allocTracker.nStages)
+    {
+        if (i == MAX_TRACKED_STAGES)
+            return;
+        _allocTracker.stageNames[i] = name;
+        _allocTracker.stages[i] = allocStats();
+        _allocTracker.stages[i].peakLive = _allocTracker.live;
+        _allocTracker.nStages++;
+    }
+
+    _allocTracker.stage = i;
+    _allocTracker.stageStart = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief function sets the segment all following allocations are attributed to
+ *
+ * @param id    input id of the segment, -1 to leave the segment
+ */
+void allocTrackerSetSegment(int id)
+{
+    _allocTracker.segment = -1;
+    if (id == -1)
+        return;
+
+    int i;
+    for (i = 0; i < _allocTracker.nSegments; i++)
+        if (_allocTracker.segmentIds[i] == id)
+            break;
+
+    if (i == _allocTracker.nSegments)
+    {
+        if (i == MAX_TRACKED_SEGMENTS)
+            return;
+        _allocTracker.segmentIds[i] = id;
+        _allocTracker.segments[i] = allocStats();
+        _allocTracker.segments[i].peakLive = _allocTracker.live;
+        _allocTracker.nSegments++;
+    }
+
+    _allocTracker.segment = i;
+}
+
+/**
+ * @brief function stops tracking and prints the counters of all stages and segments
+ *      printf is used, so that the report itself does not allocate through iostreams
+ *
+ */
+void allocTrackerReport()
+{
+    allocTrackerCloseStage();
+    _allocTracker.active = false;
+
+    printf("\nAllocations per stage:\n");
+    printf("\t%-28s %10s %10s %10s %14s %14s\n", "stage", "time [ms]", "allocs", "frees", "bytes", "peak live");
+    for (int i = 0; i < _allocTracker.nStages; i++)
+    {
+        allocStats &s = _allocTracker.stages[i];
+        printf("\t%-28s %10.2f %10ld %10ld %14ld %14ld\n", _allocTracker.stageNames[i], s.time, s.allocs, s.frees, s.bytes, s.peakLive);
+    }
+
+    printf("Allocations per segment:\n");
+    printf("\t%-28s %10s %10s %10s %14s %14s\n", "segment", "", "allocs", "frees", "bytes", "peak live");
+    for (int i = 0; i < _allocTracker.nSegments; i++)
+    {
+        allocStats &s = _allocTracker.segments[i];
+        printf("\t%-28d %10s %10ld %10ld %14ld %14ld\n", _allocTracker.segmentIds[i], "", s.allocs, s.frees, s.bytes, s.peakLive);
+    }
+}
+
+/**
+ * @brief starts tracking when created and prints the report when destroyed, so that runs which stop at an error are reported as well
+ *
+ */
+class allocTrackerScope
+{
+public:
+    allocTrackerScope() { allocTrackerStart(); }
+    ~allocTrackerScope() { allocTrackerReport(); }
+};
+
+#define ALLOC_TRACKER_SCOPE() allocTrackerScope _allocTrackerScope
+#define ALLOC_STAGE(name) allocTrackerSetStage(name)
+#define ALLOC_SEGMENT(id) allocTrackerSetSegment(id)
+
+#else
+
+#define ALLOC_TRACKER_SCOPE()
+#define ALLOC_STAGE(name)
+#define ALLOC_SEGMENT(id)
+
+#endif
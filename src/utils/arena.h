@@ -0,0 +1,213 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file arena.h
+ *
+ * @brief file contains a monotonic arena for the contents of the roadNetwork and the corresponding allocator
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+#pragma once
+#include <vector>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+
+/**
+ * @brief monotonic arena: memory is handed out from large blocks and only released all at once.
+ *      The blocks are kept on reset, so that following runs reuse them without calling malloc.
+ *
+ */
+class runArena
+{
+public:
+    runArena(size_t blockSize = 1 << 20) : blockSize(blockSize) {}
+    ~runArena() { release(); }
+
+    runArena(const runArena &) = delete;
+    runArena &operator=(const runArena &) = delete;
+
+    /**
+     * @brief returns aligned memory from the current block; a new block is used if the current one is exhausted
+     *
+     * @param size      number of bytes
+     * @param align     alignment
+     * @return void*    memory
+     */
+    void *allocate(size_t size, size_t align)
+    {
+        size_t pos = (used + align - 1) & ~(align - 1);
+        if (current == blocks.size() || pos + size > blocks[current].size)
+        {
+            nextBlock(size + align);
+            pos = (used + align - 1) & ~(align - 1);
+        }
+        used = pos + size;
+        return blocks[current].data + pos;
+    }
+
+    /**
+     * @brief makes all blocks available again. All memory handed out before is invalid afterwards
+     *
+     */
+    void reset()
+    {
+        current = 0;
+        used = 0;
+    }
+
+    /**
+     * @brief frees all blocks
+     *
+     */
+    void release()
+    {
+        for (block &b : blocks)
+            ::operator delete(b.data);
+        blocks.clear();
+        reset();
+    }
+
+    /**
+     * @brief number of bytes which are reserved by the arena
+     *
+     */
+    size_t capacity() const
+    {
+        size_t res = 0;
+        for (const block &b : blocks)
+            res += b.size;
+        return res;
+    }
+
+private:
+    struct block
+    {
+        char *data;
+        size_t size;
+    };
+
+    /**
+     * @brief continues in the next block that is large enough; blocks that are too small for the request are skipped
+     *
+     * @param size  minimal size of the block
+     */
+    void nextBlock(size_t size)
+    {
+        if (current < blocks.size())
+            current++;
+        while (current < blocks.size() && blocks[current].size < size)
+            current++;
+
+        if (current == blocks.size())
+        {
+            block b;
+            b.size = std::max(blockSize, size);
+            b.data = (char *)::operator new(b.size);
+            blocks.push_back(b);
+        }
+        used = 0;
+    }
+
+    std::vector<block> blocks;
+    size_t current = 0; // index of the block in use, blocks.size() if none
+    size_t used = 0;    // used bytes in the current block
+    size_t blockSize;
+};
+
+/**
+ * @brief returns the arena of the current run in this thread; NULL if no run is active
+ *
+ * @return runArena*&   arena
+ */
+inline runArena *&currentArena()
+{
+    static thread_local runArena *arena = NULL;
+    return arena;
+}
+
+/**
+ * @brief sets the arena of the current thread for the lifetime of the object
+ *
+ */
+class arenaScope
+{
+public:
+    arenaScope(runArena &arena) : previous(currentArena()) { currentArena() = &arena; }
+    ~arenaScope() { currentArena() = previous; }
+
+private:
+    runArena *previous;
+};
+
+/**
+ * @brief disables the arena of the current thread for the lifetime of the object, containers created meanwhile use the global heap.
+ *      This is needed for data which outlives the run, e.g. cached results.
+ *
+ */
+class heapScope
+{
+public:
+    heapScope() : previous(currentArena()) { currentArena() = NULL; }
+    ~heapScope() { currentArena() = previous; }
+
+private:
+    runArena *previous;
+};
+
+/**
+ * @brief allocator which uses the arena that was active when the container was created.
+ *      Containers created outside of a run (or in other threads) use the global heap.
+ *      Deallocation in the arena is a no-op, the memory is reclaimed by resetting the arena.
+ *
+ */
+template <class T>
+class arenaAllocator
+{
+public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    arenaAllocator() : arena(currentArena()) {}
+    template <class U>
+    arenaAllocator(const arenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t n)
+    {
+        if (arena != NULL)
+            return (T *)arena->allocate(n * sizeof(T), alignof(T));
+        return (T *)::operator new(n * sizeof(T));
+    }
+
+    void deallocate(T *p, size_t)
+    {
+        if (arena == NULL)
+            ::operator delete(p);
+    }
+
+    // copies of containers are placed in the arena of the thread that copies them
+    arenaAllocator select_on_container_copy_construction() const { return arenaAllocator(); }
+
+    template <class U>
+    bool operator==(const arenaAllocator<U> &other) const { return arena == other.arena; }
+    template <class U>
+    bool operator!=(const arenaAllocator<U> &other) const { return arena != other.arena; }
+
+    runArena *arena;
+};
+
+/**
+ * @brief vector whose elements are placed in the arena of the current run
+ *
+ */
+template <class T>
+using arenaVector = std::vector<T, arenaAllocator<T>>;
@@ -118,7 +118,7 @@ int fresnel(double s, double &x, double &y)
  * @param fd    determines if finite differences should be used for derivative
  * @return int  error code
  */
-int curve(double s, geometry geo, double &x, double &y, double &phi, int fd)
+int curve(double s, const geometry &geo, double &x, double &y, double &phi, int fd)
 {
     geometryType type = geo.type;
     double c = geo.c;
@@ -27,7 +27,7 @@
  * @param phi2  angle of end point (not used here)
  * @return int  error code
  */
-int addLine(vector<geometry> &geo, double x1, double y1, double phi1, double x2, double y2, double phi2)
+int addLine(referenceLine &geo, double x1, double y1, double phi1, double x2, double y2, double phi2)
 {
     geometry g;
 
@@ -60,7 +60,7 @@ int addLine(vector<geometry> &geo, double x1, double y1, double phi1, double x2,
  * @param phi2  angle of end point
  * @return int  error code
  */
-int addArc(vector<geometry> &geo, double x1, double y1, double phi1, double x2, double y2, double phi2)
+int addArc(referenceLine &geo, double x1, double y1, double phi1, double x2, double y2, double phi2)
 {
     double a = phi2 - phi1;
     fixAngle(a);
@@ -101,7 +101,7 @@ int addArc(vector<geometry> &geo, double x1, double y1, double phi1, double x2,
  * @param phi2  angle of end point
  * @return int  error code
  */
-int addCompositeCurve(vector<geometry> &geo, double x1, double y1, double phi1, double x2, double y2, double phi2)
+int addCompositeCurve(referenceLine &geo, double x1, double y1, double phi1, double x2, double y2, double phi2)
 {
     // not yet implemented
     return 0;
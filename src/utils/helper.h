@@ -55,16 +55,9 @@ int fixAngle(double &a)
  * @param sec   lanesection for which the laneId should be computed
  * @return int  minimum laneId -> if not found value 100 is stored
  */
-int findMinLaneId(laneSection sec)
+int findMinLaneId(const laneSection &sec)
 {
-    int min = 100;
-
-    for (int i = 0; i < sec.lanes.size(); i++)
-    {
-        if (sec.lanes[i].id < min)
-            min = sec.lanes[i].id;
-    }
-    return min;
+    return sec.lanes.minId();
 }
 
 /**
@@ -73,16 +66,9 @@ int findMinLaneId(laneSection sec)
  * @param sec   lanesection for which the laneId should be computed
  * @return int  maximum laneId -> if not found value -100 is stored
  */
-int findMaxLaneId(laneSection sec)
+int findMaxLaneId(const laneSection &sec)
 {
-    int max = -100;
-
-    for (int i = 0; i < sec.lanes.size(); i++)
-    {
-        if (sec.lanes[i].id > max)
-            max = sec.lanes[i].id;
-    }
-    return max;
+    return sec.lanes.maxId();
 }
 
 /**
@@ -93,7 +79,7 @@ int findMaxLaneId(laneSection sec)
  * @return true     if the lane is a boundary-lane
  * @return false    if the lane is not a boundary-lane
  */
-bool isBoundary(laneSection sec, int id)
+bool isBoundary(const laneSection &sec, int id)
 {
     if (id == findMaxLaneId(sec))
         return true;
@@ -111,17 +97,12 @@ bool isBoundary(laneSection sec, int id)
  * @param id    laneId of the lane to find
  * @return int  position in laneSection vector 
  */
-int findLane(laneSection sec, lane &l, int id)
+int findLane(const laneSection &sec, lane &l, int id)
 {
-    for (int i = 0; i < sec.lanes.size(); i++)
-    {
-        if (sec.lanes[i].id == id)
-        {
-            l = sec.lanes[i];
-            return i;
-        }
-    }
-    return -1;
+    int i = sec.lanes.find(id);
+    if (i != -1)
+        l = sec.lanes[i];
+    return i;
 }
 
 /**
@@ -132,7 +113,7 @@ int findLane(laneSection sec, lane &l, int id)
  * @param id    roadId of the lane to find
  * @return int  position in road vector
  */
-int findRoad(vector<road> &roads, road *&r, int id)
+int findRoad(arenaVector<road> &roads, road *&r, int id)
 {
     
     for (int i = 0; i < roads.size(); i++)
@@ -153,7 +134,7 @@ int findRoad(vector<road> &roads, road *&r, int id)
  * @param s         position where the lanewidth should be computed
  * @return double   computed lanewidth
  */
-double laneWidth(lane l, double s)
+double laneWidth(const lane &l, double s)
 {
     return l.w.a + l.w.b * s + l.w.c * s * s + l.w.d * s * s * s;
 }
@@ -166,24 +147,48 @@ double laneWidth(lane l, double s)
  * @param s         s position of the tOffset
  * @return double   computed tOffset
  */
-double findTOffset(laneSection sec, int id, double s)
+double findTOffset(const laneSection &sec, int id, double s)
 {
+    // borders of all lanes are tabulated once per lane section
+    const borderPolynom *border = sec.lanes.outerBorder(id);
+    if (border != NULL)
+        return border->value(s);
+
     double tOffset = 0;
     int cur = 0;
     int search = sgn(id) + id;
+    lane missing; // lanes which don't exist are evaluated with the default width
 
     while (cur != search)
     {
-        lane l;
-        int err = findLane(sec, l, cur);
-        s += l.w.s;
-        tOffset += sgn(id) * laneWidth(l, s);
+        const lane *l = sec.lanes.get(cur);
+        if (l == NULL)
+            l = &missing;
+        s += l->w.s;
+        tOffset += sgn(id) * laneWidth(*l, s);
         cur += sgn(id);
     }
 
     return tOffset;
 }
 
+/**
+ * @brief function computes the inner and outer border of a lane including the laneOffset of the lanesection
+ * 
+ * @param sec       lanesection of the lane
+ * @param id        laneId of the lane
+ * @param s         s position relative to the lanesection start
+ * @param inner     t coordinate of the inner border
+ * @param outer     t coordinate of the outer border
+ */
+void laneBorders(const laneSection &sec, int id, double s, double &inner, double &outer)
+{
+    double o = sec.o.a + sec.o.b * s + sec.o.c * s * s + sec.o.d * s * s * s;
+
+    inner = o + ((id == 0) ? 0 : findTOffset(sec, id - sgn(id), s));
+    outer = o + findTOffset(sec, id, s);
+}
+
 /**
  * @brief function shifts all lanes in given lanesection from lane with laneId
  * 
@@ -192,6 +197,8 @@ double findTOffset(laneSection sec, int id, double s)
  * @param dir   dir = 1 shift to outer side, die = -1 shift to inner side
  * @param keepPre decides whether or not the pre links should be kept.
  * @return int  error code 
+ * 
+ * the shifted lanes keep their order, so the positions of all lanes in sec stay valid
  */
 int shiftLanes(laneSection &sec, int id, int dir, bool keepPre = false, bool keepSuc = false)
 {
@@ -220,28 +227,38 @@ int shiftLanes(laneSection &sec, int id, int dir, bool keepPre = false, bool kee
         end = findMaxLaneId(sec) + side;
     }
 
-    while (start != end)
+    // the lane ids are sorted, so all lanes from start to end form a contiguous block
+    int first = sec.lanes.find(start);
+    while (first == -1 && start != end)
     {
-        for (int i = 0; i < sec.lanes.size(); i++)
+        start -= dir * side;
+        first = sec.lanes.find(start);
+    }
+    if (first == -1)
+        return 0;
+
+    int step = (start < end) ? 1 : -1;
+    while (first - step >= 0 && first - step < sec.lanes.size() && sec.lanes[first - step].id == start)
+        first -= step;
+    for (int i = first; i >= 0 && i < sec.lanes.size(); i += step)
+    {
+        lane &l = sec.lanes[i];
+        if ((end - l.id) * step <= 0)
+            break;
+
+        l.id += dir * side;
+
+        /*
+            Below is a fix that adjusts the linkage of the shifted lanes according to their id.
+        */
+        if(!keepPre)
         {
-            if (sec.lanes[i].id == start)
-            {
-                sec.lanes[i].id += dir * side;
-
-                /*
-                    Below is a fix that adjusts the linkage of the shifted lanes according to their id.
-                */
-                if(!keepPre)
-                {
-                    sec.lanes[i].preId += dir * side; 
-                }
-                if(!keepSuc)
-                {
-                    sec.lanes[i].sucId += dir * side;
-                }
-            }
+            l.preId += dir * side; 
+        }
+        if(!keepSuc)
+        {
+            l.sucId += dir * side;
         }
-        start -= dir * side;
     }
 
     return 0;
@@ -254,7 +271,7 @@ int shiftLanes(laneSection &sec, int id, int dir, bool keepPre = false, bool kee
  * @param side  determines current side 
  * @return int  laneId of left lane
  */
-int findLeftLane(laneSection sec, int side)
+int findLeftLane(const laneSection &sec, int side)
 {
 
     int search = sgn(side);
@@ -268,9 +285,8 @@ int findLeftLane(laneSection sec, int side)
     // search for leftest marked lane
     while (search != end)
     {
-        lane l;
-        findLane(sec, l, search);
-        if (l.type == "driving" && l.turnLeft)
+        const lane *l = sec.lanes.get(search);
+        if (l != NULL && l->type == "driving" && l->turnLeft)
             return search;
         search += sgn(side);
     }
@@ -285,7 +301,7 @@ int findLeftLane(laneSection sec, int side)
  * @param side  determines current side 
  * @return int  laneId of right lane
  */
-int findRightLane(laneSection sec, int side)
+int findRightLane(const laneSection &sec, int side)
 {
 
     int search;
@@ -299,9 +315,8 @@ int findRightLane(laneSection sec, int side)
     // search for rightest marked lane
     while (search != end)
     {
-        lane l;
-        findLane(sec, l, search);
-        if (l.type == "driving" && l.turnRight)
+        const lane *l = sec.lanes.get(search);
+        if (l != NULL && l->type == "driving" && l->turnRight)
             return search;
         search -= sgn(side);
     }
@@ -316,7 +331,7 @@ int findRightLane(laneSection sec, int side)
  * @param side  determines current side 
  * @return int  laneId of left lane
  */
-int findInnerMiddleLane(laneSection sec, int side)
+int findInnerMiddleLane(const laneSection &sec, int side)
 {
 
     int search = sgn(side);
@@ -330,9 +345,8 @@ int findInnerMiddleLane(laneSection sec, int side)
     // search for inner middle marked lane
     while (search != end)
     {
-        lane l;
-        findLane(sec, l, search);
-        if (l.type == "driving" && l.turnStraight)
+        const lane *l = sec.lanes.get(search);
+        if (l != NULL && l->type == "driving" && l->turnStraight)
             return search;
         search += sgn(side);
     }
@@ -347,7 +361,7 @@ int findInnerMiddleLane(laneSection sec, int side)
  * @param side  determines current side 
  * @return int  laneId of left lane
  */
-int findOuterMiddleLane(laneSection sec, int side)
+int findOuterMiddleLane(const laneSection &sec, int side)
 {
     int search;
     int end = 0;
@@ -360,9 +374,8 @@ int findOuterMiddleLane(laneSection sec, int side)
     // search for outer middle marked lane
     while (search != end)
     {
-        lane l;
-        findLane(sec, l, search);
-        if (l.type == "driving" && l.turnStraight)
+        const lane *l = sec.lanes.get(search);
+        if (l != NULL && l->type == "driving" && l->turnStraight)
             return search;
         search -= sgn(side);
     }
@@ -382,7 +395,7 @@ int findOuterMiddleLane(laneSection sec, int side)
  * @param mode  either right-right / middle-middle / left-left
  * @return int  error code
  */
-int calcFromTo(road r1, road r2, int &from, int &to, int &nF, int &nT, int mode)
+int calcFromTo(const road &r1, const road &r2, int &from, int &to, int &nF, int &nT, int mode)
 {
     int r1_F_L = findLeftLane(r1.laneSections.front(), 1);
     int r1_F_MI = findInnerMiddleLane(r1.laneSections.front(), 1);
@@ -469,109 +482,35 @@ int calcFromTo(road r1, road r2, int &from, int &to, int &nF, int &nT, int mode)
 }
 
 /**
- * @brief function sorts the roads r2,r3,r4 to their corresponding angle
+ * @brief function sorts the roads of a junction to their corresponding angle; the first road is the reference road and keeps its position
  * 
- * @param r1    reference road with reference angle
- * @param r2    first additional road
- * @param r3    second additional road
- * @param r4    third additional road
- * @return int  error code
+ * @param roads     roads of the junction, the first road is the reference road
+ * @return int      error code
  */
-int sortRoads(road r1, road &r2, road &r3, road &r4)
+int sortRoads(vector<const road *> &roads)
 {
-    double phi1 = r2.geometries.front().hdg - r1.geometries.front().hdg + M_PI;
-    double phi2 = r3.geometries.front().hdg - r1.geometries.front().hdg + M_PI;
-    double phi3 = r4.geometries.front().hdg - r1.geometries.front().hdg + M_PI;
-    fixAngle(phi1);
-    fixAngle(phi2);
-    fixAngle(phi3);
-
-    road tmpR2 = r2;
-    road tmpR3 = r3;
-    road tmpR4 = r4;
+    if (roads.size() < 2)
+        return 0;
 
-    if (phi1 < phi2 && phi1 < phi3)
-    {
-        r2 = tmpR2;
-        if (phi2 < phi3)
-        {
-            r3 = tmpR3;
-            r4 = tmpR4;
-        }
-        else
-        {
-            r3 = tmpR4;
-            r4 = tmpR3;
-        }
-    }
-    else if (phi2 < phi1 && phi2 < phi3)
-    {
-        r2 = tmpR3;
-        if (phi1 < phi3)
-        {
-            r3 = tmpR2;
-            r4 = tmpR4;
-        }
-        else
-        {
-            r3 = tmpR4;
-            r4 = tmpR2;
-        }
-    }
-    else if (phi3 < phi1 && phi3 < phi2)
-    {
-        r2 = tmpR4;
-        if (phi1 < phi2)
-        {
-            r3 = tmpR2;
-            r4 = tmpR3;
-        }
-        else
-        {
-            r3 = tmpR3;
-            r4 = tmpR2;
-        }
-    }
-    else
+    const road *ref = roads.front();
+    vector<pair<double, const road *>> angles;
+    for (int i = 1; i < (int)roads.size(); i++)
     {
-        cerr << "ERR: angles at intersection point are not defined correct.";
-        return 1;
+        double phi = roads[i]->geometries.front().hdg - ref->geometries.front().hdg + M_PI;
+        fixAngle(phi);
+        angles.push_back(make_pair(phi, roads[i]));
     }
-    return 0;
-}
-
-/**
- * @brief function sorts the roads r2,r3 to their corresponding angle
- * 
- * @param r1    reference road with reference angle
- * @param r2    first additional road
- * @param r3    second additional road
- * @return int  error code
- */
-int sortRoads(road r1, road &r2, road &r3)
-{
-    double phi1 = r2.geometries.front().hdg - r1.geometries.front().hdg + M_PI;
-    double phi2 = r3.geometries.front().hdg - r1.geometries.front().hdg + M_PI;
-    fixAngle(phi1);
-    fixAngle(phi2);
 
-    road tmpR2 = r2;
-    road tmpR3 = r3;
+    stable_sort(angles.begin(), angles.end(), [](const pair<double, const road *> &a, const pair<double, const road *> &b) { return a.first < b.first; });
 
-    if (phi1 < phi2)
+    for (int i = 0; i < (int)angles.size(); i++)
     {
-        r2 = tmpR2;
-        r3 = tmpR3;
-    }
-    else if (phi2 < phi1)
-    {
-        r2 = tmpR3;
-        r3 = tmpR2;
-    }
-    else
-    {
-        cerr << "ERR: angles at intersection point are not defined correct.";
-        return 1;
+        if (i > 0 && !(angles[i - 1].first < angles[i].first))
+        {
+            cerr << "ERR: angles at intersection point are not defined correct." << endl;
+            return 1;
+        }
+        roads[i + 1] = angles[i].second;
     }
     return 0;
 }
@@ -759,7 +698,7 @@ bool isIn(vector<int> &v, int &i)
  * @return true 
  * @return false 
  */
-bool isJunction(roadNetwork data, int roadID)
+bool isJunction(const roadNetwork &data, int roadID)
 {
     for (auto &&j : data.junctions)
     {
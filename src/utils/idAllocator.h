@@ -0,0 +1,180 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file idAllocator.h
+ *
+ * @brief file contains the central allocation of the road and junction ids
+ *
+ *      The ids are split into blocks of 100. The generation keeps its naming scheme (e.g. 100 * segment id + k),
+ *      each segment owns the block of its scheme. An id is taken as it is if it is unused and lies in a block of
+ *      its segment; otherwise the segment gets the next free id of an overflow block above all reserved blocks and
+ *      the replacement is stored in the remap table, which is written to the header of the output file.
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * @brief entry of the id remap table
+ *
+ */
+struct idRemap
+{
+    int segment = -1;       // segment which requested the id, -1 for closing roads
+    int legacyId = -1;      // id following the naming scheme of the segment
+    int id = -1;            // id in the output file
+    bool junction = false;  // true if the id is a junction id
+};
+
+/**
+ * @brief central allocator of the road and junction ids
+ *
+ */
+struct idAllocator
+{
+    static const int blockSize = 100;
+
+    std::unordered_map<int, int> owner;   // block -> segment which owns the block
+    std::unordered_map<int, int> cursor;  // segment -> next id in its current overflow block
+    std::unordered_set<int> used;         // ids which were handed out
+    int nextBlock = 0;                    // overflow blocks are searched from here on
+    std::vector<idRemap> remap;
+
+    /**
+     * @brief returns the block of an id
+     *
+     * @param id        id
+     * @return int      block
+     */
+    static int blockOf(int id)
+    {
+        return (id >= 0) ? id / blockSize : -((-id - 1) / blockSize) - 1;
+    }
+
+    /**
+     * @brief claims a block for a segment if it is still free
+     *
+     * @param segment   segment
+     * @param block     block
+     * @return bool     true if the block is owned by the segment
+     */
+    bool reserve(int segment, int block)
+    {
+        std::unordered_map<int, int>::iterator it = owner.find(block);
+        if (it != owner.end())
+            return it->second == segment;
+
+        owner[block] = segment;
+        return true;
+    }
+
+    /**
+     * @brief keeps all blocks below the given block free from overflow ids
+     *
+     * @param block     first block which may be used for overflow ids
+     */
+    void reserveBelow(int block)
+    {
+        nextBlock = std::max(nextBlock, block);
+    }
+
+    /**
+     * @brief claims the next free overflow block for a segment
+     *
+     * @param segment   segment
+     * @return int      block
+     */
+    int overflowBlock(int segment)
+    {
+        while (owner.count(nextBlock))
+            nextBlock++;
+        owner[nextBlock] = segment;
+        return nextBlock++;
+    }
+
+    /**
+     * @brief returns the next free overflow id of a segment
+     *
+     * @param segment   segment
+     * @return int      id
+     */
+    int overflowId(int segment)
+    {
+        std::unordered_map<int, int>::iterator it = cursor.find(segment);
+        int id = (it != cursor.end()) ? it->second : -1;
+
+        while (true)
+        {
+            // a new block is started if the current one is full; its first id is skipped like in the naming schemes
+            if (id < 0 || id % blockSize == 0)
+                id = overflowBlock(segment) * blockSize + 1;
+            if (!used.count(id))
+                break;
+            id++;
+        }
+        cursor[segment] = id + 1;
+        return id;
+    }
+
+    /**
+     * @brief allocates a road id
+     *
+     * @param segment   segment which requests the id
+     * @param legacyId  id following the naming scheme of the segment
+     * @return int      id in the output file
+     */
+    int allocate(int segment, int legacyId)
+    {
+        int id = legacyId;
+        if (used.count(id) || !reserve(segment, blockOf(id)))
+        {
+            id = overflowId(segment);
+
+            idRemap entry;
+            entry.segment = segment;
+            entry.legacyId = legacyId;
+            entry.id = id;
+            remap.push_back(entry);
+        }
+        used.insert(id);
+        return id;
+    }
+
+    /**
+     * @brief allocates a whole block for a junction; the junction gets the first id of the block,
+     *      its roads are allocated with the following ids
+     *
+     * @param segment   segment which requests the junction
+     * @param legacyId  junction id following the naming scheme of the segment, the first id of a block
+     * @return int      junction id in the output file
+     */
+    int allocateJunction(int segment, int legacyId)
+    {
+        int id = legacyId;
+        if (used.count(id) || !reserve(segment, blockOf(id)))
+        {
+            id = overflowBlock(segment) * blockSize;
+
+            idRemap entry;
+            entry.segment = segment;
+            entry.legacyId = legacyId;
+            entry.id = id;
+            entry.junction = true;
+            remap.push_back(entry);
+        }
+        used.insert(id);
+        return id;
+    }
+};
@@ -21,6 +21,65 @@
 
 extern settings setting;
 
+/**
+ * @brief names which are known in advance: OpenDRIVE names of lane types, roadmark types, weights and colors, materials and orientations
+ * 
+ */
+const char *const openDriveNames[] = {
+    "",
+    // lane types
+    "none", "driving", "stop", "shoulder", "biking", "sidewalk", "border", "restricted", "parking", "bidirectional", "median",
+    "special1", "special2", "special3", "roadWorks", "tram", "rail", "entry", "exit", "offRamp", "onRamp", "connectingRamp", "bus", "taxi", "HOV",
+    "curb", "delete",
+    // roadmark types
+    "solid", "broken", "solid solid", "solid broken", "broken solid", "broken broken", "botts dots", "grass", "custom", "edge",
+    // roadmark weights and colors
+    "standard", "bold", "white", "yellow", "blue", "green", "red", "orange",
+    // materials
+    "asphalt", "concrete", "gravel", "grass",
+    // orientations and default subtype
+    "+", "-", "-1"};
+
+/**
+ * @brief compact representation of a string; each distinct string is stored once in a table and referenced by a pointer.
+ * copying and comparing two internedStrings is as cheap as copying and comparing a pointer.
+ * new strings are only added to the table at xml input, so the table is not modified during generation
+ * 
+ */
+class internedString
+{
+public:
+    internedString() : value(intern("")) {}
+    internedString(const char *s) : value(intern(s)) {}
+    internedString(const string &s) : value(intern(s)) {}
+
+    const string &str() const { return *value; }
+    const char *c_str() const { return value->c_str(); }
+
+    bool operator==(const internedString &other) const { return value == other.value; }
+    bool operator!=(const internedString &other) const { return value != other.value; }
+    bool operator==(const char *other) const { return *value == other; }
+    bool operator!=(const char *other) const { return *value != other; }
+    bool operator==(const string &other) const { return *value == other; }
+    bool operator!=(const string &other) const { return *value != other; }
+
+private:
+    static const string *intern(const string &s)
+    {
+        static std::unordered_set<string> table(std::begin(openDriveNames), std::end(openDriveNames));
+
+        // known strings are only looked up, so the generation can run in several threads
+        std::unordered_set<string>::const_iterator it = table.find(s);
+        if (it != table.end())
+            return &*it;
+
+        // elements of an unordered_set keep their address on rehashing
+        return &*table.insert(s).first;
+    }
+
+    const string *value;
+};
+
 // definition of basic types
 enum junctionGroupType
 {
@@ -78,7 +137,7 @@ struct connection
 struct junction
 {
     int id = -1;
-    vector<connection> connections;
+    arenaVector<connection> connections;
 
 
     string to_string()
@@ -101,9 +160,9 @@ struct junction
 struct roadmark
 {
     double s = 0;
-    string type = "solid";
-    string weight = "standard";
-    string color = "white";
+    internedString type = "solid";
+    internedString weight = "standard";
+    internedString color = "white";
     double width = 0.15;
 };
 
@@ -139,7 +198,7 @@ struct offset
 struct material
 {
     double s = 0;
-    string surface = "asphalt";
+    internedString surface = "asphalt";
     double friction = 0.8;
     double roughness = 0.015;
 };
@@ -151,7 +210,7 @@ struct material
 struct lane
 {
     int id = -1;
-    string type = "driving";
+    internedString type = "driving";
     bool turnLeft = false;    // determine if lane is special left turn lane
     bool turnStraight = true; // determine if lane is normal lane
     bool turnRight = false;   // determine if lane is special right turn lane
@@ -165,6 +224,225 @@ struct lane
     int sucId = -1; // successor
 };
 
+/**
+ * @brief cubic polynom of a lane border in t direction
+ * 
+ */
+struct borderPolynom
+{
+    double a = 0;
+    double b = 0;
+    double c = 0;
+    double d = 0;
+
+    double value(double s) const { return a + s * (b + s * (c + s * d)); }
+
+    /**
+     * @brief adds the polynom p(s + ds) multiplied with the factor f
+     */
+    void add(double f, double pa, double pb, double pc, double pd, double ds)
+    {
+        a += f * (pa + ds * (pb + ds * (pc + ds * pd)));
+        b += f * (pb + ds * (2 * pc + 3 * pd * ds));
+        c += f * (pc + 3 * pd * ds);
+        d += f * pd;
+    }
+};
+
+/**
+ * @brief lanes of a laneSection, kept sorted by ascending lane id
+ * lanes are accessed by their position like a vector; a lane with a given id is found in O(1) by its offset to the min id
+ * if ids are changed directly, the order has to be restored by sortById()
+ * 
+ */
+class laneTable
+{
+public:
+    typedef arenaVector<lane>::iterator iterator;
+    typedef arenaVector<lane>::const_iterator const_iterator;
+
+    int size() const { return lanes.size(); }
+    bool empty() const { return lanes.empty(); }
+
+    lane &operator[](int i)
+    {
+        bordersValid = false;
+        return lanes[i];
+    }
+    const lane &operator[](int i) const { return lanes[i]; }
+
+    lane &front()
+    {
+        bordersValid = false;
+        return lanes.front();
+    }
+    lane &back()
+    {
+        bordersValid = false;
+        return lanes.back();
+    }
+
+    iterator begin()
+    {
+        bordersValid = false;
+        return lanes.begin();
+    }
+    iterator end() { return lanes.end(); }
+    const_iterator begin() const { return lanes.begin(); }
+    const_iterator end() const { return lanes.end(); }
+
+    /**
+     * @brief inserts a lane at its sorted position (behind lanes with the same id)
+     */
+    void push_back(const lane &l)
+    {
+        bordersValid = false;
+        lanes.insert(std::upper_bound(lanes.begin(), lanes.end(), l, compareId), l);
+    }
+
+    iterator erase(iterator it)
+    {
+        bordersValid = false;
+        return lanes.erase(it);
+    }
+
+    void clear()
+    {
+        bordersValid = false;
+        lanes.clear();
+    }
+
+    /**
+     * @brief returns the position of the lane with the given id or -1
+     */
+    int find(int id) const
+    {
+        if (lanes.empty())
+            return -1;
+
+        // ids are usually contiguous, so the position is the offset to the min id
+        int i = id - lanes.front().id;
+        if (i >= 0 && i < (int)lanes.size() && lanes[i].id == id)
+            return i;
+
+        lane l;
+        l.id = id;
+        arenaVector<lane>::const_iterator it = std::lower_bound(lanes.begin(), lanes.end(), l, compareId);
+        if (it == lanes.end() || it->id != id)
+            return -1;
+        return it - lanes.begin();
+    }
+
+    /**
+     * @brief returns the lane with the given id or NULL
+     */
+    lane *get(int id)
+    {
+        bordersValid = false;
+        int i = find(id);
+        return (i == -1) ? NULL : &lanes[i];
+    }
+
+    const lane *get(int id) const
+    {
+        int i = find(id);
+        return (i == -1) ? NULL : &lanes[i];
+    }
+
+    /**
+     * @brief min lane id, 100 if there is no lane
+     */
+    int minId() const { return lanes.empty() ? 100 : lanes.front().id; }
+
+    /**
+     * @brief max lane id, -100 if there is no lane
+     */
+    int maxId() const { return lanes.empty() ? -100 : lanes.back().id; }
+
+    /**
+     * @brief negates all lane ids, which reverses the order
+     */
+    void flipIds()
+    {
+        bordersValid = false;
+        for (lane &l : lanes)
+            l.id *= -1;
+        std::reverse(lanes.begin(), lanes.end());
+    }
+
+    /**
+     * @brief restores the order after lane ids were changed directly
+     */
+    void sortById()
+    {
+        bordersValid = false;
+        std::stable_sort(lanes.begin(), lanes.end(), compareId);
+    }
+
+    /**
+     * @brief returns the outer border of the lane with the given id or NULL if the id is outside of the lanes.
+     * the border is the signed sum of the widths from the center lane to the lane (without laneOffset), lanes which don't exist have the default width.
+     * all borders are computed at the first query after the lanes changed
+     */
+    const borderPolynom *outerBorder(int id) const
+    {
+        if (!bordersValid)
+            updateBorders();
+
+        int i = id - borderMinId;
+        if (i < 0 || i >= (int)borders.size())
+            return NULL;
+        return &borders[i];
+    }
+
+private:
+    static bool compareId(const lane &a, const lane &b) { return a.id < b.id; }
+
+    /**
+     * @brief computes the outer borders of all lanes in one pass to each side
+     */
+    void updateBorders() const
+    {
+        borderMinId = std::min(minId(), 0);
+        int maxLaneId = std::max(maxId(), 0);
+        borders.assign(maxLaneId - borderMinId + 1, borderPolynom());
+
+        lane missing;
+        for (int side = -1; side <= 1; side += 2)
+        {
+            borderPolynom sum;
+            double ds = 0;
+            int last = (side == 1) ? maxLaneId : borderMinId;
+
+            for (int cur = 0; cur != last; cur += side)
+            {
+                const lane *l = get(cur);
+                if (l == NULL)
+                    l = &missing;
+
+                ds += l->w.s;
+                sum.add(side, l->w.a, l->w.b, l->w.c, l->w.d, ds);
+
+                // the border of lane cur + side includes the widths of lane 0 to lane cur + side
+                const lane *next = get(cur + side);
+                if (next == NULL)
+                    next = &missing;
+                borderPolynom border = sum;
+                border.add(side, next->w.a, next->w.b, next->w.c, next->w.d, ds + next->w.s);
+                borders[cur + side - borderMinId] = border;
+            }
+        }
+        bordersValid = true;
+    }
+
+    arenaVector<lane> lanes;
+
+    // lazily computed lane borders; invalidated by every non-const access to the lanes
+    mutable bool bordersValid = false;
+    mutable int borderMinId = 0;
+    mutable arenaVector<borderPolynom> borders;
+};
+
 /**
  * @brief laneSection holds several lanes in a defined s section
  * 
@@ -173,7 +451,7 @@ struct laneSection
 {
     int id = -1;
     double s = 0;
-    vector<lane> lanes;
+    laneTable lanes;
     offset o;
 };
 
@@ -194,6 +472,147 @@ struct geometry
     double c2 = -1;
 };
 
+/**
+ * @brief referenceLine holds the geometries of a road as structure of arrays
+ *      s, x, y, hdg and length are stored in one column each. The curvature column is tagged by the type:
+ *      lines have no entry, arcs one (c) and spirals two (c1, c2). Element access returns geometry values.
+ *
+ */
+class referenceLine
+{
+public:
+    /**
+     * @brief iterator which returns the geometries by value
+     *
+     */
+    class const_iterator
+    {
+    public:
+        const_iterator(const referenceLine *ref, size_t i) : ref(ref), i(i) {}
+
+        geometry operator*() const { return (*ref)[i]; }
+        const_iterator &operator++()
+        {
+            i++;
+            return *this;
+        }
+        bool operator==(const const_iterator &other) const { return i == other.i; }
+        bool operator!=(const const_iterator &other) const { return i != other.i; }
+
+    private:
+        const referenceLine *ref;
+        size_t i;
+    };
+
+    size_t size() const { return type.size(); }
+    bool empty() const { return type.empty(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    void clear()
+    {
+        type.clear();
+        s.clear();
+        x.clear();
+        y.clear();
+        hdg.clear();
+        length.clear();
+        curvature.clear();
+        curvatureIndex.clear();
+    }
+
+    /**
+     * @brief removes all geometries from position n on
+     *
+     * @param n     number of remaining geometries
+     */
+    void truncate(size_t n)
+    {
+        if (n >= size())
+            return;
+
+        curvature.resize(curvatureIndex[n]);
+        type.resize(n);
+        s.resize(n);
+        x.resize(n);
+        y.resize(n);
+        hdg.resize(n);
+        length.resize(n);
+        curvatureIndex.resize(n);
+    }
+
+    void push_back(const geometry &g)
+    {
+        type.push_back(g.type);
+        s.push_back(g.s);
+        x.push_back(g.x);
+        y.push_back(g.y);
+        hdg.push_back(g.hdg);
+        length.push_back(g.length);
+
+        curvatureIndex.push_back(curvature.size());
+        if (g.type == arc)
+            curvature.push_back(g.c);
+        if (g.type == spiral)
+        {
+            curvature.push_back(g.c1);
+            curvature.push_back(g.c2);
+        }
+    }
+
+    geometry operator[](size_t i) const
+    {
+        geometry g;
+        g.type = type[i];
+        g.s = s[i];
+        g.x = x[i];
+        g.y = y[i];
+        g.hdg = hdg[i];
+        g.length = length[i];
+        g.c = (type[i] == arc) ? c(i) : 0;
+        g.c1 = (type[i] == spiral) ? c1(i) : 0;
+        g.c2 = (type[i] == spiral) ? c2(i) : 0;
+        return g;
+    }
+
+    geometry front() const { return (*this)[0]; }
+    geometry back() const { return (*this)[size() - 1]; }
+
+    // curvature of an arc
+    double &c(size_t i) { return curvature[curvatureIndex[i]]; }
+    double c(size_t i) const { return curvature[curvatureIndex[i]]; }
+
+    // start and end curvature of a spiral
+    double &c1(size_t i) { return curvature[curvatureIndex[i]]; }
+    double c1(size_t i) const { return curvature[curvatureIndex[i]]; }
+    double &c2(size_t i) { return curvature[curvatureIndex[i] + 1]; }
+    double c2(size_t i) const { return curvature[curvatureIndex[i] + 1]; }
+
+    /**
+     * @brief recomputes the position of each geometry in the curvature column from the types
+     *
+     */
+    void updateCurvatureIndex()
+    {
+        int pos = 0;
+        for (size_t i = 0; i < type.size(); i++)
+        {
+            curvatureIndex[i] = pos;
+            pos += (type[i] == arc) + 2 * (type[i] == spiral);
+        }
+    }
+
+    arenaVector<geometryType> type;
+    arenaVector<double> s;
+    arenaVector<double> x;
+    arenaVector<double> y;
+    arenaVector<double> hdg;
+    arenaVector<double> length;
+    arenaVector<double> curvature;
+    arenaVector<int> curvatureIndex; // first entry of each geometry in the curvature column
+};
+
 /**
  * @brief link is either predecessor or successor and defines id and properties of previous/next element
  * 
@@ -212,12 +631,12 @@ struct link
 struct object
 {
     int id = -1;
-    string type = ""; // special OpenDRIVE code to define type
+    internedString type = ""; // special OpenDRIVE code to define type
     double s = 0;
     double t = 0;
     double z = 0;
     double hdg = 0;
-    string orientation = "none";
+    internedString orientation = "none";
     double length = 0;
     double width = 0;
     double height = 0;
@@ -235,14 +654,14 @@ struct object
 struct sign
 {
     int id = -1;
-    string type = ""; // special OpenDRIVE code to define type
-    string subtype = "-1";
+    internedString type = ""; // special OpenDRIVE code to define type
+    internedString subtype = "-1";
     int rule = -1;
     double value = -1;
     double s = 0;
     double t = 0;
     double z = 0;
-    string orientation = "none";
+    internedString orientation = "none";
     double width = 0.4;
     double height = 2;
     bool dynamic = false;
@@ -256,7 +675,7 @@ struct sign
 struct control
 {
     int id = -1;
-    vector<sign> signs;
+    arenaVector<sign> signs;
 };
 
 /**
@@ -282,7 +701,7 @@ struct elevationPolynom
 struct elevationProfile
 {
     
-    vector<elevationPolynom> outputElevation; //these are the polynoms that are generated from this elevationprofile
+    arenaVector<elevationPolynom> outputElevation; //these are the polynoms that are generated from this elevationprofile
     //these are the raw input format values s equals x coordinate and t equals y.
     int inputId    = -1;
     double radius  = 0;
@@ -323,10 +742,10 @@ struct road
     link predecessor;
     link successor;
 
-    vector<geometry> geometries;
-    vector<laneSection> laneSections;
-    vector<object> objects;
-    vector<sign> signs;
+    referenceLine geometries;
+    arenaVector<laneSection> laneSections;
+    arenaVector<object> objects;
+    arenaVector<sign> signs;
 
 
     /**
@@ -340,10 +759,9 @@ struct road
         if(predecessor.id == id) return -1;
         if(successor.id == id) return 1;
         return 0;
-        }
-    };
+    }
 
-    vector<elevationProfile> elevationProfiles;
+    arenaVector<elevationProfile> elevationProfiles;
 
     /**
      * @brief Get the Relative Elevation At road at start or end position TODO: replace this method with getRelativeElevationAtEnd()
@@ -374,7 +792,7 @@ struct junctionGroup
     int id;
     string name;
     junctionGroupType type = roundaboutType;
-    vector<int> juncIds; 
+    arenaVector<int> juncIds; 
 
     junctionGroup()
     {
@@ -390,6 +808,38 @@ struct junctionGroup
 
 };
 
+/**
+ * @brief edge of the elevation graph, the elevation at the contact point of both nodes has to be equal
+ * 
+ */
+struct elevationEdge
+{
+    int to = -1;                            // index of the adjacent node
+    contactPointType fromPos = noneType;    // contact point at the current node (noneType for junction nodes)
+    contactPointType toPos = noneType;      // contact point at the adjacent node (noneType for junction nodes)
+};
+
+/**
+ * @brief graph used for the elevation propagation
+ * nodes [0, nRoads) are the roads in roadNetwork::roads, nodes [nRoads, nRoads + nJunctions) are the junctions
+ * 
+ */
+struct elevationGraph
+{
+    int nRoads = 0;
+    int root = -1;                          // node index of the reference road
+    double rootOffset = 0;                  // elevation offset of the reference road
+
+    vector<vector<elevationEdge>> edges;    // adjacency list of each node
+    vector<vector<int>> junctionMembers;    // road indices of all roads in each junction
+    std::map<int, int> roadIndex;           // road id -> node index
+    std::map<int, int> junctionIndex;       // junction id -> node index
+
+    vector<elevationEdge> parentEdge;       // edge from the spanning tree parent to the node (to = -1 for unreached nodes)
+    vector<vector<int>> children;           // spanning tree children of each node
+    vector<double> offset;                  // elevation offset of each node
+};
+
 /**
  * @brief roadNetwork is the overall struct holding all data
  * 
@@ -403,15 +853,19 @@ struct roadNetwork
     string file;
     string outputFile;
     // main data properties
-    vector<road> roads;
-    vector<junction> junctions;
-    vector<control> controller;
-    vector<junctionGroup> juncGroups;
+    arenaVector<road> roads;
+    arenaVector<junction> junctions;
+    arenaVector<control> controller;
+    arenaVector<junctionGroup> juncGroups;
 
     int refRoad = -1; //store reference road id as input it
     int refElev = 0;  //store road elevation
 
+    elevationGraph elevGraph; //graph for the elevation propagation and the incremental update of single roads
+
     // global counters
     int nSignal = 0;
     int nSegment = 0;
+
+    idAllocator ids; // road and junction ids of all segments
 };
\ No newline at end of file
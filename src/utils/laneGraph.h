@@ -0,0 +1,369 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file laneGraph.h
+ *
+ * @brief file contains the lane level connectivity graph of the generated road network and its binary export
+ *
+ *      file layout (little endian, all sections 8 byte aligned):
+ *          laneGraphHeader
+ *          laneGraphNode[nNodes]       sorted by road, lane section and lane id
+ *          uint32_t[nNodes + 1]        index of the first outgoing edge of each node (CSR), padded to 8 bytes
+ *          laneGraphEdge[nEdges]
+ *      the file can be mapped directly into memory, no parsing is needed.
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#define LANE_GRAPH_VERSION 1
+
+/**
+ * @brief type of a lane graph edge
+ *
+ */
+enum laneGraphEdgeType
+{
+    longitudinalEdge,   // to the following lane section or road
+    junctionEdge,       // from an incoming road to a connecting road
+    laneChangeLeftEdge, // to the left neighbour in driving direction
+    laneChangeRightEdge // to the right neighbour in driving direction
+};
+
+/**
+ * @brief flags of a lane graph node
+ *
+ */
+enum laneGraphNodeFlag
+{
+    drivingLaneFlag = 1,
+    connectingRoadFlag = 2
+};
+
+struct laneGraphHeader
+{
+    char magic[8];      // "LANEGRPH"
+    uint32_t version;
+    uint32_t nNodes;
+    uint32_t nEdges;
+    uint32_t nodeOffset;    // byte offsets from the file start
+    uint32_t indexOffset;
+    uint32_t edgeOffset;
+};
+
+struct laneGraphNode
+{
+    int32_t road;           // road id
+    int32_t laneSection;    // index of the lane section in the road
+    int32_t lane;           // lane id
+    uint32_t flags;         // laneGraphNodeFlag
+    double s;               // unit m, start of the lane section
+    double length;          // unit m, length of the lane section
+};
+
+struct laneGraphEdge
+{
+    uint32_t to;
+    uint32_t type;          // laneGraphEdgeType
+    double length;          // unit m, distance driven on the start node before the edge is taken
+};
+
+static_assert(sizeof(laneGraphHeader) == 32, "unexpected padding in laneGraphHeader");
+static_assert(sizeof(laneGraphNode) == 32, "unexpected padding in laneGraphNode");
+static_assert(sizeof(laneGraphEdge) == 16, "unexpected padding in laneGraphEdge");
+
+/**
+ * @brief lane level graph in compressed sparse row form
+ *
+ */
+struct laneGraph
+{
+    vector<laneGraphNode> nodes;
+    vector<uint32_t> edgeIndex;     // edges of node k are edges[edgeIndex[k]] to edges[edgeIndex[k + 1] - 1]
+    vector<laneGraphEdge> edges;
+};
+
+/**
+ * @brief lookup of node indices; lane ids of a lane section are sorted, so the node index follows from the lane position
+ *
+ */
+class laneGraphIndex
+{
+public:
+    laneGraphIndex(const roadNetwork &data) : data(data)
+    {
+        int nodes = 0;
+        for (int i = 0; i < (int)data.roads.size(); i++)
+        {
+            roadIndex[data.roads[i].id] = i;
+            firstNode.push_back(vector<int>());
+            for (const laneSection &sec : data.roads[i].laneSections)
+            {
+                firstNode.back().push_back(nodes);
+                nodes += sec.lanes.size() - (sec.lanes.find(0) != -1);
+            }
+        }
+    }
+
+    /**
+     * @brief returns the index of the road with the given id or -1
+     */
+    int road(int id) const
+    {
+        map<int, int>::const_iterator it = roadIndex.find(id);
+        return (it == roadIndex.end()) ? -1 : it->second;
+    }
+
+    /**
+     * @brief returns the node of a lane or -1 if the lane does not exist
+     *
+     * @param r         road index
+     * @param sec       lane section index
+     * @param laneId    lane id
+     */
+    int node(int r, int sec, int laneId) const
+    {
+        if (r < 0 || laneId == 0 || sec < 0 || sec >= (int)firstNode[r].size())
+            return -1;
+
+        const laneTable &lanes = data.roads[r].laneSections[sec].lanes;
+        int pos = lanes.find(laneId);
+        if (pos == -1)
+            return -1;
+
+        // the center lane has no node
+        if (laneId > 0 && lanes.find(0) != -1)
+            pos--;
+        return firstNode[r][sec] + pos;
+    }
+
+    /**
+     * @brief returns the node of a lane at the contact point of a linked road
+     */
+    int node(const link &l, int laneId) const
+    {
+        int r = road(l.id);
+        if (r == -1)
+            return -1;
+        int sec = (l.contactPoint == endType) ? data.roads[r].laneSections.size() - 1 : 0;
+        return node(r, sec, laneId);
+    }
+
+private:
+    const roadNetwork &data;
+    map<int, int> roadIndex;
+    vector<vector<int>> firstNode;
+};
+
+/**
+ * @brief checks if a lane change over the outer border of the given lane is allowed
+ */
+bool laneChangeAllowed(const lane &l)
+{
+    return l.rm.type != "solid" && l.rm.type != "solid solid" && l.rm.type != "solid broken";
+}
+
+/**
+ * @brief function builds the lane level graph of the road network.
+ *      lanes with negative id are driven in s direction, lanes with positive id against s direction.
+ *      Longitudinal edges follow the lane links, junction edges the lane links of the junction connections
+ *      and lane change edges connect neighbouring driving lanes of the same direction.
+ *
+ * @param data      roadNetwork data
+ * @param g         lane graph
+ * @return int      error code
+ */
+int buildLaneGraph(const roadNetwork &data, laneGraph &g)
+{
+    g.nodes.clear();
+    g.edgeIndex.clear();
+    g.edges.clear();
+
+    laneGraphIndex index(data);
+
+    // --- nodes ---------------------------------------------------------------
+    for (const road &r : data.roads)
+    {
+        for (int k = 0; k < (int)r.laneSections.size(); k++)
+        {
+            const laneSection &sec = r.laneSections[k];
+            double end = (k + 1 < (int)r.laneSections.size()) ? r.laneSections[k + 1].s : r.length;
+
+            for (const lane &l : sec.lanes)
+            {
+                if (l.id == 0)
+                    continue;
+
+                laneGraphNode n;
+                n.road = r.id;
+                n.laneSection = k;
+                n.lane = l.id;
+                n.flags = (l.type == "driving") ? drivingLaneFlag : 0;
+                if (r.isConnectingRoad)
+                    n.flags |= connectingRoadFlag;
+                n.s = sec.s;
+                n.length = end - sec.s;
+                g.nodes.push_back(n);
+            }
+        }
+    }
+
+    // junction connections of each incoming road, together with the junction id
+    map<int, vector<pair<int, const connection *>>> incoming;
+    for (const junction &j : data.junctions)
+    {
+        for (const connection &c : j.connections)
+            incoming[c.from].push_back(make_pair(j.id, &c));
+    }
+
+    // --- edges ---------------------------------------------------------------
+    g.edgeIndex.reserve(g.nodes.size() + 1);
+    int node = 0;
+    for (int i = 0; i < (int)data.roads.size(); i++)
+    {
+        const road &r = data.roads[i];
+
+        for (int k = 0; k < (int)r.laneSections.size(); k++)
+        {
+            const laneSection &sec = r.laneSections[k];
+
+            for (const lane &l : sec.lanes)
+            {
+                if (l.id == 0)
+                    continue;
+
+                g.edgeIndex.push_back(g.edges.size());
+                double length = g.nodes[node].length;
+                node++;
+
+                // driving direction
+                int dir = (l.id < 0) ? 1 : -1;
+                int next = (dir == 1) ? l.sucId : l.preId;
+                const link &roadLink = (dir == 1) ? r.successor : r.predecessor;
+                bool lastSection = (dir == 1) ? (k + 1 == (int)r.laneSections.size()) : (k == 0);
+
+                // longitudinal
+                int to = -1;
+                if (!lastSection && next != 0)
+                    to = index.node(i, k + dir, next);
+                else if (lastSection && next != 0 && roadLink.elementType == roadType)
+                    to = index.node(roadLink, next);
+
+                if (to != -1)
+                    g.edges.push_back({(uint32_t)to, longitudinalEdge, length});
+
+                // junction
+                if (lastSection && roadLink.elementType == junctionType && incoming.count(r.id))
+                {
+                    for (const pair<int, const connection *> &jc : incoming[r.id])
+                    {
+                        const connection *c = jc.second;
+                        if (jc.first != roadLink.id || c->fromLane != l.id)
+                            continue;
+
+                        link connectingRoad;
+                        connectingRoad.id = c->to;
+                        connectingRoad.contactPoint = c->contactPoint;
+                        to = index.node(connectingRoad, c->toLane);
+                        if (to != -1)
+                            g.edges.push_back({(uint32_t)to, junctionEdge, length});
+                    }
+                }
+
+                // lane changes; on both sides the left neighbour in driving direction is the inner lane
+                if (l.type != "driving")
+                    continue;
+
+                const lane *inner = sec.lanes.get(l.id - sgn(l.id));
+                const lane *outer = sec.lanes.get(l.id + sgn(l.id));
+
+                if (inner != NULL && inner->id != 0 && inner->type == "driving" && laneChangeAllowed(*inner))
+                    g.edges.push_back({(uint32_t)index.node(i, k, inner->id), laneChangeLeftEdge, length});
+                if (outer != NULL && outer->type == "driving" && laneChangeAllowed(l))
+                    g.edges.push_back({(uint32_t)index.node(i, k, outer->id), laneChangeRightEdge, length});
+            }
+        }
+    }
+    g.edgeIndex.push_back(g.edges.size());
+
+    return 0;
+}
+
+/**
+ * @brief function writes the lane graph as binary file
+ *
+ * @param g         lane graph
+ * @param file      output file
+ * @return int      error code
+ */
+int writeLaneGraph(const laneGraph &g, string file)
+{
+    ofstream out(file, ios::binary | ios::trunc);
+    if (!out)
+    {
+        cerr << "ERR: lane graph file " << file << " can not be opened" << endl;
+        return 1;
+    }
+
+    // the edge index is padded, so that the edges are 8 byte aligned
+    uint32_t indexBytes = g.edgeIndex.size() * sizeof(uint32_t);
+    uint32_t padding = (8 - indexBytes % 8) % 8;
+
+    laneGraphHeader h;
+    memcpy(h.magic, "LANEGRPH", 8);
+    h.version = LANE_GRAPH_VERSION;
+    h.nNodes = g.nodes.size();
+    h.nEdges = g.edges.size();
+    h.nodeOffset = sizeof(laneGraphHeader);
+    h.indexOffset = h.nodeOffset + h.nNodes * sizeof(laneGraphNode);
+    h.edgeOffset = h.indexOffset + indexBytes + padding;
+
+    const char zeros[8] = {0};
+    out.write((const char *)&h, sizeof(h));
+    out.write((const char *)g.nodes.data(), g.nodes.size() * sizeof(laneGraphNode));
+    out.write((const char *)g.edgeIndex.data(), indexBytes);
+    out.write(zeros, padding);
+    out.write((const char *)g.edges.data(), g.edges.size() * sizeof(laneGraphEdge));
+
+    if (!out)
+    {
+        cerr << "ERR: lane graph could not be written to " << file << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief function builds the lane graph of the road network and writes it next to the .xodr file
+ *
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int exportLaneGraph(const roadNetwork &data)
+{
+    laneGraph g;
+    if (buildLaneGraph(data, g))
+    {
+        cerr << "ERR: error in buildLaneGraph" << endl;
+        return 1;
+    }
+
+    if (writeLaneGraph(g, data.outputFile + ".lanegraph"))
+        return 1;
+
+    if (!setting.suppressOutput)
+        cout << "\tLane graph: " << g.nodes.size() << " nodes, " << g.edges.size() << " edges" << endl;
+
+    return 0;
+}
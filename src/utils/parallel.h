@@ -0,0 +1,83 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file parallel.h
+ *
+ * @brief file contains a simple parallel loop over independent work items
+ *
+ *      worker threads have no run arena, so all containers created in a worker use the global heap.
+ *      Containers which were created outside of the worker must not grow inside of it.
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+#include <thread>
+#include <atomic>
+
+extern settings setting;
+
+/**
+ * @brief returns the number of worker threads for n work items
+ *
+ * @param n     number of work items
+ * @return int  number of threads, 1 if the items should be processed serially
+ */
+int workerThreads(int n)
+{
+#ifdef TRACK_ALLOCATIONS
+    // the allocation counters are not synchronized
+    return 1;
+#endif
+    int threads = setting.threads;
+    if (threads <= 0)
+        threads = std::thread::hardware_concurrency();
+    if (threads <= 0)
+        threads = 1;
+    return std::max(1, std::min(threads, n));
+}
+
+/**
+ * @brief function calls f(i) for i = 0..n-1; the calls are distributed over the worker threads.
+ *      The calls have to be independent of each other, the order of execution is not defined.
+ *
+ * @param n         number of work items
+ * @param f         work function
+ */
+template <class F>
+void parallelFor(int n, F f)
+{
+    int threads = workerThreads(n);
+    if (threads <= 1)
+    {
+        for (int i = 0; i < n; i++)
+            f(i);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        for (int i = next++; i < n; i = next++)
+            f(i);
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++)
+        workers.push_back(std::thread(work));
+
+    // the calling thread works without its arena as well, so that all items are built the same way
+    {
+        heapScope scope;
+        work();
+    }
+
+    for (std::thread &t : workers)
+        t.join();
+}
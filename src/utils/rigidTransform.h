@@ -0,0 +1,160 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file rigidTransform.h
+ *
+ * @brief file contains the rigid transformation of whole segments in the x/y plane
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+#pragma once
+#include <map>
+
+/**
+ * @brief rigid transformation (rotation around the origin followed by a shift)
+ *      p' = R(dPhi) * p + (dx, dy)
+ *
+ */
+struct rigidTransform
+{
+    double dPhi = 0;
+    double cosPhi = 1;
+    double sinPhi = 0;
+    double dx = 0;
+    double dy = 0;
+
+    bool identity = true; // nothing has to be applied
+    bool fixHdg = false;  // resulting angles are fixed to [-M_PI, M_PI]
+
+    /**
+     * @brief appends a rotation around the origin followed by a shift to the pending transformation
+     *
+     * @param phi   angle of the rotation
+     * @param x     shift in x direction
+     * @param y     shift in y direction
+     * @param fix   determines if the resulting angles should be fixed
+     */
+    void compose(double phi, double x, double y, bool fix)
+    {
+        double c = cos(phi);
+        double s = sin(phi);
+
+        double tx = c * dx - s * dy;
+        double ty = s * dx + c * dy;
+
+        dPhi += phi;
+        cosPhi = cos(dPhi);
+        sinPhi = sin(dPhi);
+        dx = tx + x;
+        dy = ty + y;
+
+        identity = false;
+        fixHdg = fixHdg || fix;
+    }
+
+    /**
+     * @brief applies the transformation to a single pose
+     *
+     * @param x     x component
+     * @param y     y component
+     * @param hdg   angle
+     */
+    void apply(double &x, double &y, double &hdg) const
+    {
+        if (identity)
+            return;
+
+        double xTmp = cosPhi * x - sinPhi * y + dx;
+        double yTmp = sinPhi * x + cosPhi * y + dy;
+
+        x = xTmp;
+        y = yTmp;
+        hdg += dPhi;
+        if (fixHdg)
+            fixAngle(hdg);
+    }
+};
+
+/**
+ * @brief kernel applies a rigid transformation to packed pose arrays
+ *      the loops are free of branches and dependencies, so that the compiler can vectorize them
+ *
+ * @param x     packed x components
+ * @param y     packed y components
+ * @param hdg   packed angles
+ * @param n     number of poses
+ * @param t     transformation
+ * @return int  error code
+ */
+int transformPoses(double *x, double *y, double *hdg, int n, const rigidTransform &t)
+{
+    const double c = t.cosPhi;
+    const double s = t.sinPhi;
+    const double dx = t.dx;
+    const double dy = t.dy;
+    const double dPhi = t.dPhi;
+
+    for (int k = 0; k < n; k++)
+    {
+        double xTmp = x[k];
+        double yTmp = y[k];
+        x[k] = c * xTmp - s * yTmp + dx;
+        y[k] = s * xTmp + c * yTmp + dy;
+    }
+
+    for (int k = 0; k < n; k++)
+        hdg[k] += dPhi;
+
+    if (t.fixHdg)
+    {
+        for (int k = 0; k < n; k++)
+            fixAngle(hdg[k]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief function determines the segment a road belongs to
+ *
+ * @param r     road data
+ * @return int  id of the input segment
+ */
+int segmentOfRoad(const road &r)
+{
+    if (r.roundAboutInputSegment != -1)
+        return r.roundAboutInputSegment;
+    return r.junction;
+}
+
+/**
+ * @brief function applies all pending segment transformations at once
+ *      the kernel works directly on the x/y/hdg columns of the reference lines
+ *
+ * @param data      roadNetwork data
+ * @param pending   pending transformations stored by segment id
+ * @return int      error code
+ */
+int applySegmentTransforms(roadNetwork &data, std::map<int, rigidTransform> &pending)
+{
+    for (road &r : data.roads)
+    {
+        std::map<int, rigidTransform>::iterator it = pending.find(segmentOfRoad(r));
+        if (it == pending.end() || it->second.identity)
+            continue;
+
+        referenceLine &ref = r.geometries;
+        transformPoses(ref.x.data(), ref.y.data(), ref.hdg.data(), ref.size(), it->second);
+    }
+
+    pending.clear();
+
+    return 0;
+}
@@ -83,6 +83,21 @@ struct settings
 
     float minConnectingRoadLength = 0.01f;
 
+    double elevationTolerance = 0.001; // max deviation when merging elevation polynoms
+    double gradeTolerance = 0.01; // max grade jump at road links in the elevation check
+    double maxGrade = 0.12; // max allowed grade in the elevation check
+    bool checkElevation = false; // sample the elevation and check its continuity after generation
+    double elevationSampleStep = 1; // unit m, sample step of the elevation check, max step in adaptive mode
+    bool adaptiveElevationSampling = false; // reduce the sample step of curved elevation polynoms to meet elevationTolerance
+    bool checkJunctions = false; // check the generated junctions for crossing lane borders before the output is written
+    bool leastSquaresElevation = false; // solve all elevation offsets at once instead of propagating them along the road links
+    bool exportLaneGraph = false; // write the lane level graph of the network as binary file next to the .xodr
+    int threads = 0; // worker threads for independent computations, 0: number of hardware threads, 1: serial
+    bool junctionCache = false; // reuse the connecting roads of identical junctions of previous runs
+    std::string junctionCacheDir = ""; // directory of the persistent junction cache, empty: the cache is only kept in memory
+    int closeRoadMaxGeometries = 16; // geometry budget of one closed road, afterwards the road is connected by two arcs
+    double closeRoadTolerance = 1e-6; // tolerance for parallel angles and zero distances when closing roads
+
     // basis in world coordinate system
     double north = 0;
     double south = 0;
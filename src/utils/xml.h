@@ -178,6 +178,25 @@ int createXMLXercesC(roadNetwork &data)
     geoReference.domelement->appendChild(cdata);
     geoReference.appendToNode(header);
 
+    // ids which could not follow the naming scheme of their segment
+    if (!data.ids.remap.empty())
+    {
+        nodeElement userData("userData");
+        userData.addAttribute("code", "idRemap");
+        userData.addAttribute("value", (int)data.ids.remap.size());
+        userData.appendToNode(header);
+
+        for (const idRemap &entry : data.ids.remap)
+        {
+            nodeElement remap("remap");
+            remap.addAttribute("type", entry.junction ? "junction" : "road");
+            remap.addAttribute("segment", entry.segment);
+            remap.addAttribute("legacyId", entry.legacyId);
+            remap.addAttribute("id", entry.id);
+            remap.appendToNode(userData);
+        }
+    }
+
     header.appendToNode(root);
 
 
@@ -187,7 +206,7 @@ int createXMLXercesC(roadNetwork &data)
     //geoReference.appendToNode(root);
   
      // --- write roads ---------------------------------------------------------
-    for (std::vector<road>::iterator it = data.roads.begin(); it != data.roads.end(); ++it)
+    for (arenaVector<road>::iterator it = data.roads.begin(); it != data.roads.end(); ++it)
     {
 
         nodeElement road("road");
@@ -209,33 +228,34 @@ int createXMLXercesC(roadNetwork &data)
         nodeElement planView("planView");
         planView.appendToNode(road);
 
-        for (std::vector<geometry>::iterator itt = it->geometries.begin(); itt != it->geometries.end(); ++itt)
+        const referenceLine &ref = it->geometries;
+        for (int k = 0; k < (int)ref.size(); k++)
         {
             nodeElement geo("geometry");
             geo.appendToNode(planView);
 
-            geo.addAttribute("s", itt->s);
-            geo.addAttribute("x", itt->x);
-            geo.addAttribute("y", itt->y);
-            geo.addAttribute("hdg", itt->hdg);
-            geo.addAttribute("length", itt->length);
+            geo.addAttribute("s", ref.s[k]);
+            geo.addAttribute("x", ref.x[k]);
+            geo.addAttribute("y", ref.y[k]);
+            geo.addAttribute("hdg", ref.hdg[k]);
+            geo.addAttribute("length", ref.length[k]);
 
-            if (itt->type == line)
+            if (ref.type[k] == line)
             {
                 nodeElement line("line");
                 line.appendToNode(geo);
             }
-            if (itt->type == arc)
+            if (ref.type[k] == arc)
             {
                 nodeElement arc("arc");
-                arc.addAttribute("curvature", itt->c);
+                arc.addAttribute("curvature", ref.c(k));
                 arc.appendToNode(geo);
             }
-            if (itt->type == spiral)
+            if (ref.type[k] == spiral)
             {
                 nodeElement arc("spiral");
-                arc.addAttribute("curvStart", itt->c1);
-                arc.addAttribute("curvEnd", itt->c2);
+                arc.addAttribute("curvStart", ref.c1(k));
+                arc.addAttribute("curvEnd", ref.c2(k));
                 arc.appendToNode(geo);
 
             }
@@ -269,7 +289,7 @@ int createXMLXercesC(roadNetwork &data)
         nodeElement lanes("lanes");
         lanes.appendToNode(road);
 
-        for (std::vector<laneSection>::iterator itt = it->laneSections.begin(); itt != it->laneSections.end(); ++itt)
+        for (arenaVector<laneSection>::iterator itt = it->laneSections.begin(); itt != it->laneSections.end(); ++itt)
         {
             nodeElement laneOffset("laneOffset");
             laneOffset.appendToNode(lanes);
@@ -281,7 +301,7 @@ int createXMLXercesC(roadNetwork &data)
             laneOffset.addAttribute("d", itt->o.d);
         }
 
-        for (std::vector<laneSection>::iterator itt = it->laneSections.begin(); itt != it->laneSections.end(); ++itt)
+        for (arenaVector<laneSection>::iterator itt = it->laneSections.begin(); itt != it->laneSections.end(); ++itt)
         {
             nodeElement laneSection("laneSection");
             laneSection.appendToNode(lanes);
@@ -297,8 +317,8 @@ int createXMLXercesC(roadNetwork &data)
             if (findMinLaneId(*itt) < 0)
                 right.appendToNode(laneSection);
 
-            std::sort(itt->lanes.begin(), itt->lanes.end(), compareLanes);
-            for (std::vector<lane>::iterator ittt = itt->lanes.begin(); ittt != itt->lanes.end(); ++ittt)
+            // lanes are always sorted by id
+            for (laneTable::iterator ittt = itt->lanes.begin(); ittt != itt->lanes.end(); ++ittt)
             {
                 nodeElement lane("lane");
 
@@ -316,7 +336,7 @@ int createXMLXercesC(roadNetwork &data)
                 }
 
                 lane.addAttribute("id", ittt->id);
-                lane.addAttribute("type", ittt->type);
+                lane.addAttribute("type", ittt->type.c_str());
 
                 if (ittt->id != 0)
                 {
@@ -358,7 +378,7 @@ int createXMLXercesC(roadNetwork &data)
                     nodeElement material("material");
                     material.appendToNode(lane);
                     material.addAttribute("sOffset", ittt->m.s);
-                    material.addAttribute("surface", ittt->m.surface);
+                    material.addAttribute("surface", ittt->m.surface.c_str());
                     material.addAttribute("friction", ittt->m.friction);
                     material.addAttribute("roughness", ittt->m.roughness);
 
@@ -376,13 +396,13 @@ int createXMLXercesC(roadNetwork &data)
         objects.appendToNode(road);
 
         std::sort(it->objects.begin(), it->objects.end(), compareObjects);
-        for (std::vector<object>::iterator itt = it->objects.begin(); itt != it->objects.end(); ++itt)
+        for (arenaVector<object>::iterator itt = it->objects.begin(); itt != it->objects.end(); ++itt)
         {
             object o = *itt;
             nodeElement obj("object");
             obj.appendToNode(objects);
-            obj.addAttribute("type", o.type);
-            obj.addAttribute("name", o.type);
+            obj.addAttribute("type", o.type.c_str());
+            obj.addAttribute("name", o.type.c_str());
             obj.addAttribute("dynamic", "no");
             obj.addAttribute("id", o.id);
             obj.addAttribute("s", (o.s));
@@ -392,7 +412,7 @@ int createXMLXercesC(roadNetwork &data)
             obj.addAttribute("pitch", 0);
             obj.addAttribute("roll", 0);
             obj.addAttribute("validLength", 0);
-            obj.addAttribute("orientation", o.orientation);
+            obj.addAttribute("orientation", o.orientation.c_str());
             obj.addAttribute("length", o.length);
             obj.addAttribute("width", o.width);
             obj.addAttribute("height", o.height);
@@ -425,21 +445,21 @@ int createXMLXercesC(roadNetwork &data)
             nodeElement signs("signals", road);
 
             std::sort(it->signs.begin(), it->signs.end(), compareSignals);
-            for (std::vector<sign>::iterator itt = it->signs.begin(); itt != it->signs.end(); ++itt)
+            for (arenaVector<sign>::iterator itt = it->signs.begin(); itt != it->signs.end(); ++itt)
             {
                 sign s = *itt;
                 nodeElement sig("signal", signs);
                 //pugi::xml_node sig = objects.append_child("object");
 
                 sig.addAttribute("id", s.id);
-                sig.addAttribute("name", s.type);
-                sig.addAttribute("type", s.type);
-                sig.addAttribute("subtype", s.subtype);
+                sig.addAttribute("name", s.type.c_str());
+                sig.addAttribute("type", s.type.c_str());
+                sig.addAttribute("subtype", s.subtype.c_str());
                 sig.addAttribute("country", s.country);
                 sig.addAttribute("s", s.s);
                 sig.addAttribute("t", s.t);
                 sig.addAttribute("zOffset", s.z);
-                sig.addAttribute("orientation", s.orientation);
+                sig.addAttribute("orientation", s.orientation.c_str());
                 if (s.dynamic)
                     sig.addAttribute("dynamic", "yes");
                 else
@@ -456,13 +476,13 @@ int createXMLXercesC(roadNetwork &data)
     // controllers format is different in version 1.4
     if (setting.versionMajor >= 1 && setting.versionMinor >= 5)
     {
-        for (std::vector<control>::iterator it = data.controller.begin(); it != data.controller.end(); ++it)
+        for (arenaVector<control>::iterator it = data.controller.begin(); it != data.controller.end(); ++it)
         {
             nodeElement controller("controller");
             controller.appendToNode(root);
             controller.addAttribute("id", it->id);
 
-            for (std::vector<sign>::iterator itt = it->signs.begin(); itt != it->signs.end(); ++itt)
+            for (arenaVector<sign>::iterator itt = it->signs.begin(); itt != it->signs.end(); ++itt)
             {
                 nodeElement con("control", controller);
                 con.addAttribute("signalId", itt->id);
@@ -471,13 +491,13 @@ int createXMLXercesC(roadNetwork &data)
     }
 
     // --- write junctions -----------------------------------------------------
-    for (std::vector<junction>::iterator it = data.junctions.begin(); it != data.junctions.end(); ++it)
+    for (arenaVector<junction>::iterator it = data.junctions.begin(); it != data.junctions.end(); ++it)
     {
         nodeElement junc("junction");
         junc.appendToNode(root);
         junc.addAttribute("id", it->id);
 
-        for (std::vector<connection>::iterator itt = it->connections.begin(); itt != it->connections.end(); ++itt)
+        for (arenaVector<connection>::iterator itt = it->connections.begin(); itt != it->connections.end(); ++itt)
         {
             nodeElement con("connection", junc);
 
@@ -493,7 +513,7 @@ int createXMLXercesC(roadNetwork &data)
     }
     // --- write junction groups -----------------------------------------------------
 
-    for (std::vector<junctionGroup>::iterator it = data.juncGroups.begin(); it != data.juncGroups.end(); ++it)
+    for (arenaVector<junctionGroup>::iterator it = data.juncGroups.begin(); it != data.juncGroups.end(); ++it)
     {
 
         nodeElement juncGroup("junctionGroup");
@@ -503,7 +523,7 @@ int createXMLXercesC(roadNetwork &data)
         juncGroup.addAttribute("type", it->type);
 
 
-        for (std::vector<int>::iterator itt = it->juncIds.begin(); itt != it->juncIds.end(); ++itt)
+        for (arenaVector<int>::iterator itt = it->juncIds.begin(); itt != it->juncIds.end(); ++itt)
         {
             nodeElement juncRef("junctionReference", juncGroup);
             juncRef.addAttribute("junction", *itt);
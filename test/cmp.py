@@ -65,7 +65,7 @@ def cmp_xml_list(list1, list2):
             number1 = float(list1[i])
             number2 = float(list2[i])
 
-            if abs(number1-number2 > threshold): 
+            if abs(number1-number2) > threshold: 
                 e_diff += 1
                 print ("diff: ", list1[i], list2[i])
             else:
@@ -0,0 +1,169 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file arenaTest.cpp
+ *
+ * @brief file contains the tests of the run arena and the arena allocator
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+#include <thread>
+#include <cstdint>
+
+/**
+ * @brief memory is aligned, does not overlap and the blocks are reused after a reset
+ *
+ */
+void testAllocate()
+{
+    runArena arena(1024);
+    CHECK(arena.capacity() == 0);
+
+    mt19937 rng(3);
+    vector<pair<char *, size_t>> chunks;
+    vector<size_t> aligns;
+    for (int k = 0; k < 200; k++)
+    {
+        size_t size = 1 + rng() % 300;
+        size_t align = (size_t)1 << (rng() % 5);
+        char *ptr = (char *)arena.allocate(size, align);
+        CHECK((uintptr_t)ptr % align == 0);
+        memset(ptr, k, size);
+        chunks.push_back(make_pair(ptr, size));
+        aligns.push_back(align);
+    }
+
+    // every chunk still holds its own value
+    for (int k = 0; k < (int)chunks.size(); k++)
+    {
+        for (size_t b = 0; b < chunks[k].second; b++)
+            CHECK(chunks[k].first[b] == (char)k);
+    }
+
+    // a request which is larger than the block size gets its own block
+    size_t before = arena.capacity();
+    arena.allocate(5000, 8);
+    CHECK(arena.capacity() >= before + 5000);
+
+    // the same requests in a second run do not reserve new blocks
+    size_t capacity = arena.capacity();
+    arena.reset();
+    for (int k = 0; k < (int)chunks.size(); k++)
+        CHECK(arena.allocate(chunks[k].second, aligns[k]) == chunks[k].first);
+    arena.allocate(5000, 8);
+    CHECK(arena.capacity() == capacity);
+
+    arena.release();
+    CHECK(arena.capacity() == 0);
+}
+
+/**
+ * @brief containers use the arena of the scope in which they were created
+ *
+ */
+void testScopes()
+{
+    runArena arena;
+    CHECK(currentArena() == NULL);
+
+    arenaVector<int> heapVector;
+    CHECK(heapVector.get_allocator().arena == NULL);
+
+    {
+        arenaScope scope(arena);
+        CHECK(currentArena() == &arena);
+
+        arenaVector<int> v(100, 7);
+        CHECK(v.get_allocator().arena == &arena);
+        CHECK(arena.capacity() > 0);
+
+        // copies are placed in the arena of the copying thread
+        arenaVector<int> copy = heapVector;
+        CHECK(copy.get_allocator().arena == &arena);
+
+        {
+            heapScope heap;
+            CHECK(currentArena() == NULL);
+            arenaVector<int> cached(v);
+            CHECK(cached.get_allocator().arena == NULL);
+            CHECK(cached.size() == 100 && cached[99] == 7);
+        }
+        CHECK(currentArena() == &arena);
+
+        // other threads have no arena
+        runArena *other = &arena;
+        std::thread t([&other]() { other = currentArena(); });
+        t.join();
+        CHECK(other == NULL);
+
+        // a moved container keeps the arena of its source
+        arenaVector<int> moved;
+        {
+            heapScope heap;
+            moved = arenaVector<int>(10, 1);
+        }
+        CHECK(moved.get_allocator().arena == NULL);
+    }
+
+    CHECK(currentArena() == NULL);
+}
+
+/**
+ * @brief a road network can be filled in the arena and the arena can be reused by the next run
+ *
+ */
+void testRuns()
+{
+    runArena arena;
+    size_t capacity = 0;
+
+    for (int run = 0; run < 3; run++)
+    {
+        arena.reset();
+        arenaScope scope(arena);
+
+        roadNetwork data;
+        for (int k = 0; k < 50; k++)
+        {
+            road r;
+            r.id = k;
+            laneSection ls;
+            for (int id = -2; id <= 2; id++)
+            {
+                lane l;
+                l.id = id;
+                ls.lanes.push_back(l);
+            }
+            r.laneSections.push_back(ls);
+            data.roads.push_back(r);
+        }
+
+        CHECK(data.roads.size() == 50);
+        CHECK(data.roads[49].laneSections[0].lanes.get(-2) != NULL);
+
+        if (run == 1)
+            capacity = arena.capacity();
+        if (run == 2)
+            CHECK(arena.capacity() == capacity);
+    }
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testAllocate();
+    testScopes();
+    testRuns();
+
+    return testResult("arenaTest");
+}
@@ -0,0 +1,155 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file closeRoadEndTest.cpp
+ *
+ * @brief file contains the randomized test of the indexed end point resolution of closing roads
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief resolves the roads at one end of a closing road by the scan over all roads which was used before the index
+ *
+ * @param roads         all roads
+ * @param segment       segment of the road
+ * @param roadId        input id of the road
+ * @param checkPos      if true, the roads have to match the position
+ * @param junctionEnd   if true, the position is set to "end" after the first match
+ * @param pos           position of the end point at the road
+ * @param matches       indices of all matching roads
+ * @return int          error code, 1 if the position is neither "start" nor "end"
+ */
+int scanCloseRoadEnd(const arenaVector<road> &roads, int segment, int roadId, bool checkPos, bool junctionEnd, string &pos, vector<int> &matches)
+{
+    for (int k = 0; k < (int)roads.size(); k++)
+    {
+        const road &r = roads[k];
+        if (r.junction != segment || r.inputId != roadId)
+            continue;
+        if (checkPos && r.inputPos != pos)
+            continue;
+
+        matches.push_back(k);
+        roadId = r.id;
+
+        if (junctionEnd)
+            pos = "end";
+
+        if (pos != "start" && pos != "end")
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief the index gives the same roads, positions and errors as the scan on random road networks.
+ *      Few distinct ids are used, so that the ids of matching roads are often input ids of other roads.
+ *
+ */
+void testRandomNetworks()
+{
+    mt19937 rng(13);
+    const char *positions[3] = {"start", "end", "middle"};
+
+    int chains = 0;
+    for (int run = 0; run < 5000; run++)
+    {
+        arenaVector<road> roads;
+        int nRoads = 1 + rng() % 30;
+        for (int k = 0; k < nRoads; k++)
+        {
+            road r;
+            r.id = rng() % 6;
+            r.junction = rng() % 3;
+            r.inputId = rng() % 6;
+            r.inputPos = positions[rng() % 3];
+            roads.push_back(r);
+        }
+
+        map<pair<int, int>, vector<int>> index;
+        for (int k = 0; k < (int)roads.size(); k++)
+            index[make_pair(roads[k].junction, roads[k].inputId)].push_back(k);
+
+        int segment = rng() % 3;
+        int roadId = rng() % 6;
+        bool checkPos = rng() % 2;
+        bool junctionEnd = rng() % 2;
+        string pos = positions[rng() % 3];
+
+        string posIndex = pos, posScan = pos;
+        vector<int> matchesIndex, matchesScan;
+        int resIndex = resolveCloseRoadEnd(index, roads, segment, roadId, checkPos, junctionEnd, posIndex, matchesIndex);
+        int resScan = scanCloseRoadEnd(roads, segment, roadId, checkPos, junctionEnd, posScan, matchesScan);
+
+        CHECK(resIndex == resScan);
+        CHECK(posIndex == posScan);
+        CHECK(matchesIndex == matchesScan);
+        chains += matchesScan.size() > 1;
+    }
+
+    // the chained matches have to be covered
+    CHECK(chains > 100);
+}
+
+/**
+ * @brief a junction end matches by position and continues at the end of the matching road
+ *
+ */
+void testJunctionEnd()
+{
+    arenaVector<road> roads;
+    for (int k = 0; k < 3; k++)
+    {
+        road r;
+        r.id = 10 + k;
+        r.junction = 1;
+        r.inputId = 2;
+        r.inputPos = (k == 1) ? "end" : "start";
+        roads.push_back(r);
+    }
+
+    map<pair<int, int>, vector<int>> index;
+    for (int k = 0; k < (int)roads.size(); k++)
+        index[make_pair(roads[k].junction, roads[k].inputId)].push_back(k);
+
+    string pos = "end";
+    vector<int> matches;
+    CHECK(resolveCloseRoadEnd(index, roads, 1, 2, true, true, pos, matches) == 0);
+    CHECK(matches.size() == 1 && matches[0] == 1 && pos == "end");
+
+    pos = "start";
+    matches.clear();
+    CHECK(resolveCloseRoadEnd(index, roads, 1, 2, true, true, pos, matches) == 0);
+    CHECK(matches.size() == 1 && matches[0] == 0 && pos == "end");
+
+    // unknown segment or road
+    pos = "start";
+    matches.clear();
+    CHECK(resolveCloseRoadEnd(index, roads, 2, 2, false, false, pos, matches) == 0);
+    CHECK(matches.empty() && pos == "start");
+
+    // invalid position
+    pos = "middle";
+    matches.clear();
+    CHECK(resolveCloseRoadEnd(index, roads, 1, 2, false, false, pos, matches) == 1);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testRandomNetworks();
+    testJunctionEnd();
+
+    return testResult("closeRoadEndTest");
+}
@@ -0,0 +1,170 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file closeRoadTest.cpp
+ *
+ * @brief file contains the tests of the iterative road closure and its biarc fallback
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief returns the difference of two angles in [-pi, pi]
+ */
+double angleDiff(double a, double b)
+{
+    double d = a - b;
+    fixAngle(d);
+    return d;
+}
+
+/**
+ * @brief checks that the geometries form a continuous chain from the start pose to the end pose
+ *
+ * @param geo       geometries
+ * @param x1        x component of start point
+ * @param y1        y component of start point
+ * @param phi1      angle of start point
+ * @param x2        x component of end point
+ * @param y2        y component of end point
+ * @param phi2      angle of end point
+ * @param tol       position and angle tolerance
+ * @return bool     true if the chain is continuous
+ */
+bool isContinuous(const referenceLine &geo, double x1, double y1, double phi1, double x2, double y2, double phi2, double tol)
+{
+    if (geo.empty())
+        return false;
+
+    double x = x1, y = y1, phi = phi1, s = 0;
+    for (geometry g : geo)
+    {
+        if (!(g.length >= 0) || fabs(g.s - s) > tol)
+            return false;
+        if (fabs(g.x - x) > tol || fabs(g.y - y) > tol || fabs(angleDiff(g.hdg, phi)) > tol)
+            return false;
+
+        x = g.x;
+        y = g.y;
+        phi = g.hdg;
+        curve(g.length, g, x, y, phi, 1);
+        s += g.length;
+    }
+    return fabs(x - x2) <= tol && fabs(y - y2) <= tol && fabs(angleDiff(phi, phi2)) <= tol;
+}
+
+/**
+ * @brief every closure of random poses is a continuous chain within the geometry budget
+ *
+ */
+void testRandomClosures()
+{
+    mt19937 rng(5);
+    uniform_real_distribution<double> position(-200, 200);
+    uniform_real_distribution<double> angle(-M_PI, M_PI);
+
+    int biarcs = 0;
+    for (int run = 0; run < 5000; run++)
+    {
+        double x1 = position(rng), y1 = position(rng), phi1 = angle(rng);
+        double x2 = position(rng), y2 = position(rng), phi2 = angle(rng);
+
+        // parallel poses are rare in random inputs, so every tenth input gets the same or the opposite angle
+        if (run % 10 == 0)
+            phi2 = phi1 + ((run % 20 == 0) ? 0 : M_PI);
+
+        referenceLine geo;
+        closeRoadReport report;
+        CHECK(closeRoadConnection(geo, x1, y1, phi1, x2, y2, phi2, report) == 0);
+        CHECK(isContinuous(geo, x1, y1, phi1, x2, y2, phi2, 1e-6));
+        CHECK(report.geometries == (int)geo.size());
+        CHECK(report.steps >= 1);
+
+        // the biarc of the fallback adds up to three primitives
+        CHECK(report.geometries <= setting.closeRoadMaxGeometries + 3);
+        if (report.budgetExceeded)
+            CHECK(report.biarc && report.geometries <= 3);
+        biarcs += report.biarc;
+    }
+    CHECK(biarcs > 0);
+}
+
+/**
+ * @brief parallel poses are closed by a biarc, unless the end point lies ahead on the same line
+ *
+ */
+void testParallel()
+{
+    referenceLine geo;
+    closeRoadReport report;
+
+    // ahead on the same line: one line
+    CHECK(closeRoadConnection(geo, 0, 0, 0, 50, 0, 0, report) == 0);
+    CHECK(!report.biarc && geo.size() == 1 && geo[0].type == line);
+    CHECK(isContinuous(geo, 0, 0, 0, 50, 0, 0, 1e-9));
+
+    // lateral offset with the same angle: s-curve
+    geo.clear();
+    CHECK(closeRoadConnection(geo, 0, 0, 0, 50, 10, 0, report) == 0);
+    CHECK(report.biarc && geo.size() == 2);
+    CHECK(isContinuous(geo, 0, 0, 0, 50, 10, 0, 1e-9));
+
+    // behind with the same angle: quarter circle first
+    geo.clear();
+    CHECK(closeRoadConnection(geo, 0, 0, 0, -50, 10, 0, report) == 0);
+    CHECK(report.biarc && geo.size() == 3);
+    CHECK(isContinuous(geo, 0, 0, 0, -50, 10, 0, 1e-9));
+
+    // opposite angle: u-turn
+    geo.clear();
+    CHECK(closeRoadConnection(geo, 0, 0, 0, 0, 20, M_PI, report) == 0);
+    CHECK(report.biarc);
+    CHECK(isContinuous(geo, 0, 0, 0, 0, 20, M_PI, 1e-9));
+
+    // identical points can not be closed
+    geo.clear();
+    CHECK(closeRoadConnection(geo, 5, 5, 0, 5, 5, 0, report) == 1);
+}
+
+/**
+ * @brief if the helping geometries exceed the budget, they are discarded and both points are connected by a biarc
+ *
+ */
+void testBudget()
+{
+    int budget = setting.closeRoadMaxGeometries;
+    setting.closeRoadMaxGeometries = 1;
+
+    // geometries of a previous road in the same vector are kept
+    referenceLine geo;
+    addLine(geo, -10, 0, 0, 0, 0, 0);
+
+    closeRoadReport report;
+    CHECK(closeRoadConnection(geo, 0, 0, 0, -30, 40, -M_PI / 2, report) == 0);
+    CHECK(report.budgetExceeded && report.biarc);
+    CHECK((int)geo.size() == 1 + report.geometries && report.geometries <= 3);
+    CHECK(geo[0].type == line && geo[0].x == -10 && geo[0].length == 10);
+    CHECK(isContinuous(geo, -10, 0, 0, -30, 40, -M_PI / 2, 1e-9));
+
+    setting.closeRoadMaxGeometries = budget;
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testRandomClosures();
+    testParallel();
+    testBudget();
+
+    return testResult("closeRoadTest");
+}
@@ -0,0 +1,171 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file elevationCheckTest.cpp
+ *
+ * @brief file contains the tests of the elevation sampler and of the continuity check
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief sets the output elevation of a road to one polynom
+ *
+ * @param r     road
+ * @param a     elevation at the road start
+ * @param b     grade at the road start
+ * @param c     quadratic coefficient
+ */
+void setElevation(road &r, double a, double b, double c = 0)
+{
+    elevationPolynom p;
+    p.a = a;
+    p.b = b;
+    p.c = c;
+
+    elevationProfile ep;
+    ep.outputElevation.push_back(p);
+
+    r.elevationProfiles.clear();
+    r.elevationProfiles.push_back(ep);
+}
+
+/**
+ * @brief road 1 is followed by road 2, both rise by 2 %
+ *
+ * @param data      roadNetwork data
+ */
+void buildNetwork(roadNetwork &data)
+{
+    road r1;
+    r1.id = 1;
+    r1.length = 100;
+    r1.successor.id = 2;
+    r1.successor.contactPoint = startType;
+    setElevation(r1, 0, 0.02);
+
+    road r2;
+    r2.id = 2;
+    r2.length = 50;
+    r2.predecessor.id = 1;
+    r2.predecessor.contactPoint = endType;
+    setElevation(r2, 2, 0.02);
+
+    data.roads.push_back(r1);
+    data.roads.push_back(r2);
+}
+
+/**
+ * @brief the samples cover the road with the step and equal the polynoms, the adaptive step meets the tolerance
+ *
+ */
+void testSampling()
+{
+    road r;
+    r.id = 1;
+    r.length = 10;
+
+    elevationProfile ep;
+    elevationPolynom p1;
+    p1.a = 1;
+    p1.b = 0.1;
+    elevationPolynom p2;
+    p2.s = 4;
+    p2.a = 1.4;
+    p2.b = 0.1;
+    p2.c = 0.05;
+    ep.outputElevation.push_back(p1);
+    ep.outputElevation.push_back(p2);
+    r.elevationProfiles.push_back(ep);
+
+    elevationSamples samples;
+    CHECK(sampleElevation(r, 1, false, samples) == 0);
+    CHECK(samples.s.size() == 4 + 7);
+    CHECK(samples.s.front() == 0 && samples.s.back() == 10);
+    for (int k = 0; k < (int)samples.s.size(); k++)
+    {
+        const elevationPolynom &p = (samples.s[k] < 4) ? p1 : p2;
+        double ds = samples.s[k] - p.s;
+        CHECK_NEAR(samples.z[k], p.a + p.b * ds + p.c * ds * ds, 1e-12);
+        CHECK_NEAR(samples.grade[k], p.b + 2 * p.c * ds, 1e-12);
+        CHECK(k == 0 || samples.s[k] > samples.s[k - 1]);
+    }
+
+    // the straight polynom keeps the step, the curved one is sampled finer until the linear interpolation meets the tolerance
+    CHECK(sampleElevation(r, 1, true, samples) == 0);
+    CHECK(samples.s.size() > 4 + 7);
+    for (int k = 1; k < (int)samples.s.size(); k++)
+    {
+        double h = samples.s[k] - samples.s[k - 1];
+        CHECK(h <= 1 + 1e-12);
+        if (samples.s[k - 1] >= 4)
+            CHECK(h * h / 8 * 2 * p2.c <= setting.elevationTolerance + 1e-12);
+    }
+
+    CHECK(sampleElevation(r, 0, false, samples) == 1);
+}
+
+/**
+ * @brief continuous roads pass the check, a height step breaks C0 and a grade jump breaks C1
+ *
+ */
+void testContinuity()
+{
+    roadNetwork data;
+    buildNetwork(data);
+
+    elevationReport report;
+    CHECK(checkElevation(data, report) == 0);
+    CHECK(report.c0Violations == 0 && report.c1Violations == 0);
+    CHECK_NEAR(report.maxGrade, 0.02, 1e-12);
+    CHECK(report.maxHeightGap < 1e-12 && report.maxGradeGap < 1e-12);
+
+    // height step of 0.5 m at the link
+    setElevation(data.roads[1], 2.5, 0.02);
+    CHECK(checkElevation(data, report) == 1);
+    CHECK(report.c0Violations == 1 && report.c1Violations == 0);
+    CHECK_NEAR(report.maxHeightGap, 0.5, 1e-12);
+
+    // continuous height, but the grade jumps from 2 % to 6 %
+    setElevation(data.roads[1], 2, 0.06);
+    CHECK(checkElevation(data, report) == 1);
+    CHECK(report.c0Violations == 0 && report.c1Violations == 1);
+    CHECK_NEAR(report.maxGradeGap, 0.04, 1e-12);
+
+    // both at once
+    setElevation(data.roads[1], 2.5, 0.06);
+    CHECK(checkElevation(data, report) == 1);
+    CHECK(report.c0Violations == 1 && report.c1Violations == 1);
+
+    // the second road is reversed: it starts at the end of the first one and falls in its own direction
+    setElevation(data.roads[1], 3, -0.02);
+    data.roads[1].predecessor.id = -1;
+    data.roads[1].successor.id = 1;
+    data.roads[1].successor.contactPoint = endType;
+    data.roads[0].successor.contactPoint = endType;
+    CHECK(checkElevation(data, report) == 0);
+
+    // a grade above the maximal grade
+    setElevation(data.roads[0], -13, 0.15);
+    CHECK(checkElevation(data, report) == 1);
+    CHECK(report.gradeViolations == 1 && report.maxGradeRoad == 1);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testSampling();
+    testContinuity();
+
+    return testResult("elevationCheckTest");
+}
@@ -0,0 +1,112 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file elevationSimplifyTest.cpp
+ *
+ * @brief file contains the tests of the merging of elevation polynoms
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief returns a polynom
+ */
+elevationPolynom polynom(double s, double a, double b, double c = 0, double d = 0)
+{
+    elevationPolynom p;
+    p.s = s;
+    p.a = a;
+    p.b = b;
+    p.c = c;
+    p.d = d;
+    return p;
+}
+
+/**
+ * @brief returns the elevation of a road at s from its first elevation profile
+ */
+double elevationAt(const road &r, double s)
+{
+    const arenaVector<elevationPolynom> &polys = r.elevationProfiles.front().outputElevation;
+    int k = 0;
+    while (k + 1 < (int)polys.size() && polys[k + 1].s <= s)
+        k++;
+
+    double value, slope;
+    evaluateElevationPolynom(polys[k], s, value, slope);
+    return value;
+}
+
+/**
+ * @brief collinear polynoms are merged into one, polynoms which differ more than the tolerance are kept
+ *
+ */
+void testMerge()
+{
+    road r;
+    r.length = 30;
+    elevationProfile ep;
+    ep.outputElevation.push_back(polynom(0, 1, 0.1));
+    ep.outputElevation.push_back(polynom(10, 2, 0.1));
+    ep.outputElevation.push_back(polynom(20, 3, -0.1));
+    r.elevationProfiles.push_back(ep);
+
+    CHECK(simplifyElevationProfile(r, 1e-3) == 0);
+    const arenaVector<elevationPolynom> &res = r.elevationProfiles.front().outputElevation;
+    CHECK(res.size() == 2);
+    CHECK(res.size() == 2 && res[0].s == 0 && res[1].s == 20);
+    CHECK_NEAR(elevationAt(r, 15), 2.5, 1e-9);
+    CHECK_NEAR(elevationAt(r, 30), 2, 1e-9);
+}
+
+/**
+ * @brief zero length polynoms at the road start are removed and the following polynom is moved to s = 0
+ *
+ */
+void testStart()
+{
+    road r;
+    r.length = 20;
+    elevationProfile ep;
+    double s0 = 5.55112e-15;
+    ep.outputElevation.push_back(polynom(0, 1, 0));
+    ep.outputElevation.push_back(polynom(s0, 1, 0.1, 0.01, 0.001));
+    r.elevationProfiles.push_back(ep);
+
+    CHECK(simplifyElevationProfile(r, 1e-3) == 0);
+    const arenaVector<elevationPolynom> &res = r.elevationProfiles.front().outputElevation;
+    CHECK(res.size() == 1);
+    if (res.size() != 1)
+        return;
+
+    // the polynom is the same function of s as before
+    elevationPolynom p = polynom(s0, 1, 0.1, 0.01, 0.001);
+    CHECK(res[0].s == 0);
+    for (double s : {0.0, 1.0, 7.5, 20.0})
+    {
+        double v0, m0, v1, m1;
+        evaluateElevationPolynom(p, s, v0, m0);
+        evaluateElevationPolynom(res[0], s, v1, m1);
+        CHECK_NEAR(v1, v0, 1e-12);
+        CHECK_NEAR(m1, m0, 1e-12);
+    }
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testMerge();
+    testStart();
+
+    return testResult("elevationSimplifyTest");
+}
@@ -0,0 +1,330 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file elevationSolverTest.cpp
+ *
+ * @brief file contains the tests of the elevation propagation and the least squares elevation solver
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief adds a road with the given id which rises by the given height over its length
+ *
+ * @param data      roadNetwork data
+ * @param id        road id
+ * @param rise      relative elevation at the road end
+ */
+void addRisingRoad(roadNetwork &data, int id, double rise)
+{
+    road r;
+    r.id = id;
+    r.inputSegmentId = id;
+    r.length = 100;
+
+    elevationProfile start, end;
+    start.radius = 100;
+    end.radius = 100;
+    end.sOffset = r.length;
+    end.tOffset = rise;
+    r.elevationProfiles.push_back(start);
+    r.elevationProfiles.push_back(end);
+
+    data.roads.push_back(r);
+}
+
+/**
+ * @brief links the end of the road with index a to the start of the road with index b
+ *
+ * @param data      roadNetwork data
+ * @param a         index of the first road
+ * @param b         index of the second road
+ */
+void linkRoads(roadNetwork &data, int a, int b)
+{
+    data.roads[a].successor.id = data.roads[b].id;
+    data.roads[a].successor.contactPoint = startType;
+    data.roads[b].predecessor.id = data.roads[a].id;
+    data.roads[b].predecessor.contactPoint = endType;
+}
+
+/**
+ * @brief returns the sum of the squared height steps over all edges of the elevation graph
+ *
+ * @param data      roadNetwork data
+ * @return double   squared residual
+ */
+double elevationResidual(roadNetwork &data)
+{
+    elevationGraph &g = data.elevGraph;
+    double sum = 0;
+    for (int u = 0; u < (int)g.edges.size(); u++)
+    {
+        for (elevationEdge &e : g.edges[u])
+        {
+            if (e.to <= u)
+                continue;
+            double d = g.offset[u] + getNodeElevation(data, u, e.fromPos) - g.offset[e.to] - getNodeElevation(data, e.to, e.toPos);
+            sum += d * d;
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief propagates the offsets along the spanning tree and solves them by least squares afterwards
+ *
+ * @param data          roadNetwork data
+ * @param treeOffsets   offsets of the tree propagation
+ * @param treeResidual  squared residual of the tree propagation
+ * @return int          error code
+ */
+int solveElevation(roadNetwork &data, vector<double> &treeOffsets, double &treeResidual)
+{
+    if (buildElevationGraph(data, data.elevGraph))
+        return 1;
+
+    data.elevGraph.root = 0;
+    data.elevGraph.rootOffset = 5;
+
+    if (propagateElevation(data))
+        return 1;
+
+    treeOffsets = data.elevGraph.offset;
+    treeResidual = elevationResidual(data);
+
+    return solveElevationLeastSquares(data);
+}
+
+/**
+ * @brief three roads which rise by 1 m each are closed to a loop. The tree propagation puts the whole step of 3 m
+ *      at the last link, the least squares solution spreads it to 1 m at each link.
+ *
+ */
+void testLoop()
+{
+    roadNetwork data;
+    addRisingRoad(data, 1, 1);
+    addRisingRoad(data, 2, 1);
+    addRisingRoad(data, 3, 1);
+    linkRoads(data, 0, 1);
+    linkRoads(data, 1, 2);
+    linkRoads(data, 2, 0);
+
+    vector<double> treeOffsets;
+    double treeResidual = 0;
+    CHECK(solveElevation(data, treeOffsets, treeResidual) == 0);
+
+    CHECK_NEAR(treeResidual, 9, 1e-9);
+    CHECK_NEAR(elevationResidual(data), 3, 1e-9);
+
+    // the reference road keeps its offset, the other roads are moved
+    CHECK_NEAR(data.roads[0].elevationOffset, 5, 1e-12);
+    CHECK(fabs(data.roads[1].elevationOffset - treeOffsets[1]) > 0.1);
+    CHECK(fabs(data.roads[2].elevationOffset - treeOffsets[2]) > 0.1);
+
+    // every link has the same step, so the solution is symmetric
+    CHECK_NEAR(data.roads[1].elevationOffset - data.roads[0].elevationOffset, 0, 1e-9);
+    CHECK_NEAR(data.roads[2].elevationOffset - data.roads[1].elevationOffset, 0, 1e-9);
+}
+
+/**
+ * @brief without a loop the tree propagation is exact and the least squares solver must not change it
+ *
+ */
+void testChain()
+{
+    roadNetwork data;
+    addRisingRoad(data, 1, 1);
+    addRisingRoad(data, 2, -2);
+    addRisingRoad(data, 3, 0.5);
+    linkRoads(data, 0, 1);
+    linkRoads(data, 1, 2);
+
+    vector<double> treeOffsets;
+    double treeResidual = 0;
+    CHECK(solveElevation(data, treeOffsets, treeResidual) == 0);
+
+    CHECK_NEAR(treeResidual, 0, 1e-12);
+    CHECK_NEAR(elevationResidual(data), 0, 1e-12);
+    for (int k = 0; k < (int)data.roads.size(); k++)
+        CHECK_NEAR(data.roads[k].elevationOffset, treeOffsets[k], 1e-9);
+
+    CHECK_NEAR(data.roads[1].elevationOffset, 6, 1e-9);
+    CHECK_NEAR(data.roads[2].elevationOffset, 4, 1e-9);
+}
+
+/**
+ * @brief builds the elevation graph with the first road as reference and generates the polynoms of all roads
+ *
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int generateAll(roadNetwork &data)
+{
+    if (buildElevationGraph(data, data.elevGraph))
+        return 1;
+
+    data.elevGraph.root = 0;
+    data.elevGraph.rootOffset = 5;
+
+    if (propagateElevation(data))
+        return 1;
+    if (setting.leastSquaresElevation && solveElevationLeastSquares(data))
+        return 1;
+
+    for (road &r : data.roads)
+    {
+        if (generateRoadElevation(r))
+            return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief road 1 is followed by road 2 and road 3, road 3 ends in junction 100 where roads 4 and 5 start.
+ *      With loop = true road 5 is linked back to road 1.
+ *
+ * @param data      roadNetwork data
+ * @param loop      close the network to a loop
+ */
+void buildTree(roadNetwork &data, bool loop)
+{
+    addRisingRoad(data, 1, 1);
+    addRisingRoad(data, 2, -2);
+    addRisingRoad(data, 3, 0.5);
+    addRisingRoad(data, 4, 1.5);
+    addRisingRoad(data, 5, -1);
+    linkRoads(data, 0, 1);
+    linkRoads(data, 1, 2);
+
+    junction j;
+    j.id = 100;
+    data.junctions.push_back(j);
+
+    data.roads[2].successor.id = 100;
+    data.roads[2].successor.elementType = junctionType;
+    for (int k : {3, 4})
+    {
+        data.roads[k].predecessor.id = 100;
+        data.roads[k].predecessor.elementType = junctionType;
+    }
+
+    if (loop)
+        linkRoads(data, 4, 0);
+}
+
+/**
+ * @brief changes the end height of a road in the incremental network and in a copy which is generated again completely,
+ *      both have to be identical afterwards
+ *
+ * @param data      roadNetwork data after generateAll
+ * @param roadIndex index of the changed road
+ * @param rise      new relative elevation at the road end
+ * @param loop      the network was built with a loop
+ */
+void checkUpdate(roadNetwork &data, int roadIndex, double rise, bool loop)
+{
+    roadNetwork before = data;
+
+    arenaVector<elevationProfile> eps = data.roads[roadIndex].elevationProfiles;
+    eps.back().tOffset = rise;
+    CHECK(updateElevationProfile(data, data.roads[roadIndex].id, eps) == 0);
+
+    roadNetwork full;
+    buildTree(full, loop);
+    for (int k = 0; k < (int)full.roads.size(); k++)
+        full.roads[k].elevationProfiles.back().tOffset = data.roads[k].elevationProfiles.back().tOffset;
+    CHECK(generateAll(full) == 0);
+
+    for (int k = 0; k < (int)data.roads.size(); k++)
+    {
+        CHECK_NEAR(data.roads[k].elevationOffset, full.roads[k].elevationOffset, 1e-9);
+
+        const arenaVector<elevationPolynom> &polys = data.roads[k].elevationProfiles.front().outputElevation;
+        const arenaVector<elevationPolynom> &ref = full.roads[k].elevationProfiles.front().outputElevation;
+        CHECK(polys.size() == ref.size());
+        for (int n = 0; n < (int)polys.size() && n < (int)ref.size(); n++)
+        {
+            CHECK_NEAR(polys[n].s, ref[n].s, 1e-9);
+            CHECK_NEAR(polys[n].a, ref[n].a, 1e-9);
+            CHECK_NEAR(polys[n].b, ref[n].b, 1e-9);
+            CHECK_NEAR(polys[n].c, ref[n].c, 1e-9);
+            CHECK_NEAR(polys[n].d, ref[n].d, 1e-9);
+        }
+    }
+
+    // without the least squares solver only the road and its subtree are touched
+    if (setting.leastSquaresElevation)
+        return;
+
+    vector<int> subtree;
+    CHECK(propagateElevationFromNode(before, roadIndex, subtree) == 0);
+    for (int k = 0; k < (int)data.roads.size(); k++)
+    {
+        if (find(subtree.begin(), subtree.end(), k) != subtree.end())
+            continue;
+
+        const arenaVector<elevationPolynom> &polys = data.roads[k].elevationProfiles.front().outputElevation;
+        const arenaVector<elevationPolynom> &old = before.roads[k].elevationProfiles.front().outputElevation;
+        CHECK(data.roads[k].elevationOffset == before.roads[k].elevationOffset);
+        CHECK(polys.size() == old.size());
+        for (int n = 0; n < (int)polys.size() && n < (int)old.size(); n++)
+            CHECK(polys[n].s == old[n].s && polys[n].a == old[n].a && polys[n].b == old[n].b);
+    }
+}
+
+/**
+ * @brief the incremental update of single roads gives the same offsets and polynoms as a full recompute
+ *
+ */
+void testIncremental()
+{
+    roadNetwork data;
+    buildTree(data, false);
+    CHECK(generateAll(data) == 0);
+
+    // road 3 moves the junction and the roads 4 and 5, road 4 only moves itself
+    vector<int> subtree;
+    CHECK(propagateElevationFromNode(data, 2, subtree) == 0);
+    sort(subtree.begin(), subtree.end());
+    CHECK(subtree == vector<int>({2, 3, 4}));
+    subtree.clear();
+    CHECK(propagateElevationFromNode(data, 3, subtree) == 0);
+    CHECK(subtree == vector<int>({3}));
+
+    checkUpdate(data, 2, 3, false);
+    checkUpdate(data, 3, -0.5, false);
+    checkUpdate(data, 0, 2, false);
+
+    // the least squares offsets of a loop depend on every road
+    setting.leastSquaresElevation = true;
+    roadNetwork loop;
+    buildTree(loop, true);
+    CHECK(generateAll(loop) == 0);
+    checkUpdate(loop, 2, 3, true);
+    setting.leastSquaresElevation = false;
+
+    // unknown roads are rejected
+    CHECK(updateElevationProfile(data, 42, data.roads[0].elevationProfiles) == 1);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testLoop();
+    testChain();
+    testIncremental();
+
+    return testResult("elevationSolverTest");
+}
@@ -0,0 +1,140 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file idAllocatorTest.cpp
+ *
+ * @brief file contains the tests of the central id allocation, its overflow blocks and the remap table
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief blocks of 100 ids, negative ids are in negative blocks
+ *
+ */
+void testBlocks()
+{
+    CHECK(idAllocator::blockOf(0) == 0);
+    CHECK(idAllocator::blockOf(99) == 0);
+    CHECK(idAllocator::blockOf(100) == 1);
+    CHECK(idAllocator::blockOf(-1) == -1);
+    CHECK(idAllocator::blockOf(-100) == -1);
+    CHECK(idAllocator::blockOf(-101) == -2);
+
+    idAllocator ids;
+    CHECK(ids.reserve(1, 1));
+    CHECK(ids.reserve(1, 1));
+    CHECK(!ids.reserve(2, 1));
+}
+
+/**
+ * @brief legacy ids are kept if they are free and in a block of the segment, conflicts get overflow ids and remap entries
+ *
+ */
+void testLegacyAndOverflow()
+{
+    idAllocator ids;
+    ids.reserve(1, 1);
+    ids.reserve(2, 2);
+    ids.reserveBelow(10);
+
+    CHECK(ids.allocate(1, 101) == 101);
+    CHECK(ids.allocate(1, 102) == 102);
+    CHECK(ids.allocate(2, 201) == 201);
+    CHECK(ids.remap.empty());
+
+    // used id: the first id of the first overflow block
+    CHECK(ids.allocate(2, 101) == 1001);
+    CHECK(ids.remap.size() == 1);
+    CHECK(ids.remap[0].segment == 2 && ids.remap[0].legacyId == 101 && ids.remap[0].id == 1001 && !ids.remap[0].junction);
+
+    // free id in the block of another segment: the overflow block of the segment is continued
+    CHECK(ids.allocate(2, 150) == 1002);
+    CHECK(ids.remap.size() == 2 && ids.remap[1].legacyId == 150);
+
+    // another segment gets its own overflow block
+    CHECK(ids.allocate(1, 202) == 1101);
+    CHECK(ids.remap.size() == 3 && ids.remap[2].segment == 1);
+
+    // a full overflow block is continued in the next free block, its first id is skipped
+    for (int k = 1003; k <= 1099; k++)
+        CHECK(ids.allocate(2, 101) == k);
+    CHECK(ids.allocate(2, 101) == 1201);
+
+    // unique ids, all replaced ids are in the remap table
+    CHECK(ids.used.size() == 3 + ids.remap.size());
+    for (const idRemap &e : ids.remap)
+        CHECK(ids.used.count(e.id) && e.id >= 1000);
+}
+
+/**
+ * @brief without reserved blocks the overflow starts at block 0 and skips blocks and ids which are in use
+ *
+ */
+void testOverflowSkipsUsed()
+{
+    idAllocator ids;
+    CHECK(ids.allocate(0, 1) == 1);
+
+    // block 0 belongs to segment 0, block 1 is the overflow block of segment 1
+    CHECK(ids.allocate(1, 1) == 101);
+    CHECK(ids.allocate(1, 102) == 102);
+    CHECK(ids.allocate(1, 5) == 103);
+    CHECK(ids.remap.size() == 2);
+
+    // negative ids
+    CHECK(ids.allocate(7, -5) == -5);
+    CHECK(ids.owner[-1] == 7);
+    CHECK(ids.allocate(8, -50) == 201);
+}
+
+/**
+ * @brief a junction gets the first id of a whole block, the roads of the junction follow in the same block
+ *
+ */
+void testJunction()
+{
+    idAllocator ids;
+    ids.reserve(1, 2);
+    ids.reserve(2, 3);
+    ids.reserveBelow(10);
+
+    CHECK(ids.allocateJunction(1, 200) == 200);
+    CHECK(ids.allocate(1, 201) == 201);
+    CHECK(ids.remap.empty());
+
+    // block of another segment
+    int junc = ids.allocateJunction(1, 300);
+    CHECK(junc == 1000);
+    CHECK(ids.remap.size() == 1 && ids.remap[0].junction && ids.remap[0].legacyId == 300 && ids.remap[0].id == 1000);
+    CHECK(ids.owner[10] == 1);
+    CHECK(ids.allocate(1, junc + 1) == 1001);
+
+    // used junction id of the same segment
+    CHECK(ids.allocateJunction(1, 200) == 1100);
+    CHECK(ids.remap.size() == 2 && ids.remap[1].junction);
+
+    // the overflow ids of roads do not enter the junction blocks
+    CHECK(ids.allocate(2, 201) == 1201);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testBlocks();
+    testLegacyAndOverflow();
+    testOverflowSkipsUsed();
+    testJunction();
+
+    return testResult("idAllocatorTest");
+}
@@ -0,0 +1,106 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file internedStringTest.cpp
+ *
+ * @brief file contains the tests of the interned lane, roadmark and material strings
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+#include <thread>
+
+/**
+ * @brief equal strings share one table entry, independent of the type they were created from
+ *
+ */
+void testIdentity()
+{
+    internedString a = "broken";
+    internedString b = string("broken");
+    internedString c = b;
+
+    CHECK(a == b && b == c);
+    CHECK(a.c_str() == b.c_str());
+    CHECK(a == "broken" && a == string("broken"));
+    CHECK(a != "solid" && a != string("solid"));
+    CHECK(a != internedString("solid"));
+
+    internedString empty;
+    CHECK(empty == "" && empty.str().empty());
+    CHECK(empty == internedString(""));
+
+    // strings which are not known in advance are added once
+    internedString custom1 = string("myCustomType");
+    internedString custom2 = "myCustomType";
+    CHECK(custom1 == custom2 && custom1.c_str() == custom2.c_str());
+    CHECK(custom1.str() == "myCustomType");
+    CHECK(custom1 != empty);
+}
+
+/**
+ * @brief the defaults of the lane properties are interned names
+ *
+ */
+void testDefaults()
+{
+    lane l;
+    CHECK(l.type == "driving");
+    CHECK(l.rm.type == "solid" && l.rm.weight == "standard" && l.rm.color == "white");
+
+    l.rm.type = "broken";
+    lane copy = l;
+    CHECK(copy.rm.type == internedString("broken"));
+    CHECK(copy.type == l.type);
+}
+
+/**
+ * @brief known names are only looked up, so they can be interned from several threads
+ *
+ */
+void testThreads()
+{
+    const int nThreads = 4;
+    const int nNames = sizeof(openDriveNames) / sizeof(openDriveNames[0]);
+
+    vector<vector<const char *>> results(nThreads, vector<const char *>(nNames, (const char *)NULL));
+    vector<std::thread> threads;
+    for (int t = 0; t < nThreads; t++)
+    {
+        threads.push_back(std::thread([&results, t, nNames]() {
+            for (int repeat = 0; repeat < 1000; repeat++)
+            {
+                for (int k = 0; k < nNames; k++)
+                    results[t][k] = internedString(openDriveNames[k]).c_str();
+            }
+        }));
+    }
+    for (std::thread &t : threads)
+        t.join();
+
+    for (int k = 0; k < nNames; k++)
+    {
+        CHECK(results[0][k] == internedString(openDriveNames[k]).c_str());
+        for (int t = 1; t < nThreads; t++)
+            CHECK(results[t][k] == results[0][k]);
+    }
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testIdentity();
+    testDefaults();
+    testThreads();
+
+    return testResult("internedStringTest");
+}
@@ -0,0 +1,309 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file junctionCacheTest.cpp
+ *
+ * @brief file contains the round trip tests of the junction cache
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+#include <unistd.h>
+
+/**
+ * @brief four arms of a junction in the junction frame; each arm starts 10 m from the origin and points away from it
+ *
+ * @param firstId   id of the first arm, the other arms get the following ids
+ * @param arms      arms
+ */
+void buildArms(int firstId, vector<road> &arms)
+{
+    arms.clear();
+    for (int k = 0; k < 4; k++)
+    {
+        road r;
+        r.id = firstId + k;
+        r.length = 50;
+        r.predecessor.elementType = junctionType;
+
+        geometry g;
+        g.type = line;
+        g.s = 0;
+        g.hdg = k * M_PI / 2;
+        g.x = 10 * cos(g.hdg);
+        g.y = 10 * sin(g.hdg);
+        g.length = r.length;
+        r.geometries.push_back(g);
+
+        laneSection sec;
+        sec.id = 0;
+        for (int id = -2; id <= 2; id++)
+        {
+            lane l;
+            l.id = id;
+            l.w.a = (id == 0) ? 0 : 3.5;
+            l.rm.type = (id == 0) ? "solid" : "broken";
+            sec.lanes.push_back(l);
+        }
+        r.laneSections.push_back(sec);
+        arms.push_back(r);
+    }
+}
+
+/**
+ * @brief tasks for a straight, a right and a left turn from the first arm; lanes with positive id lead to the junction
+ *
+ * @param arms          arms
+ * @param firstId       id of the first connecting road
+ * @param tasks         tasks
+ */
+void buildTasks(const vector<road> &arms, int firstId, vector<connectionTask> &tasks)
+{
+    int from[3] = {1, 1, 2};
+    int to[3] = {2, 3, 1};
+    int fromLane[3] = {1, 2, 1};
+    int toLane[3] = {-1, -2, -1};
+
+    tasks.clear();
+    for (int k = 0; k < 3; k++)
+    {
+        connectionTask t;
+        t.from = &arms[from[k]];
+        t.to = &arms[to[k]];
+        t.fromId = fromLane[k];
+        t.toId = toLane[k];
+        t.laneMarkLeft = "none";
+        t.laneMarkRight = (k == 0) ? "solid" : "none";
+        t.id = firstId + k;
+        t.inputSegmentId = 1;
+        tasks.push_back(t);
+    }
+}
+
+/**
+ * @brief generates the connecting roads of the junction
+ *
+ * @param armId     id of the first arm
+ * @param juncId    junction id, the connecting roads get the following ids
+ * @param data      roadNetwork data with the connecting roads
+ * @param key       canonical key of the tasks
+ * @return int      error code
+ */
+int generate(int armId, int juncId, roadNetwork &data, string &key)
+{
+    vector<road> arms;
+    buildArms(armId, arms);
+
+    vector<connectionTask> tasks;
+    buildTasks(arms, juncId + 1, tasks);
+    key = junctionCacheKey(tasks);
+
+    junction junc;
+    junc.id = juncId;
+    int res = createRoadConnections(tasks, junc, data);
+    data.junctions.push_back(junc);
+    return res;
+}
+
+/**
+ * @brief compares two connecting roads and their connections; ids are expected to follow the junction ids
+ *
+ */
+void compareConnections(const roadNetwork &a, const roadNetwork &b)
+{
+    CHECK(a.roads.size() == b.roads.size() && a.junctions.size() == 1 && b.junctions.size() == 1);
+    if (a.roads.size() != b.roads.size() || a.junctions.size() != 1 || b.junctions.size() != 1)
+        return;
+
+    int dJunc = b.junctions[0].id - a.junctions[0].id;
+    int dArm = b.roads[0].predecessor.id - a.roads[0].predecessor.id;
+
+    for (int k = 0; k < (int)a.roads.size(); k++)
+    {
+        const road &ra = a.roads[k];
+        const road &rb = b.roads[k];
+
+        CHECK(rb.id == ra.id + dJunc && rb.junction == ra.junction + dJunc);
+        CHECK(rb.predecessor.id == ra.predecessor.id + dArm && rb.successor.id == ra.successor.id + dArm);
+        CHECK(rb.predecessor.contactPoint == ra.predecessor.contactPoint && rb.successor.contactPoint == ra.successor.contactPoint);
+        CHECK(rb.length == ra.length);
+
+        CHECK(rb.geometries.size() == ra.geometries.size());
+        for (int g = 0; g < (int)ra.geometries.size() && g < (int)rb.geometries.size(); g++)
+        {
+            geometry ga = ra.geometries[g];
+            geometry gb = rb.geometries[g];
+            CHECK(ga.type == gb.type && ga.s == gb.s && ga.x == gb.x && ga.y == gb.y && ga.hdg == gb.hdg && ga.length == gb.length);
+            CHECK(ga.c == gb.c && ga.c1 == gb.c1 && ga.c2 == gb.c2);
+        }
+
+        CHECK(rb.laneSections.size() == ra.laneSections.size());
+        for (int s = 0; s < (int)ra.laneSections.size() && s < (int)rb.laneSections.size(); s++)
+        {
+            const laneTable &la = ra.laneSections[s].lanes;
+            const laneTable &lb = rb.laneSections[s].lanes;
+            CHECK(la.size() == lb.size() && ra.laneSections[s].s == rb.laneSections[s].s);
+            for (int l = 0; l < la.size() && l < lb.size(); l++)
+            {
+                CHECK(la[l].id == lb[l].id && la[l].type == lb[l].type && la[l].preId == lb[l].preId && la[l].sucId == lb[l].sucId);
+                CHECK(la[l].w.a == lb[l].w.a && la[l].w.b == lb[l].w.b && la[l].w.c == lb[l].w.c && la[l].w.d == lb[l].w.d);
+                CHECK(la[l].rm.type == lb[l].rm.type && la[l].rm.color == lb[l].rm.color && la[l].m.surface == lb[l].m.surface);
+            }
+        }
+    }
+
+    const arenaVector<connection> &ca = a.junctions[0].connections;
+    const arenaVector<connection> &cb = b.junctions[0].connections;
+    CHECK(ca.size() == cb.size());
+    for (int k = 0; k < (int)ca.size() && k < (int)cb.size(); k++)
+    {
+        CHECK(cb[k].from == ca[k].from + dArm && cb[k].to == ca[k].to + dJunc);
+        CHECK(cb[k].fromLane == ca[k].fromLane && cb[k].toLane == ca[k].toLane && cb[k].contactPoint == ca[k].contactPoint);
+    }
+}
+
+/**
+ * @brief junctions which only differ in their ids share the key, the lane marks and the settings are part of the key
+ *
+ */
+void testKey()
+{
+    vector<road> arms1, arms2;
+    buildArms(1, arms1);
+    buildArms(11, arms2);
+
+    vector<connectionTask> tasks1, tasks2;
+    buildTasks(arms1, 101, tasks1);
+    buildTasks(arms2, 201, tasks2);
+    string key = junctionCacheKey(tasks1);
+    CHECK(junctionCacheKey(tasks2) == key);
+
+    tasks2[1].laneMarkRight = "solid";
+    CHECK(junctionCacheKey(tasks2) != key);
+
+    buildTasks(arms2, 201, tasks2);
+    arms2[3].laneSections[0].lanes[0].w.a += 0.5;
+    CHECK(junctionCacheKey(tasks2) != key);
+
+    double width = setting.width.standard;
+    setting.width.standard += 1;
+    CHECK(junctionCacheKey(tasks1) != key);
+    setting.width.standard = width;
+    CHECK(junctionCacheKey(tasks1) == key);
+}
+
+/**
+ * @brief the connecting roads of a cache hit equal the generated ones, from memory and from the cache directory
+ *
+ */
+void testRoundTrip()
+{
+    setting.junctionCache = true;
+    setting.junctionCacheDir = "";
+    junctionCache().clear();
+
+    string key1, key2, entry;
+    roadNetwork generated;
+    CHECK(generate(1, 100, generated, key1) == 0);
+    CHECK(generated.roads.size() == 3 && !generated.roads[0].geometries.empty());
+    CHECK(junctionCache().find(key1, entry));
+
+    // hit in memory
+    roadNetwork cached;
+    CHECK(generate(11, 200, cached, key2) == 0);
+    CHECK(key1 == key2);
+    compareConnections(generated, cached);
+
+    // hit from the cache directory of another process
+    char dir[] = "/tmp/junctionCacheTestXXXXXX";
+    CHECK(mkdtemp(dir) != NULL);
+    setting.junctionCacheDir = dir;
+    junctionCache().clear();
+
+    roadNetwork stored;
+    CHECK(generate(21, 300, stored, key2) == 0);
+    compareConnections(generated, stored);
+
+    char hash[17];
+    snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)fnvHash(key1));
+    string file = string(dir) + "/" + hash + ".jcache";
+    CHECK(ifstream(file).good());
+
+    junctionCache().clear();
+    roadNetwork loaded;
+    CHECK(junctionCache().find(key1, entry));
+    CHECK(generate(31, 400, loaded, key2) == 0);
+    compareConnections(generated, loaded);
+
+    // a truncated file is a miss, the roads are generated again
+    junctionCache().clear();
+    {
+        ifstream in(file, ios::binary);
+        string bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+        ofstream out(file, ios::binary | ios::trunc);
+        out.write(bytes.data(), bytes.size() / 2);
+    }
+    CHECK(!junctionCache().find(key1, entry));
+
+    roadNetwork regenerated;
+    CHECK(generate(41, 500, regenerated, key2) == 0);
+    compareConnections(generated, regenerated);
+
+    remove(file.c_str());
+    rmdir(dir);
+    setting.junctionCacheDir = "";
+    setting.junctionCache = false;
+    junctionCache().clear();
+}
+
+/**
+ * @brief a cache entry which does not fit the tasks is a miss and leaves the tasks empty
+ *
+ */
+void testInvalidEntry()
+{
+    setting.junctionCache = true;
+    junctionCache().clear();
+
+    vector<road> arms;
+    buildArms(1, arms);
+    vector<connectionTask> tasks;
+    buildTasks(arms, 101, tasks);
+    string key = junctionCacheKey(tasks);
+
+    junctionCache().store(key, "invalid");
+    junction junc;
+    junc.id = 100;
+    CHECK(!loadCachedConnections(key, tasks, junc));
+    for (const connectionTask &t : tasks)
+        CHECK(t.r.geometries.empty() && t.r.laneSections.empty() && t.connections.empty());
+
+    // failed roads are not stored
+    tasks[0].error = 1;
+    junctionCache().clear();
+    storeCachedConnections(key, tasks);
+    string entry;
+    CHECK(!junctionCache().find(key, entry));
+
+    setting.junctionCache = false;
+    junctionCache().clear();
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testKey();
+    testRoundTrip();
+    testInvalidEntry();
+
+    return testResult("junctionCacheTest");
+}
@@ -0,0 +1,210 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file junctionCheckTest.cpp
+ *
+ * @brief file contains the tests of the junction checker on generated and on broken junctions
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief generates the road network of an input file of the test directory
+ *
+ * @param name      name of the input file
+ * @param data      roadNetwork data
+ * @return int      error code
+ */
+int generate(const string &name, roadNetwork &data)
+{
+    string file = string(PROJ_DIR) + "/test/" + name;
+
+    xmlTree inputxml;
+    if (validateInput(&file[0], inputxml))
+        return 1;
+    if (buildSegments(inputxml.getRootElement(), data))
+        return 1;
+    if (linkSegments(inputxml.getRootElement(), data))
+        return 1;
+    if (generateElevationProfiles(inputxml.getRootElement(), data))
+        return 1;
+    if (closeRoadNetwork(inputxml.getRootElement(), data))
+        return 1;
+    return 0;
+}
+
+/**
+ * @brief returns the index of a road in data.roads or -1
+ */
+int findRoad(const roadNetwork &data, int id)
+{
+    for (int k = 0; k < (int)data.roads.size(); k++)
+    {
+        if (data.roads[k].id == id)
+            return k;
+    }
+    return -1;
+}
+
+/**
+ * @brief replaces the geometries of a road by one line
+ *
+ * @param r         road
+ * @param x1        x component of start point
+ * @param y1        y component of start point
+ * @param x2        x component of end point
+ * @param y2        y component of end point
+ */
+void setLine(road &r, double x1, double y1, double x2, double y2)
+{
+    r.geometries.clear();
+    addLine(r.geometries, x1, y1, atan2(y2 - y1, x2 - x1), x2, y2, 0);
+    r.length = r.geometries.back().length;
+}
+
+/**
+ * @brief segments which touch at a common point don't intersect, crossings at a point of a line are found once
+ *
+ */
+void testSegments()
+{
+    // proper crossing
+    CHECK(segmentsIntersect(0, 0, 2, 2, 0, 2, 2, 0, false, false));
+    CHECK(!segmentsIntersect(0, 0, 1, 1, 2, 0, 3, -1, false, false));
+
+    // common start point of two lines
+    CHECK(!segmentsIntersect(0, 0, 1, 0, 0, 0, 1, 1, true, true));
+
+    // consecutive segments of a common reference line
+    CHECK(!segmentsIntersect(0, 0, 1, 0.1, 1, 0.1, 2, 0, false, false));
+    CHECK(!segmentsIntersect(1, 0.1, 2, 0, 0, 0, 1, 0.1, false, false));
+
+    // a crossing at a point of the first line is found with the segment which starts there
+    CHECK(!segmentsIntersect(0, 0, 1, 0, 1, -1, 1, 1, false, false));
+    CHECK(segmentsIntersect(1, 0, 2, 0, 1, -1, 1, 1, false, false));
+}
+
+/**
+ * @brief the generated X and T junctions have no violations, although connecting roads share start points and reference lines
+ *
+ */
+void testValidJunctions()
+{
+    const char *files[2] = {"4a_fixed.xml", "junction_ma.xml"};
+    int arms[2] = {4, 3};
+
+    for (int k = 0; k < 2; k++)
+    {
+        roadNetwork data;
+        CHECK(generate(files[k], data) == 0);
+
+        junctionReport report;
+        CHECK(checkJunctions(data, report) == 0);
+        CHECK(report.violations == 0);
+        CHECK(report.junctions.size() == 1);
+        if (report.junctions.size() == 1)
+        {
+            CHECK(report.junctions[0].arms == arms[k]);
+            CHECK(report.junctions[0].connectingRoads > 0);
+        }
+    }
+}
+
+/**
+ * @brief connecting roads with the same arms whose reference lines cross are reported
+ *
+ */
+void testLaneCrossing()
+{
+    roadNetwork data;
+    CHECK(generate("4a_fixed.xml", data) == 0);
+
+    // two connecting roads between the same arms
+    int a = -1, b = -1;
+    for (const connection &ck : data.junctions[0].connections)
+    {
+        for (const connection &cl : data.junctions[0].connections)
+        {
+            int k = findRoad(data, ck.to);
+            int l = findRoad(data, cl.to);
+            if (a != -1 || k == -1 || l == -1 || k == l)
+                continue;
+            if (data.roads[k].predecessor.id == data.roads[l].predecessor.id && data.roads[k].successor.id == data.roads[l].successor.id)
+            {
+                a = k;
+                b = l;
+            }
+        }
+    }
+    CHECK(a != -1 && b != -1);
+    if (a == -1 || b == -1)
+        return;
+
+    // the second road runs from the left of the start to the right of the end of the first one
+    junctionCheckLine line;
+    tessellateRoad(data.roads[a], 0.5, 0, line);
+    double x1 = line.x.front(), y1 = line.y.front();
+    double x2 = line.x.back(), y2 = line.y.back();
+    double phi = atan2(y2 - y1, x2 - x1);
+    setLine(data.roads[a], x1, y1, x2, y2);
+    setLine(data.roads[b], x1 - 2 * sin(phi), y1 + 2 * cos(phi), x2 + 2 * sin(phi), y2 - 2 * cos(phi));
+
+    junctionReport report;
+    CHECK(checkJunctions(data, report) == 1);
+    CHECK(report.violations > 0);
+    CHECK(report.junctions.size() == 1 && report.junctions[0].laneCrossings > 0);
+}
+
+/**
+ * @brief an arm which is turned onto its neighbour overlaps it
+ *
+ */
+void testArmOverlap()
+{
+    roadNetwork data;
+    CHECK(generate("4a_fixed.xml", data) == 0);
+    CHECK(data.junctions.size() == 1 && !data.junctions[0].connections.empty());
+    if (data.junctions.empty() || data.junctions[0].connections.empty())
+        return;
+
+    // the arms of the first connecting road
+    int c = findRoad(data, data.junctions[0].connections[0].to);
+    CHECK(c != -1);
+    if (c == -1)
+        return;
+    int from = findRoad(data, data.roads[c].predecessor.id);
+    int to = findRoad(data, data.roads[c].successor.id);
+    CHECK(from != -1 && to != -1 && from != to);
+    if (from == -1 || to == -1 || from == to)
+        return;
+
+    // the second arm starts at the first one and leaves with a small angle
+    geometry g = data.roads[from].geometries.front();
+    double length = data.roads[to].length;
+    setLine(data.roads[to], g.x, g.y, g.x + length * cos(g.hdg + 0.3), g.y + length * sin(g.hdg + 0.3));
+
+    junctionReport report;
+    CHECK(checkJunctions(data, report) == 1);
+    CHECK(report.junctions.size() == 1 && report.junctions[0].armOverlaps > 0);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testSegments();
+    testValidJunctions();
+    testLaneCrossing();
+    testArmOverlap();
+
+    return testResult("junctionCheckTest");
+}
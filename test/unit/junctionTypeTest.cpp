@@ -0,0 +1,85 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file junctionTypeTest.cpp
+ *
+ * @brief file contains the tests of the junction type parser of the n-arm junction
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief parses a junction type and returns the input roads as string of 'M' and 'A', "error" if the type is invalid
+ *
+ * @param type      junction type
+ * @return string   input roads
+ */
+string roads(const string &type)
+{
+    vector<bool> mainRoads;
+    if (parseJunctionType(type, mainRoads))
+        return "error";
+
+    string res;
+    for (bool m : mainRoads)
+        res += m ? 'M' : 'A';
+    return res;
+}
+
+/**
+ * @brief all types of the input scheme are expanded to one entry per input road
+ *
+ */
+void testValidTypes()
+{
+    CHECK(roads("MA") == "MA");
+    CHECK(roads("3A") == "AAA");
+    CHECK(roads("2M") == "MM");
+    CHECK(roads("M2A") == "MAA");
+    CHECK(roads("4A") == "AAAA");
+    CHECK(roads("5A") == "AAAAA");
+    CHECK(roads("M3A") == "MAAA");
+    CHECK(roads("AMA") == "AMA");
+    CHECK(roads("1M1A") == "MA");
+    CHECK(roads("12A") == string(12, 'A'));
+}
+
+/**
+ * @brief empty types, unknown characters, zero counts and trailing counts are rejected
+ *
+ */
+void testInvalidTypes()
+{
+    CHECK(roads("") == "error");
+    CHECK(roads("X") == "error");
+    CHECK(roads("ma") == "error");
+    CHECK(roads("M A") == "error");
+    CHECK(roads("M0A") == "error");
+    CHECK(roads("0M") == "error");
+    CHECK(roads("M2") == "error");
+    CHECK(roads("3") == "error");
+
+    // the result of a previous call is not kept
+    vector<bool> mainRoads(3, true);
+    CHECK(parseJunctionType("A", mainRoads) == 0);
+    CHECK(mainRoads.size() == 1 && !mainRoads[0]);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testValidTypes();
+    testInvalidTypes();
+
+    return testResult("junctionTypeTest");
+}
@@ -0,0 +1,184 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file laneBorderTest.cpp
+ *
+ * @brief file contains the tests of the tabulated lane borders of a lane section
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief tOffset of the outer border of a lane, summed lane by lane like before the borders were tabulated
+ *
+ * @param sec       lane section
+ * @param id        lane id
+ * @param s         s position
+ * @return double   tOffset
+ */
+double referenceTOffset(const laneSection &sec, int id, double s)
+{
+    double tOffset = 0;
+    int cur = 0;
+    int search = sgn(id) + id;
+    lane missing;
+
+    while (cur != search)
+    {
+        const lane *l = sec.lanes.get(cur);
+        if (l == NULL)
+            l = &missing;
+        s += l->w.s;
+        tOffset += sgn(id) * laneWidth(*l, s);
+        cur += sgn(id);
+    }
+    return tOffset;
+}
+
+/**
+ * @brief fills a lane section with random lanes, some ids are left out
+ *
+ * @param sec       lane section
+ * @param rng       random generator
+ */
+void randomLanes(laneSection &sec, mt19937 &rng)
+{
+    uniform_real_distribution<double> coefficient(-0.1, 0.1);
+    uniform_real_distribution<double> width(2.5, 4);
+
+    sec.lanes.clear();
+    for (int id = -5; id <= 5; id++)
+    {
+        if (rng() % 5 == 0)
+            continue;
+
+        lane l;
+        l.id = id;
+        l.w.s = (rng() % 2) ? 0 : width(rng);
+        l.w.a = (id == 0) ? 0 : width(rng);
+        l.w.b = coefficient(rng);
+        l.w.c = coefficient(rng) * 0.01;
+        l.w.d = coefficient(rng) * 0.001;
+        sec.lanes.push_back(l);
+    }
+}
+
+/**
+ * @brief compares the tabulated borders with the lane by lane sum for all lanes
+ *
+ * @param sec       lane section
+ */
+void compareBorders(const laneSection &sec)
+{
+    for (int id = -7; id <= 7; id++)
+    {
+        for (double s = 0; s <= 50; s += 12.5)
+            CHECK_NEAR(findTOffset(sec, id, s), referenceTOffset(sec, id, s), 1e-9);
+    }
+}
+
+/**
+ * @brief tabulated borders match the sum of the lane widths, also for missing lanes and shifted width polynoms
+ *
+ */
+void testBorders()
+{
+    mt19937 rng(7);
+    for (int run = 0; run < 200; run++)
+    {
+        laneSection sec;
+        randomLanes(sec, rng);
+        compareBorders(sec);
+    }
+
+    // missing lanes, also the center lane, have the default width
+    laneSection empty;
+    CHECK_NEAR(findTOffset(empty, 0, 10), 0, 1e-12);
+    CHECK_NEAR(findTOffset(empty, 2, 0), 3 * setting.width.standard, 1e-12);
+    CHECK_NEAR(findTOffset(empty, -1, 0), -2 * setting.width.standard, 1e-12);
+}
+
+/**
+ * @brief every non const access to the lanes invalidates the table
+ *
+ */
+void testInvalidation()
+{
+    mt19937 rng(11);
+    laneSection sec;
+    randomLanes(sec, rng);
+    compareBorders(sec);
+
+    sec.lanes[0].w.a += 1;
+    compareBorders(sec);
+
+    lane *l = sec.lanes.get(sec.lanes.maxId());
+    l->w.b += 0.05;
+    compareBorders(sec);
+
+    for (lane &cur : sec.lanes)
+        cur.w.s += 1;
+    compareBorders(sec);
+
+    shiftLanes(sec, sec.lanes.minId(), 1);
+    compareBorders(sec);
+
+    lane added;
+    added.id = sec.lanes.maxId() + 1;
+    added.w.a = 5;
+    sec.lanes.push_back(added);
+    compareBorders(sec);
+
+    sec.lanes.erase(sec.lanes.begin());
+    compareBorders(sec);
+
+    sec.lanes.flipIds();
+    compareBorders(sec);
+}
+
+/**
+ * @brief laneBorders adds the lane offset to the inner and outer border
+ *
+ */
+void testLaneOffset()
+{
+    laneSection sec;
+    for (int id = -2; id <= 2; id++)
+    {
+        lane l;
+        l.id = id;
+        l.w.a = (id == 0) ? 0 : 3;
+        sec.lanes.push_back(l);
+    }
+    sec.o.a = 1;
+    sec.o.b = 0.1;
+
+    double inner = 0, outer = 0;
+    laneBorders(sec, -2, 10, inner, outer);
+    CHECK_NEAR(inner, 2 - 3, 1e-12);
+    CHECK_NEAR(outer, 2 - 6, 1e-12);
+
+    laneBorders(sec, 1, 0, inner, outer);
+    CHECK_NEAR(inner, 1, 1e-12);
+    CHECK_NEAR(outer, 4, 1e-12);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testBorders();
+    testInvalidation();
+    testLaneOffset();
+
+    return testResult("laneBorderTest");
+}
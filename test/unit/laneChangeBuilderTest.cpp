@@ -0,0 +1,156 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file laneChangeBuilderTest.cpp
+ *
+ * @brief file contains the tests of the lane change builder
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief returns a road with one lane section and two lanes on each side
+ */
+road straightRoad()
+{
+    road r;
+    r.length = 500;
+
+    laneSection sec;
+    sec.id = 0;
+    sec.s = 0;
+    for (int id = -2; id <= 2; id++)
+    {
+        lane l;
+        l.id = id;
+        l.preId = id;
+        l.sucId = id;
+        l.w.a = (id == 0) ? 0 : 3.5;
+        sec.lanes.push_back(l);
+    }
+    r.laneSections.push_back(sec);
+    return r;
+}
+
+/**
+ * @brief checks that the lane sections are sorted by s and numbered consecutively
+ */
+void checkSections(const road &r)
+{
+    for (int k = 0; k < (int)r.laneSections.size(); k++)
+    {
+        CHECK(r.laneSections[k].id == r.laneSections[0].id + k);
+        if (k > 0)
+            CHECK(r.laneSections[k].s > r.laneSections[k - 1].s);
+    }
+}
+
+/**
+ * @brief returns true if a lane of the section is a roadwork
+ */
+bool hasRoadWork(const laneSection &sec)
+{
+    for (const lane &l : sec.lanes)
+        if (l.type == "roadWorks")
+            return true;
+    return false;
+}
+
+/**
+ * @brief changes which are added out of order are applied in increasing s order
+ *
+ */
+void testOrder()
+{
+    road r = straightRoad();
+
+    object work;
+    work.s = 200;
+    work.len = 50;
+
+    laneChangeBuilder changes;
+    changes.addLaneDrop(-2, 300, 30);
+    changes.addRoadWork(work, 1);
+    changes.addLaneWidening(2, 100, 25, true);
+    CHECK(changes.build(r) == 0);
+    CHECK(changes.empty());
+
+    const arenaVector<laneSection> &secs = r.laneSections;
+    CHECK(secs.size() == 7);
+    if (secs.size() != 7)
+        return;
+    checkSections(r);
+
+    double s[] = {0, 100, 125, 200, 250, 300, 330};
+    for (int k = 0; k < 7; k++)
+        CHECK_NEAR(secs[k].s, s[k], 1e-9);
+
+    // the widening adds a lane which the drop removes again
+    CHECK(secs[0].lanes.size() == 5);
+    CHECK(secs[2].lanes.size() == 6);
+    CHECK(secs[6].lanes.size() == 5);
+
+    CHECK(!hasRoadWork(secs[2]));
+    CHECK(hasRoadWork(secs[3]));
+    CHECK(!hasRoadWork(secs[4]));
+}
+
+/**
+ * @brief a change which starts before the previous one has ended is rejected
+ *
+ */
+void testOverlap()
+{
+    road r = straightRoad();
+
+    laneChangeBuilder changes;
+    changes.addLaneWidening(1, 100, 50, false);
+    changes.addLaneDrop(-1, 120, 30);
+    CHECK(changes.build(r) == 1);
+}
+
+/**
+ * @brief widenings at the junction are put in front of the road and move the other lane sections by their length
+ *
+ */
+void testJunctionWidening()
+{
+    road r = straightRoad();
+
+    laneChangeBuilder changes;
+    changes.addLaneWidening(2, 100, 25, true);
+    changes.addJunctionWidening(20, 10, 1, true, false);
+    changes.addJunctionWidening(30, 15, -1, true, false);
+    CHECK(changes.build(r) == 0);
+
+    const arenaVector<laneSection> &secs = r.laneSections;
+    CHECK(secs.size() == 7);
+    if (secs.size() != 7)
+        return;
+    checkSections(r);
+
+    // the second junction widening is in front of the first one
+    double s[] = {0, 30, 45, 65, 75, 175, 200};
+    for (int k = 0; k < 7; k++)
+        CHECK_NEAR(secs[k].s, s[k], 1e-9);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testOrder();
+    testOverlap();
+    testJunctionWidening();
+
+    return testResult("laneChangeBuilderTest");
+}
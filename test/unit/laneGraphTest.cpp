@@ -0,0 +1,227 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file laneGraphTest.cpp
+ *
+ * @brief file contains the tests of the lane graph and its binary file layout
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief adds a lane section with the lanes minId to maxId and the given roadmark type of all lanes
+ *
+ * @param r         road
+ * @param s         start of the lane section
+ * @param minId     min lane id
+ * @param maxId     max lane id
+ * @param rmType    roadmark type
+ */
+void addSection(road &r, double s, int minId, int maxId, const char *rmType)
+{
+    laneSection sec;
+    sec.id = r.laneSections.size();
+    sec.s = s;
+    for (int id = minId; id <= maxId; id++)
+    {
+        lane l;
+        l.id = id;
+        l.type = (id == 0) ? "none" : "driving";
+        l.rm.type = rmType;
+        l.preId = id;
+        l.sucId = id;
+        sec.lanes.push_back(l);
+    }
+    r.laneSections.push_back(sec);
+}
+
+/**
+ * @brief road 1 has two lane sections and is followed by road 2, which ends in junction 100 with the connecting road 101.
+ *      In the first section of road 1 lane changes are forbidden by solid roadmarks.
+ *
+ * @param data      roadNetwork data
+ */
+void buildNetwork(roadNetwork &data)
+{
+    road r1;
+    r1.id = 1;
+    r1.length = 100;
+    addSection(r1, 0, -2, 1, "solid");
+    addSection(r1, 40, -2, 1, "broken");
+    r1.successor.id = 2;
+    r1.successor.contactPoint = startType;
+
+    road r2;
+    r2.id = 2;
+    r2.length = 50;
+    addSection(r2, 0, -1, 1, "broken");
+    r2.predecessor.id = 1;
+    r2.predecessor.contactPoint = endType;
+    r2.successor.id = 100;
+    r2.successor.elementType = junctionType;
+
+    road c;
+    c.id = 101;
+    c.length = 20;
+    c.junction = 100;
+    c.isConnectingRoad = true;
+    addSection(c, 0, -1, 0, "none");
+
+    data.roads.push_back(r1);
+    data.roads.push_back(r2);
+    data.roads.push_back(c);
+
+    junction j;
+    j.id = 100;
+    connection con;
+    con.id = 0;
+    con.from = 2;
+    con.to = 101;
+    con.contactPoint = startType;
+    con.fromLane = -1;
+    con.toLane = -1;
+    j.connections.push_back(con);
+    data.junctions.push_back(j);
+}
+
+/**
+ * @brief returns the index of the node of a lane or -1
+ */
+int findNode(const laneGraph &g, int road, int laneSection, int lane)
+{
+    for (int k = 0; k < (int)g.nodes.size(); k++)
+    {
+        if (g.nodes[k].road == road && g.nodes[k].laneSection == laneSection && g.nodes[k].lane == lane)
+            return k;
+    }
+    return -1;
+}
+
+/**
+ * @brief returns true if the graph contains the given edge
+ */
+bool hasEdge(const laneGraph &g, int from, int to, laneGraphEdgeType type)
+{
+    if (from < 0 || to < 0)
+        return false;
+    for (uint32_t e = g.edgeIndex[from]; e < g.edgeIndex[from + 1]; e++)
+    {
+        if ((int)g.edges[e].to == to && g.edges[e].type == (uint32_t)type)
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief nodes are sorted by road, lane section and lane id without center lanes, the edges follow the driving direction
+ *
+ */
+void testGraph()
+{
+    roadNetwork data;
+    buildNetwork(data);
+
+    laneGraph g;
+    CHECK(buildLaneGraph(data, g) == 0);
+
+    // 3 + 3 lanes of road 1, 2 of road 2, 1 of the connecting road
+    CHECK(g.nodes.size() == 9);
+    CHECK(g.edgeIndex.size() == g.nodes.size() + 1);
+    CHECK(g.edgeIndex.back() == g.edges.size());
+    for (int k = 1; k < (int)g.nodes.size(); k++)
+    {
+        const laneGraphNode &a = g.nodes[k - 1];
+        const laneGraphNode &b = g.nodes[k];
+        CHECK(a.lane != 0 && b.lane != 0);
+        CHECK(g.edgeIndex[k - 1] <= g.edgeIndex[k]);
+        CHECK(make_pair(a.laneSection, a.lane) < make_pair(b.laneSection, b.lane) || a.road != b.road);
+    }
+
+    int r1s0m1 = findNode(g, 1, 0, -1);
+    int r1s0m2 = findNode(g, 1, 0, -2);
+    int r1s1m1 = findNode(g, 1, 1, -1);
+    int r1s1m2 = findNode(g, 1, 1, -2);
+    int r1s1p1 = findNode(g, 1, 1, 1);
+    int r2m1 = findNode(g, 2, 0, -1);
+    int r2p1 = findNode(g, 2, 0, 1);
+    int c = findNode(g, 101, 0, -1);
+
+    CHECK(g.nodes[r1s0m1].s == 0 && g.nodes[r1s0m1].length == 40);
+    CHECK(g.nodes[r1s1m1].s == 40 && g.nodes[r1s1m1].length == 60);
+    CHECK(g.nodes[c].flags == (drivingLaneFlag | connectingRoadFlag));
+    CHECK(g.nodes[r2m1].flags == drivingLaneFlag);
+
+    // lanes with negative id are driven in s direction, positive ones against it
+    CHECK(hasEdge(g, r1s0m1, r1s1m1, longitudinalEdge));
+    CHECK(hasEdge(g, r1s1m1, r2m1, longitudinalEdge));
+    CHECK(hasEdge(g, r2p1, r1s1p1, longitudinalEdge));
+    CHECK(!hasEdge(g, r2m1, r1s1m1, longitudinalEdge));
+
+    CHECK(hasEdge(g, r2m1, c, junctionEdge));
+    CHECK(g.edgeIndex[c] == g.edgeIndex[c + 1]);
+
+    // solid roadmarks forbid lane changes
+    CHECK(!hasEdge(g, r1s0m1, r1s0m2, laneChangeRightEdge));
+    CHECK(!hasEdge(g, r1s0m2, r1s0m1, laneChangeLeftEdge));
+    CHECK(hasEdge(g, r1s1m1, r1s1m2, laneChangeRightEdge));
+    CHECK(hasEdge(g, r1s1m2, r1s1m1, laneChangeLeftEdge));
+}
+
+/**
+ * @brief the binary file holds the header, the nodes, the padded edge index and the edges at 8 byte aligned offsets
+ *
+ */
+void testFile()
+{
+    roadNetwork data;
+    buildNetwork(data);
+
+    laneGraph g;
+    CHECK(buildLaneGraph(data, g) == 0);
+
+    string file = "laneGraphTest.lanegraph";
+    CHECK(writeLaneGraph(g, file) == 0);
+
+    ifstream in(file, ios::binary);
+    vector<char> bytes((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    in.close();
+    remove(file.c_str());
+
+    CHECK(bytes.size() >= sizeof(laneGraphHeader));
+    if (bytes.size() < sizeof(laneGraphHeader))
+        return;
+
+    laneGraphHeader h;
+    memcpy(&h, bytes.data(), sizeof(h));
+    CHECK(memcmp(h.magic, "LANEGRPH", 8) == 0);
+    CHECK(h.version == LANE_GRAPH_VERSION);
+    CHECK(h.nNodes == g.nodes.size() && h.nEdges == g.edges.size());
+    CHECK(h.nodeOffset % 8 == 0 && h.indexOffset % 8 == 0 && h.edgeOffset % 8 == 0);
+    CHECK(h.edgeOffset >= h.indexOffset + (h.nNodes + 1) * sizeof(uint32_t));
+    CHECK(bytes.size() == h.edgeOffset + h.nEdges * sizeof(laneGraphEdge));
+    if (bytes.size() != h.edgeOffset + h.nEdges * sizeof(laneGraphEdge))
+        return;
+
+    CHECK(memcmp(bytes.data() + h.nodeOffset, g.nodes.data(), h.nNodes * sizeof(laneGraphNode)) == 0);
+    CHECK(memcmp(bytes.data() + h.indexOffset, g.edgeIndex.data(), (h.nNodes + 1) * sizeof(uint32_t)) == 0);
+    CHECK(memcmp(bytes.data() + h.edgeOffset, g.edges.data(), h.nEdges * sizeof(laneGraphEdge)) == 0);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testGraph();
+    testFile();
+
+    return testResult("laneGraphTest");
+}
@@ -0,0 +1,182 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file laneTableTest.cpp
+ *
+ * @brief file contains the tests of the lane order and the lane lookup of the laneTable
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#include "unitTest.h"
+
+/**
+ * @brief returns true if the lanes are sorted by ascending id
+ *
+ * @param lanes     lane table
+ * @return bool     true if sorted
+ */
+bool isSorted(const laneTable &lanes)
+{
+    for (int k = 1; k < lanes.size(); k++)
+    {
+        if (lanes[k - 1].id > lanes[k].id)
+            return false;
+    }
+    return true;
+}
+
+/**
+ * @brief lanes inserted in any order are sorted and found by their id, also with gaps in the ids
+ *
+ */
+void testInsertAndFind()
+{
+    mt19937 rng(1);
+    for (int run = 0; run < 100; run++)
+    {
+        vector<int> ids;
+        for (int id = -6; id <= 6; id++)
+        {
+            if (rng() % 4 != 0)
+                ids.push_back(id);
+        }
+        shuffle(ids.begin(), ids.end(), rng);
+
+        laneTable lanes;
+        for (int id : ids)
+        {
+            lane l;
+            l.id = id;
+            l.preId = 10 * id;
+            lanes.push_back(l);
+        }
+
+        CHECK(lanes.size() == (int)ids.size());
+        CHECK(isSorted(lanes));
+
+        for (int id = -8; id <= 8; id++)
+        {
+            bool exists = std::find(ids.begin(), ids.end(), id) != ids.end();
+            int pos = lanes.find(id);
+            CHECK((pos != -1) == exists);
+            if (pos != -1)
+                CHECK(lanes[pos].id == id && lanes[pos].preId == 10 * id);
+            CHECK((lanes.get(id) != NULL) == exists);
+        }
+
+        if (ids.empty())
+            continue;
+        CHECK(lanes.minId() == *std::min_element(ids.begin(), ids.end()));
+        CHECK(lanes.maxId() == *std::max_element(ids.begin(), ids.end()));
+    }
+
+    laneTable empty;
+    CHECK(empty.find(0) == -1);
+    CHECK(empty.minId() == 100);
+    CHECK(empty.maxId() == -100);
+}
+
+/**
+ * @brief lanes with the same id keep their insertion order
+ *
+ */
+void testDuplicateIds()
+{
+    laneTable lanes;
+    for (int k = 0; k < 3; k++)
+    {
+        lane l;
+        l.id = 1;
+        l.preId = k;
+        lanes.push_back(l);
+    }
+    lane l;
+    l.id = 0;
+    lanes.push_back(l);
+
+    CHECK(lanes[0].id == 0);
+    for (int k = 0; k < 3; k++)
+        CHECK(lanes[k + 1].preId == k);
+}
+
+/**
+ * @brief flipping the ids reverses the order, sortById restores it after direct changes
+ *
+ */
+void testFlipAndSort()
+{
+    laneTable lanes;
+    for (int id = -2; id <= 3; id++)
+    {
+        lane l;
+        l.id = id;
+        l.sucId = id;
+        lanes.push_back(l);
+    }
+
+    lanes.flipIds();
+    CHECK(isSorted(lanes));
+    CHECK(lanes.minId() == -3 && lanes.maxId() == 2);
+    CHECK(lanes.get(-3) != NULL && lanes.get(-3)->sucId == 3);
+
+    lanes[0].id = 5;
+    lanes.sortById();
+    CHECK(isSorted(lanes));
+    CHECK(lanes.maxId() == 5 && lanes.get(5)->sucId == 3);
+
+    lanes.erase(lanes.begin() + lanes.find(0));
+    CHECK(lanes.find(0) == -1);
+    CHECK(lanes.find(1) != -1 && lanes.find(-1) != -1);
+}
+
+/**
+ * @brief shifting the outer lanes keeps the order and the links of the shifted lanes
+ *
+ */
+void testShiftLanes()
+{
+    laneSection sec;
+    for (int id = -3; id <= 3; id++)
+    {
+        lane l;
+        l.id = id;
+        l.preId = id;
+        l.sucId = id;
+        sec.lanes.push_back(l);
+    }
+
+    CHECK(shiftLanes(sec, -2, 1) == 0);
+    CHECK(isSorted(sec.lanes));
+    CHECK(sec.lanes.find(-2) == -1);
+    CHECK(sec.lanes.get(-1) != NULL && sec.lanes.get(-1)->preId == -1);
+    CHECK(sec.lanes.get(-3) != NULL && sec.lanes.get(-3)->preId == -3);
+    CHECK(sec.lanes.get(-4) != NULL && sec.lanes.get(-4)->sucId == -4);
+    CHECK(sec.lanes.minId() == -4);
+
+    CHECK(shiftLanes(sec, 2, 1, true, true) == 0);
+    CHECK(isSorted(sec.lanes));
+    CHECK(sec.lanes.maxId() == 4);
+    CHECK(sec.lanes.get(4) != NULL && sec.lanes.get(4)->preId == 3);
+    CHECK(sec.lanes.get(3) != NULL && sec.lanes.get(3)->preId == 2);
+    CHECK(sec.lanes.get(2) == NULL);
+}
+
+int main()
+{
+    setting.suppressOutput = true;
+
+    testInsertAndFind();
+    testDuplicateIds();
+    testFlipAndSort();
+    testShiftLanes();
+
+    return testResult("laneTableTest");
+}
@@ -0,0 +1,93 @@
+/**
+ * Road-Generation
+ * --------------------------------------------------------
+ * Copyright (c) 2021 Institut für Kraftfahrzeuge, RWTH Aachen, ika
+ * Report bugs and download new versions https://github.com/ika-rwth-aachen/RoadGeneration
+ *
+ * This library is distributed under the MIT License.
+ *
+ * @file unitTest.h
+ *
+ * @brief file contains the includes and check macros of the unit tests. Each test is a single program which
+ *      includes the header only sources like export.cpp and returns the number of failed checks.
+ *
+ * @author Jannik Busse, Christian Geller
+ * Contact: jannik.busse@rwth-aachen.de, christian.geller@rwth-aachen.de
+ *
+ */
+
+#pragma once
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <unordered_set>
+#include <iterator>
+#include <cmath>
+#include <ctime>
+#include <random>
+
+std::string::size_type st;
+using namespace std;
+
+#include "utils/settings.h"
+#include "utils/allocTracker.h"
+#include "utils/arena.h"
+#include "utils/idAllocator.h"
+#include "utils/interface.h"
+#include "utils/helper.h"
+#include "utils/rigidTransform.h"
+#include "utils/xml.h"
+#include "utils/laneGraph.h"
+#include "utils/parallel.h"
+#include "generation/buildSegments.h"
+#include "generation/elevationCheck.h"
+#include "generation/junctionCheck.h"
+#include "connection/linkSegments.h"
+#include "connection/closeRoadNetwork.h"
+
+// single letter macros of closeRoadConnection.h
+#undef p
+#undef n
+#undef o
+#undef i
+
+settings setting;
+runArena _arena;
+
+int _failedChecks = 0;
+
+/**
+ * @brief counts a failed check and prints its position
+ *
+ */
+#define CHECK(condition)                                                                   \
+    do                                                                                     \
+    {                                                                                      \
+        if (!(condition))                                                                  \
+        {                                                                                  \
+            _failedChecks++;                                                               \
+            cout << "ERR: " << __FILE__ << ":" << __LINE__ << " check failed: " #condition << endl; \
+        }                                                                                  \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) CHECK(fabs((a) - (b)) <= (tolerance))
+
+/**
+ * @brief prints the result of the test program, the return value is the exit code
+ *
+ * @param name      name of the test
+ * @return int      number of failed checks
+ */
+int testResult(const string &name)
+{
+    if (_failedChecks > 0)
+        cout << name << ": " << _failedChecks << " check(s) failed" << endl;
+    else
+        cout << name << ": passed" << endl;
+    return _failedChecks;
+}